@@ -0,0 +1,61 @@
+#ifndef AST_AST_CONTEXT_H
+#define AST_AST_CONTEXT_H
+
+#include "AST/PType.hpp"
+#include "AST/TypeContext.hpp"
+#include "util/Arena.hpp"
+
+#include <utility>
+
+// Owns everything the AST of one program is made of: the nodes, their child
+// lists, the interned PTypes of the parser and of the semantic analyzer, and
+// the strings they cache. It all goes away at once when the context is
+// released; no node is destroyed on its own.
+//
+// The parser reduces bottom-up, so each node is allocated right after its
+// children and the nodes lie in the arena in the order the passes leave them.
+class AstContext {
+  private:
+    Arena m_arena;
+    TypeContext m_types{m_arena};
+
+  public:
+    AstContext() = default;
+    AstContext(const AstContext &) = delete;
+    AstContext &operator=(const AstContext &) = delete;
+    ~AstContext() = default;
+
+    Arena &getArena() { return m_arena; }
+
+    template <typename T, typename... Args> T *create(Args &&...p_args) {
+        return m_arena.create<T>(std::forward<Args>(p_args)...);
+    }
+
+    // an empty list whose elements will be in the arena too
+    template <typename T> ArenaVector<T> *createVector() {
+        return m_arena.create<ArenaVector<T>>(m_arena);
+    }
+
+    TypeContext &getTypes() { return m_types; }
+
+    const PType *getType(const PType::PrimitiveTypeEnum p_type) {
+        return m_types.getType(p_type);
+    }
+    const PType *getArrayType(const PType::PrimitiveTypeEnum p_type,
+                              const ArenaVector<uint64_t> &p_dims) {
+        return m_types.getArrayType(p_type, p_dims);
+    }
+
+    char *copyString(const char *p_text, const size_t p_length) {
+        return m_arena.copyString(p_text, p_length);
+    }
+
+    size_t getBytesAllocated() const { return m_arena.getBytesAllocated(); }
+
+    void release() {
+        m_types.clear();
+        m_arena.release();
+    }
+};
+
+#endif
@@ -1,11 +1,13 @@
 #ifndef AST_AST_DUMPER_H
 #define AST_AST_DUMPER_H
 
-#include "visitor/AstNodeVisitor.hpp"
+#include "visitor/AstWalker.hpp"
 
 #include <cstdint>
 
-class AstDumper final : public AstNodeVisitor {
+class AstDumper final : public AstWalker<AstDumper> {
+    friend class AstWalker<AstDumper>;
+
   private:
     uint32_t m_indentation_stride = 2;
     uint32_t m_indentation = 0;
@@ -14,25 +16,28 @@ class AstDumper final : public AstNodeVisitor {
     ~AstDumper() = default;
     AstDumper() = default;
 
-    void visit(ProgramNode &p_program) override;
-    void visit(DeclNode &p_decl) override;
-    void visit(VariableNode &p_variable) override;
-    void visit(ConstantValueNode &p_constant_value) override;
-    void visit(FunctionNode &p_function) override;
-    void visit(CompoundStatementNode &p_compound_statement) override;
-    void visit(PrintNode &p_print) override;
-    void visit(BinaryOperatorNode &p_bin_op) override;
-    void visit(UnaryOperatorNode &p_un_op) override;
-    void visit(FunctionInvocationNode &p_func_invocation) override;
-    void visit(VariableReferenceNode &p_variable_ref) override;
-    void visit(AssignmentNode &p_assignment) override;
-    void visit(ReadNode &p_read) override;
-    void visit(IfNode &p_if) override;
-    void visit(WhileNode &p_while) override;
-    void visit(ForNode &p_for) override;
-    void visit(ReturnNode &p_return) override;
-
   private:
+    bool enter(ProgramNode &p_program);
+    bool enter(DeclNode &p_decl);
+    bool enter(VariableNode &p_variable);
+    bool enter(ConstantValueNode &p_constant_value);
+    bool enter(FunctionNode &p_function);
+    bool enter(CompoundStatementNode &p_compound_statement);
+    bool enter(PrintNode &p_print);
+    bool enter(BinaryOperatorNode &p_bin_op);
+    bool enter(UnaryOperatorNode &p_un_op);
+    bool enter(FunctionInvocationNode &p_func_invocation);
+    bool enter(VariableReferenceNode &p_variable_ref);
+    bool enter(AssignmentNode &p_assignment);
+    bool enter(ReadNode &p_read);
+    bool enter(IfNode &p_if);
+    bool enter(WhileNode &p_while);
+    bool enter(ForNode &p_for);
+    bool enter(ReturnNode &p_return);
+    // undoes the indentation of enter(); a constant has no children and
+    // skips it
+    template <typename Node> void leave(Node &) { decrementIndentation(); }
+
     void incrementIndentation();
     void decrementIndentation();
 };
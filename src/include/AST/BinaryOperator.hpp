@@ -5,20 +5,19 @@
 #include "AST/operator.hpp"
 #include "visitor/AstNodeVisitor.hpp"
 
-#include <memory>
-
 class BinaryOperatorNode final : public ExpressionNode {
   private:
     Operator m_op;
-    std::unique_ptr<ExpressionNode> m_left_operand;
-    std::unique_ptr<ExpressionNode> m_right_operand;
+    ExpressionNode *m_left_operand;
+    ExpressionNode *m_right_operand;
 
   public:
     ~BinaryOperatorNode() = default;
-    BinaryOperatorNode(const uint32_t line, const uint32_t col, Operator op,
+    BinaryOperatorNode(const Location p_location, Operator op,
                        ExpressionNode *p_left_operand,
                        ExpressionNode *p_right_operand)
-        : ExpressionNode{line, col}, m_op(op), m_left_operand(p_left_operand),
+        : ExpressionNode{AstNodeKind::kBinaryOperator, p_location}, m_op(op),
+          m_left_operand(p_left_operand),
           m_right_operand(p_right_operand) {}
 
     Operator getOp() const { return m_op; }
@@ -27,8 +26,14 @@ class BinaryOperatorNode final : public ExpressionNode {
         return kOpString[static_cast<size_t>(m_op)];
     }
 
-    const ExpressionNode &getLeftOperand() const { return *m_left_operand.get(); }
-    const ExpressionNode &getRightOperand() const { return *m_right_operand.get(); }
+    const ExpressionNode &getLeftOperand() const { return *m_left_operand; }
+    const ExpressionNode &getRightOperand() const { return *m_right_operand; }
+
+    // calls `p_function` on each child node, in the order they are visited
+    template <typename Function> void forEachChild(Function &&p_function) {
+        p_function(*m_left_operand);
+        p_function(*m_right_operand);
+    }
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
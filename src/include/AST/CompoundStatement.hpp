@@ -3,16 +3,14 @@
 
 #include "AST/ast.hpp"
 #include "AST/decl.hpp"
-
-#include <vector>
-#include <memory>
+#include "util/Arena.hpp"
 
 class SymbolTable;
 
 class CompoundStatementNode final : public AstNode {
   public:
-    using DeclNodes = std::vector<std::unique_ptr<DeclNode>>;
-    using StmtNodes = std::vector<std::unique_ptr<AstNode>>;
+    using DeclNodes = ArenaVector<DeclNode *>;
+    using StmtNodes = ArenaVector<AstNode *>;
 
   private:
     DeclNodes m_decl_nodes;
@@ -22,16 +20,29 @@ class CompoundStatementNode final : public AstNode {
 
   public:
     ~CompoundStatementNode() = default;
-    CompoundStatementNode(const uint32_t line, const uint32_t col,
+    CompoundStatementNode(const Location p_location,
                           DeclNodes &p_decl_nodes, StmtNodes &p_stmt_nodes)
-        : AstNode{line, col}, m_decl_nodes(std::move(p_decl_nodes)),
+        : AstNode{AstNodeKind::kCompoundStatement, p_location},
+          m_decl_nodes(std::move(p_decl_nodes)),
           m_stmt_nodes(std::move(p_stmt_nodes)){}
 
+    const DeclNodes &getDeclNodes() const { return m_decl_nodes; }
+    const StmtNodes &getStmtNodes() const { return m_stmt_nodes; }
+
     const SymbolTable *getSymbolTable() const { return m_symbol_table_ptr; }
     void setSymbolTable(const SymbolTable *p_symbol_table) {
         m_symbol_table_ptr = p_symbol_table;
     }
 
+    // calls `p_function` on each child node, in the order they are visited
+    template <typename Function> void forEachChild(Function &&p_function) {
+        for (auto *const decl : m_decl_nodes) {
+            p_function(*decl);
+        }
+        for (auto *const stmt : m_stmt_nodes) {
+            p_function(*stmt);
+        }
+    }
 
     void accept(AstNodeVisitor &p_visitor) override {
         p_visitor.visit(*this);
@@ -6,28 +6,27 @@
 #include "AST/expression.hpp"
 #include "visitor/AstNodeVisitor.hpp"
 
-#include <memory>
-
 class ConstantValueNode final : public ExpressionNode {
   private:
-    std::unique_ptr<Constant> m_constant_ptr;
+    Constant *m_constant_ptr;
 
   public:
     ~ConstantValueNode() = default;
-    ConstantValueNode(const uint32_t line, const uint32_t col,
+    ConstantValueNode(const Location p_location,
                       Constant *const p_constant)
-        : ExpressionNode{line, col}, m_constant_ptr(p_constant) {}
+        : ExpressionNode{AstNodeKind::kConstantValue, p_location},
+          m_constant_ptr(p_constant) {}
 
     const PType *getTypePtr() const { return m_constant_ptr->getTypePtr(); }
-    const PTypeSharedPtr &getTypeSharedPtr() const {
-        return m_constant_ptr->getTypeSharedPtr();
-    }
 
     const char *getConstantValueCString() const {
         return m_constant_ptr->getConstantValueCString();
     }
 
-    const Constant *getConstantPtr() const { return m_constant_ptr.get(); }
+    const Constant *getConstantPtr() const { return m_constant_ptr; }
+
+    // calls `p_function` on each child node, in the order they are visited
+    template <typename Function> void forEachChild(Function &&p_function) {}
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
 };
@@ -0,0 +1,120 @@
+#ifndef AST_FLAT_AST_H
+#define AST_FLAT_AST_H
+
+#include "AST/ast.hpp"
+#include "AST/operator.hpp"
+#include "util/InternedString.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class AstNodeVisitor;
+class PType;
+class ProgramNode;
+
+// The AST of a program laid out as parallel arrays, one entry per node in
+// pre-order, addressed by 32-bit indices. A node's subtree is the range from
+// its index to its subtree end, so a pass that only needs kinds, operators,
+// names or types walks it as a linear scan instead of chasing pointers
+// through virtual calls.
+//
+// It is a view of the pointer-based AST, which stays the owner of the nodes:
+// every entry keeps its node, and accept() hands that node to a visitor, so
+// a pass can move to the arrays one query at a time.
+//
+// A variable declared together with others has the shared initializer of the
+// declaration as its operand, so that node appears once per variable.
+class FlatAst {
+  public:
+    using Index = uint32_t;
+    using TypeId = uint32_t;
+
+    static constexpr Index kNoNode = UINT32_MAX;
+    // nodes that have no type, and expressions sema couldn't type
+    static constexpr TypeId kNoType = 0;
+
+    using Kind = AstNodeKind;
+
+  private:
+    class Builder;
+
+    std::vector<Kind> m_kinds;
+    std::vector<Location> m_locations;
+    std::vector<TypeId> m_types;
+    // the Operator of an operator node, the InternedString id of a named one
+    std::vector<uint32_t> m_payloads;
+    std::vector<Index> m_parents;
+    std::vector<Index> m_subtree_ends;
+    // the operands of node i are m_operands[m_operand_begins[i]] up to
+    // m_operands[m_operand_begins[i + 1]], in the order they are visited
+    std::vector<Index> m_operand_begins;
+    std::vector<Index> m_operands;
+
+    // the distinct types; entry 0 is kNoType
+    std::vector<const PType *> m_type_table;
+
+    std::vector<AstNode *> m_nodes;
+    std::unordered_map<const AstNode *, Index> m_node_indices;
+
+  public:
+    ~FlatAst() = default;
+    FlatAst() = default;
+    FlatAst(const FlatAst &) = delete;
+    FlatAst &operator=(const FlatAst &) = delete;
+
+    // Replaces the contents with the AST rooted at `p_program`. Expressions
+    // get the types sema inferred, so it is built after the analysis.
+    void build(ProgramNode &p_program);
+    void clear();
+
+    size_t size() const { return m_kinds.size(); }
+    bool empty() const { return m_kinds.empty(); }
+
+    Kind getKind(const Index p_node) const { return m_kinds[p_node]; }
+    Location getLocation(const Index p_node) const {
+        return m_locations[p_node];
+    }
+
+    TypeId getTypeId(const Index p_node) const { return m_types[p_node]; }
+    // nullptr for kNoType
+    const PType *getType(const TypeId p_type) const {
+        return m_type_table[p_type];
+    }
+    size_t getNumTypes() const { return m_type_table.size(); }
+
+    // only for operator nodes
+    Operator getOperator(const Index p_node) const {
+        return static_cast<Operator>(m_payloads[p_node]);
+    }
+    // empty for the nodes that have no name
+    InternedString getName(const Index p_node) const;
+
+    // kNoNode for the program
+    Index getParent(const Index p_node) const { return m_parents[p_node]; }
+    // one past the last node of the subtree of `p_node`
+    Index getSubtreeEnd(const Index p_node) const {
+        return m_subtree_ends[p_node];
+    }
+
+    Index getNumOperands(const Index p_node) const {
+        return m_operand_begins[p_node + 1] - m_operand_begins[p_node];
+    }
+    Index getOperand(const Index p_node, const Index p_nth) const {
+        return m_operands[m_operand_begins[p_node] + p_nth];
+    }
+
+    // kNoNode if `p_node` isn't part of the flattened program
+    Index indexOf(const AstNode &p_node) const;
+    AstNode &getNode(const Index p_node) const { return *m_nodes[p_node]; }
+
+    // runs `p_visitor` on the node itself, for passes not yet moved over
+    void accept(const Index p_node, AstNodeVisitor &p_visitor) const;
+
+  private:
+    Index append(AstNode &p_node, const TypeId p_type, const uint32_t p_payload,
+                 const Index p_parent);
+};
+
+#endif
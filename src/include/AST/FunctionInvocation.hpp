@@ -3,30 +3,36 @@
 
 #include "AST/expression.hpp"
 #include "visitor/AstNodeVisitor.hpp"
-
-#include <memory>
-#include <string>
-#include <vector>
+#include "util/InternedString.hpp"
+#include "util/Arena.hpp"
 
 class FunctionInvocationNode final : public ExpressionNode {
   public:
-    using ExprNodes = std::vector<std::unique_ptr<ExpressionNode>>;
+    using ExprNodes = ArenaVector<ExpressionNode *>;
 
   private:
-    std::string m_name;
+    InternedString m_name;
     ExprNodes m_args;
 
   public:
     ~FunctionInvocationNode() = default;
-    FunctionInvocationNode(const uint32_t line, const uint32_t col,
-                           const char *const p_name, ExprNodes &p_args)
-        : ExpressionNode{line, col}, m_name(p_name), m_args(std::move(p_args)){}
+    FunctionInvocationNode(const Location p_location,
+                           const InternedString p_name, ExprNodes &p_args)
+        : ExpressionNode{AstNodeKind::kFunctionInvocation, p_location},
+          m_name(p_name), m_args(std::move(p_args)){}
 
-    const std::string &getName() const { return m_name; }
+    InternedString getName() const { return m_name; }
     const char *getNameCString() const { return m_name.c_str(); }
 
     const ExprNodes &getArguments() const { return m_args; }
 
+    // calls `p_function` on each child node, in the order they are visited
+    template <typename Function> void forEachChild(Function &&p_function) {
+        for (auto *const arg : m_args) {
+            p_function(*arg);
+        }
+    }
+
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
 };
@@ -1,14 +1,14 @@
 #ifndef AST_P_TYPE_H
 #define AST_P_TYPE_H
 
-#include <memory>
-#include <string>
-#include <vector>
+#include "util/Arena.hpp"
 
-class PType;
-
-using PTypeSharedPtr = std::shared_ptr<PType>;
+#include <cstdint>
 
+// Immutable, and interned by the TypeContext of an AstContext: there is one
+// PType per primitive type and dimensions, living in its arena together with
+// its dimensions and its type string. Two types are identical exactly when
+// they are the same object.
 class PType {
   public:
     enum class PrimitiveTypeEnum : uint8_t {
@@ -21,24 +21,22 @@ class PType {
 
   private:
     PrimitiveTypeEnum m_type;
-    std::vector<uint64_t> m_dimensions;
-    mutable std::string m_type_string;
-    mutable bool m_type_string_is_valid = false;
+    ArenaVector<uint64_t> m_dimensions;
+    ArenaString m_type_string;
 
   public:
     ~PType() = default;
-    PType(const PrimitiveTypeEnum type) : m_type(type) {}
+    // only TypeContext creates them
+    PType(Arena &p_arena, const PrimitiveTypeEnum type,
+          const uint64_t *p_dims_begin, const uint64_t *p_dims_end);
 
-    void setDimensions(std::vector<uint64_t> &p_dims) {
-        m_dimensions = std::move(p_dims);
-    }
+    PType(const PType &) = delete;
+    PType &operator=(const PType &) = delete;
 
     PrimitiveTypeEnum getPrimitiveType() const { return m_type; }
-    const char *getPTypeCString() const;
-
-    const std::vector<uint64_t> &getDimensions() const { return m_dimensions; }
+    const char *getPTypeCString() const { return m_type_string.c_str(); }
 
-    PType *getStructElementType(const std::size_t nth) const;
+    const ArenaVector<uint64_t> &getDimensions() const { return m_dimensions; }
 
     bool isPrimitiveInteger() const {
         return m_type == PrimitiveTypeEnum::kIntegerType;
@@ -69,6 +67,8 @@ class PType {
         return m_dimensions.empty() && m_type != PrimitiveTypeEnum::kVoidType;
     }
 
+    // Whether a value of `p_type` may be used where this type is expected.
+    // Identical types are, and so is integer for real and vice versa.
     bool compare(const PType *p_type) const;
 };
 
@@ -0,0 +1,70 @@
+#ifndef AST_TYPE_CONTEXT_H
+#define AST_TYPE_CONTEXT_H
+
+#include "AST/PType.hpp"
+#include "util/Arena.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+
+// Hands out the one PType of each primitive type and dimensions, creating it
+// in the arena the first time it is asked for. Asking again for a type, e.g.
+// for the type of every integer expression, costs a lookup and no memory.
+class TypeContext {
+  private:
+    static constexpr size_t kNumPrimitiveTypes = 5;
+
+    // what a type is looked up by; the dimensions of an interned type point
+    // into the type itself
+    struct Key {
+        PType::PrimitiveTypeEnum primitive;
+        const uint64_t *dims_begin;
+        const uint64_t *dims_end;
+        const PType *type;
+    };
+    struct KeyHash {
+        size_t operator()(const Key &p_key) const;
+    };
+    struct KeyEqual {
+        bool operator()(const Key &p_a, const Key &p_b) const;
+    };
+
+    Arena &m_arena;
+    const PType *m_scalar_types[kNumPrimitiveTypes] = {};
+    std::unordered_set<Key, KeyHash, KeyEqual> m_array_types;
+
+  public:
+    ~TypeContext() = default;
+    explicit TypeContext(Arena &p_arena) : m_arena(p_arena) {}
+    TypeContext(const TypeContext &) = delete;
+    TypeContext &operator=(const TypeContext &) = delete;
+
+    const PType *getType(const PType::PrimitiveTypeEnum p_primitive) {
+        const auto index = static_cast<size_t>(p_primitive);
+        if (!m_scalar_types[index]) {
+            m_scalar_types[index] =
+                m_arena.create<PType>(m_arena, p_primitive, nullptr, nullptr);
+        }
+        return m_scalar_types[index];
+    }
+
+    // the scalar type if there are no dimensions
+    const PType *getArrayType(const PType::PrimitiveTypeEnum p_primitive,
+                              const uint64_t *p_dims_begin,
+                              const uint64_t *p_dims_end);
+    const PType *getArrayType(const PType::PrimitiveTypeEnum p_primitive,
+                              const ArenaVector<uint64_t> &p_dims) {
+        return getArrayType(p_primitive, p_dims.data(),
+                            p_dims.data() + p_dims.size());
+    }
+
+    // the type of `p_type` indexed with `p_num_indices` subscripts, nullptr
+    // if it has fewer dimensions
+    const PType *getElementType(const PType *p_type, const size_t p_num_indices);
+
+    // forgets every type; the arena is about to be released
+    void clear();
+};
+
+#endif
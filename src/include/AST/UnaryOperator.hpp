@@ -5,18 +5,17 @@
 #include "AST/operator.hpp"
 #include "visitor/AstNodeVisitor.hpp"
 
-#include <memory>
-
 class UnaryOperatorNode final : public ExpressionNode {
   private:
     Operator m_op;
-    std::unique_ptr<ExpressionNode> m_operand;
+    ExpressionNode *m_operand;
 
   public:
     ~UnaryOperatorNode() = default;
-    UnaryOperatorNode(const uint32_t line, const uint32_t col, Operator op,
+    UnaryOperatorNode(const Location p_location, Operator op,
                       ExpressionNode *p_operand)
-        : ExpressionNode{line, col}, m_op(op), m_operand(p_operand) {}
+        : ExpressionNode{AstNodeKind::kUnaryOperator, p_location},
+          m_op(op), m_operand(p_operand) {}
 
     Operator getOp() const { return m_op; }
 
@@ -24,7 +23,12 @@ class UnaryOperatorNode final : public ExpressionNode {
         return kOpString[static_cast<size_t>(m_op)];
     }
 
-    const ExpressionNode &getOperand() const { return *m_operand.get(); }
+    const ExpressionNode &getOperand() const { return *m_operand; }
+
+    // calls `p_function` on each child node, in the order they are visited
+    template <typename Function> void forEachChild(Function &&p_function) {
+        p_function(*m_operand);
+    }
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
@@ -3,38 +3,44 @@
 
 #include "AST/expression.hpp"
 #include "visitor/AstNodeVisitor.hpp"
-
-#include <memory>
-#include <string>
-#include <vector>
+#include "util/InternedString.hpp"
+#include "util/Arena.hpp"
 
 class VariableReferenceNode final : public ExpressionNode {
   public:
-    using ExprNodes = std::vector<std::unique_ptr<ExpressionNode>>;
+    using ExprNodes = ArenaVector<ExpressionNode *>;
 
   private:
-    std::string m_name;
+    InternedString m_name;
     ExprNodes m_indices;
 
   public:
     ~VariableReferenceNode() = default;
 
     // normal reference
-    VariableReferenceNode(const uint32_t line, const uint32_t col,
-                          const char *const p_name)
-        : ExpressionNode{line, col}, m_name(p_name){}
+    VariableReferenceNode(Arena &p_arena, const Location p_location,
+                          const InternedString p_name)
+        : ExpressionNode{AstNodeKind::kVariableReference, p_location},
+          m_name(p_name), m_indices(p_arena){}
 
     // array reference
-    VariableReferenceNode(const uint32_t line, const uint32_t col,
-                          const char *const p_name, ExprNodes &p_indices)
-        : ExpressionNode{line, col}, m_name(p_name),
-          m_indices(std::move(p_indices)){}
+    VariableReferenceNode(const Location p_location,
+                          const InternedString p_name, ExprNodes &p_indices)
+        : ExpressionNode{AstNodeKind::kVariableReference, p_location},
+          m_name(p_name), m_indices(std::move(p_indices)){}
 
-    const std::string &getName() const { return m_name; }
+    InternedString getName() const { return m_name; }
     const char *getNameCString() const { return m_name.c_str(); }
 
     const ExprNodes &getIndices() const { return m_indices; }
 
+    // calls `p_function` on each child node, in the order they are visited
+    template <typename Function> void forEachChild(Function &&p_function) {
+        for (auto *const index : m_indices) {
+            p_function(*index);
+        }
+    }
+
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
 };
@@ -5,21 +5,26 @@
 #include "AST/expression.hpp"
 #include "AST/VariableReference.hpp"
 
-#include <memory>
-
 class AssignmentNode final : public AstNode {
   private:
-    std::unique_ptr<VariableReferenceNode> m_lvalue;
-    std::unique_ptr<ExpressionNode> m_expr;
+    VariableReferenceNode *m_lvalue;
+    ExpressionNode *m_expr;
 
   public:
     ~AssignmentNode() = default;
-    AssignmentNode(const uint32_t line, const uint32_t col,
+    AssignmentNode(const Location p_location,
                    VariableReferenceNode *p_var_ref, ExpressionNode *p_expr)
-        : AstNode{line, col}, m_lvalue(p_var_ref), m_expr(p_expr){}
+        : AstNode{AstNodeKind::kAssignment, p_location},
+          m_lvalue(p_var_ref), m_expr(p_expr){}
+
+    const VariableReferenceNode &getLvalue() const { return *m_lvalue; }
+    const ExpressionNode &getExpr() const { return *m_expr; }
 
-    const VariableReferenceNode &getLvalue() const { return *m_lvalue.get(); }
-    const ExpressionNode &getExpr() const { return *m_expr.get(); }
+    // calls `p_function` on each child node, in the order they are visited
+    template <typename Function> void forEachChild(Function &&p_function) {
+        p_function(*m_lvalue);
+        p_function(*m_expr);
+    }
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
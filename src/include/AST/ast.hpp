@@ -1,32 +1,51 @@
 #ifndef AST_AST_NODE_H
 #define AST_AST_NODE_H
 
+#include "util/SourceLocation.hpp"
+
 #include <cstdint>
 
 class AstNodeVisitor;
 
-struct Location {
-    uint32_t line;
-    uint32_t col;
-
-    ~Location() = default;
-    Location(const uint32_t line, const uint32_t col) : line(line), col(col) {}
+// Which final class a node is, so a pass can switch on it instead of paying
+// a virtual call per node (see StaticAstVisitor).
+enum class AstNodeKind : uint8_t {
+    kProgram,
+    kDecl,
+    kVariable,
+    kConstantValue,
+    kFunction,
+    kCompoundStatement,
+    kPrint,
+    kBinaryOperator,
+    kUnaryOperator,
+    kFunctionInvocation,
+    kVariableReference,
+    kAssignment,
+    kRead,
+    kIf,
+    kWhile,
+    kFor,
+    kReturn
 };
 
 class AstNode {
   protected:
     Location location;
+    // fits in the padding after the location
+    const AstNodeKind m_kind;
 
   public:
     virtual ~AstNode() = 0;
-    AstNode(const uint32_t line, const uint32_t col);
+    AstNode(const AstNodeKind p_kind, const Location p_location);
 
     AstNode(const AstNode &) = delete;
     AstNode(AstNode &&) = delete;
     AstNode &operator=(const AstNode &) = delete;
     AstNode &operator=(AstNode &&) = delete;
 
-    const Location &getLocation() const;
+    Location getLocation() const;
+    AstNodeKind getKind() const { return m_kind; }
 
     virtual void accept(AstNodeVisitor &p_visitor) = 0;
     virtual void visitChildNodes(AstNodeVisitor &p_visitor){};
@@ -5,42 +5,47 @@
 #include "AST/utils.hpp"
 #include "AST/variable.hpp"
 #include "visitor/AstNodeVisitor.hpp"
-
-#include <memory>
-#include <vector>
+#include "util/Arena.hpp"
 
 class DeclNode final : public AstNode {
   public:
-    using VarNodes = std::vector<std::unique_ptr<VariableNode>>;
+    using VarNodes = ArenaVector<VariableNode *>;
 
   private:
     VarNodes m_var_nodes;
 
   private:
-    void init(const std::vector<IdInfo> *const p_ids,
-              const PTypeSharedPtr &p_type,
+    void init(Arena &p_arena, const ArenaVector<IdInfo> *const p_ids,
+              const PType *const p_type,
               ConstantValueNode *const p_constant);
 
   public:
     ~DeclNode() = default;
 
     // variable declaration
-    DeclNode(const uint32_t line, const uint32_t col,
-             const std::vector<IdInfo> *const p_ids, PType *p_type)
-        : AstNode{line, col} {
-        init(p_ids, PTypeSharedPtr{p_type}, nullptr);
+    DeclNode(Arena &p_arena, const Location p_location,
+             const ArenaVector<IdInfo> *const p_ids, const PType *p_type)
+        : AstNode{AstNodeKind::kDecl, p_location}, m_var_nodes(p_arena) {
+        init(p_arena, p_ids, p_type, nullptr);
     }
 
     // constant variable declaration
-    DeclNode(const uint32_t line, const uint32_t col,
-             const std::vector<IdInfo> *const p_ids,
+    DeclNode(Arena &p_arena, const Location p_location,
+             const ArenaVector<IdInfo> *const p_ids,
              ConstantValueNode *const p_constant)
-        : AstNode{line, col} {
-        init(p_ids, p_constant->getTypeSharedPtr(), p_constant);
+        : AstNode{AstNodeKind::kDecl, p_location}, m_var_nodes(p_arena) {
+        init(p_arena, p_ids, p_constant->getTypePtr(), p_constant);
     }
 
     const VarNodes &getVariables() { return m_var_nodes; }
 
+    // calls `p_function` on each child node, in the order they are visited
+    template <typename Function> void forEachChild(Function &&p_function) {
+        for (auto *const var_node : m_var_nodes) {
+            p_function(*var_node);
+        }
+    }
+
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
 };
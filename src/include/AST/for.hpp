@@ -12,24 +12,29 @@ class SymbolTable;
 class ForNode final : public AstNode
 {
 private:
-  std::unique_ptr<DeclNode> m_loop_var_decl;
-  std::unique_ptr<AssignmentNode> m_init_stmt;
-  std::unique_ptr<ExpressionNode> m_end_condition;
-  std::unique_ptr<CompoundStatementNode> m_body;
+  DeclNode *m_loop_var_decl;
+  AssignmentNode *m_init_stmt;
+  ExpressionNode *m_end_condition;
+  CompoundStatementNode *m_body;
 
   const SymbolTable *m_symbol_table_ptr = nullptr;
 
 public:
   ~ForNode() = default;
-  ForNode(const uint32_t line, const uint32_t col,
+  ForNode(const Location p_location,
           DeclNode *p_loop_var_decl, AssignmentNode *p_init_stmt,
           ExpressionNode *p_end_condition, CompoundStatementNode *p_body)
-      : AstNode{line, col}, m_loop_var_decl(p_loop_var_decl),
+      : AstNode{AstNodeKind::kFor, p_location},
+        m_loop_var_decl(p_loop_var_decl),
         m_init_stmt(p_init_stmt), m_end_condition(p_end_condition),
         m_body(p_body) {}
 
+  const DeclNode &getLoopVarDecl() const { return *m_loop_var_decl; }
+  const AssignmentNode &getInitStatement() const { return *m_init_stmt; }
+  const ExpressionNode &getEndCondition() const { return *m_end_condition; }
   const ConstantValueNode &getLowerBound() const;
   const ConstantValueNode &getUpperBound() const;
+  const CompoundStatementNode &getBody() const { return *m_body; }
 
   const SymbolTable *getSymbolTable() const { return m_symbol_table_ptr; }
   void setSymbolTable(const SymbolTable *p_symbol_table)
@@ -37,7 +42,16 @@ public:
     m_symbol_table_ptr = p_symbol_table;
   }
 
-  std::string getLoopVarName() const;
+  InternedString getLoopVarName() const;
+
+  // calls `p_function` on each child node, in the order they are visited
+  template <typename Function> void forEachChild(Function &&p_function)
+  {
+    p_function(*m_loop_var_decl);
+    p_function(*m_init_stmt);
+    p_function(*m_end_condition);
+    p_function(*m_body);
+  }
 
   void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
   void visitChildNodes(AstNodeVisitor &p_visitor) override;
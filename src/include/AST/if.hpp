@@ -5,24 +5,25 @@
 #include "AST/expression.hpp"
 #include "AST/CompoundStatement.hpp"
 
-#include <memory>
-
 class IfNode final : public AstNode
 {
 private:
-  std::unique_ptr<ExpressionNode> m_condition;
-  std::unique_ptr<CompoundStatementNode> m_body;
-  std::unique_ptr<CompoundStatementNode> m_else_body;
+  ExpressionNode *m_condition;
+  CompoundStatementNode *m_body;
+  CompoundStatementNode *m_else_body;
 
 public:
   ~IfNode() = default;
-  IfNode(const uint32_t line, const uint32_t col,
+  IfNode(const Location p_location,
          ExpressionNode *p_condition, CompoundStatementNode *p_body,
          CompoundStatementNode *p_else_body)
-      : AstNode{line, col}, m_condition(p_condition), m_body(p_body),
+      : AstNode{AstNodeKind::kIf, p_location},
+        m_condition(p_condition), m_body(p_body),
         m_else_body(p_else_body) {}
 
-  const ExpressionNode &getCondition() const { return *m_condition.get(); }
+  const ExpressionNode &getCondition() const { return *m_condition; }
+  const CompoundStatementNode &getBody() const { return *m_body; }
+  const CompoundStatementNode *getElseBody() const { return m_else_body; }
 
   bool hasElse() const
   {
@@ -32,6 +33,17 @@ public:
       return false;
   }
 
+  // calls `p_function` on each child node, in the order they are visited
+  template <typename Function> void forEachChild(Function &&p_function)
+  {
+    p_function(*m_condition);
+    p_function(*m_body);
+    if (m_else_body)
+    {
+      p_function(*m_else_body);
+    }
+  }
+
   void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
   void visitChildNodes(AstNodeVisitor &p_visitor) override;
 
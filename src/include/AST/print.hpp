@@ -5,19 +5,22 @@
 #include "AST/expression.hpp"
 #include "visitor/AstNodeVisitor.hpp"
 
-#include <memory>
-
 class PrintNode final : public AstNode {
   private:
-    std::unique_ptr<ExpressionNode> m_target;
+    ExpressionNode *m_target;
 
   public:
     ~PrintNode() = default;
-    PrintNode(const uint32_t line, const uint32_t col,
+    PrintNode(const Location p_location,
               ExpressionNode *p_target)
-        : AstNode{line, col}, m_target(p_target){}
+        : AstNode{AstNodeKind::kPrint, p_location}, m_target(p_target){}
+
+    const ExpressionNode &getTarget() const { return *m_target; }
 
-    const ExpressionNode &getTarget() const { return *m_target.get(); }
+    // calls `p_function` on each child node, in the order they are visited
+    template <typename Function> void forEachChild(Function &&p_function) {
+        p_function(*m_target);
+    }
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
@@ -4,51 +4,61 @@
 #include "AST/ast.hpp"
 #include "AST/decl.hpp"
 #include "AST/function.hpp"
-
-#include <memory>
-#include <string>
-#include <vector>
+#include "util/InternedString.hpp"
+#include "util/Arena.hpp"
 
 class SymbolTable;
 
 class ProgramNode final : public AstNode {
   public:
-    using DeclNodes = std::vector<std::unique_ptr<DeclNode>>;
-    using FuncNodes = std::vector<std::unique_ptr<FunctionNode>>;
+    using DeclNodes = ArenaVector<DeclNode *>;
+    using FuncNodes = ArenaVector<FunctionNode *>;
 
   private:
-    std::string m_name;
-    std::unique_ptr<PType> m_ret_type;
+    InternedString m_name;
+    const PType *m_ret_type;
     DeclNodes m_decl_nodes;
     FuncNodes m_func_nodes;
-    std::unique_ptr<CompoundStatementNode> m_body;
+    CompoundStatementNode *m_body;
 
     const SymbolTable *m_symbol_table_ptr = nullptr;
 
   public:
     ~ProgramNode() = default;
-    ProgramNode(const uint32_t line, const uint32_t col,
-                const char *const p_name, PType *const p_ret_type,
+    ProgramNode(const Location p_location,
+                const InternedString p_name, const PType *const p_ret_type,
                 DeclNodes &p_decl_nodes, FuncNodes &p_func_nodes,
                 CompoundStatementNode *const p_body)
-        : AstNode{line, col}, m_name(p_name), m_ret_type(p_ret_type),
+        : AstNode{AstNodeKind::kProgram, p_location},
+          m_name(p_name), m_ret_type(p_ret_type),
           m_decl_nodes(std::move(p_decl_nodes)),
           m_func_nodes(std::move(p_func_nodes)), m_body(p_body) {}
 
     const char *getNameCString() const { return m_name.c_str(); }
-    const std::string &getName() const { return m_name; }
+    InternedString getName() const { return m_name; }
 
-    const PType *getTypePtr() const { return m_ret_type.get(); }
+    const PType *getTypePtr() const { return m_ret_type; }
 
     const DeclNodes &getDeclNodes() const { return m_decl_nodes; }
     const FuncNodes &getFuncNodes() const { return m_func_nodes; }
-    const CompoundStatementNode &getBody() const { return *m_body.get(); }
+    const CompoundStatementNode &getBody() const { return *m_body; }
 
     const SymbolTable *getSymbolTable() const { return m_symbol_table_ptr; }
     void setSymbolTable(const SymbolTable *p_symbol_table) {
         m_symbol_table_ptr = p_symbol_table;
     }
 
+    // calls `p_function` on each child node, in the order they are visited
+    template <typename Function> void forEachChild(Function &&p_function) {
+        for (auto *const decl : m_decl_nodes) {
+            p_function(*decl);
+        }
+        for (auto *const func : m_func_nodes) {
+            p_function(*func);
+        }
+        p_function(*m_body);
+    }
+
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
 
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
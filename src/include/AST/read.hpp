@@ -4,19 +4,22 @@
 #include "AST/ast.hpp"
 #include "AST/VariableReference.hpp"
 
-#include <memory>
-
 class ReadNode final : public AstNode {
   private:
-    std::unique_ptr<VariableReferenceNode> m_target;
+    VariableReferenceNode *m_target;
 
   public:
     ~ReadNode() = default;
-    ReadNode(const uint32_t line, const uint32_t col,
+    ReadNode(const Location p_location,
              VariableReferenceNode *p_target)
-        : AstNode{line, col}, m_target(p_target){}
+        : AstNode{AstNodeKind::kRead, p_location}, m_target(p_target){}
+
+    const VariableReferenceNode &getTarget() const { return *m_target; }
 
-    const VariableReferenceNode &getTarget() const { return *m_target.get(); }
+    // calls `p_function` on each child node, in the order they are visited
+    template <typename Function> void forEachChild(Function &&p_function) {
+        p_function(*m_target);
+    }
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
@@ -5,19 +5,22 @@
 #include "AST/expression.hpp"
 #include "visitor/AstNodeVisitor.hpp"
 
-#include <memory>
-
 class ReturnNode final : public AstNode {
   private:
-    std::unique_ptr<ExpressionNode> m_ret_val;
+    ExpressionNode *m_ret_val;
 
   public:
     ~ReturnNode() = default;
-    ReturnNode(const uint32_t line, const uint32_t col,
+    ReturnNode(const Location p_location,
                ExpressionNode *p_ret_val)
-        : AstNode{line, col}, m_ret_val(p_ret_val){}
+        : AstNode{AstNodeKind::kReturn, p_location}, m_ret_val(p_ret_val){}
+
+    const ExpressionNode &getReturnValue() const { return *m_ret_val; }
 
-    const ExpressionNode &getReturnValue() const { return *m_ret_val.get(); }
+    // calls `p_function` on each child node, in the order they are visited
+    template <typename Function> void forEachChild(Function &&p_function) {
+        p_function(*m_ret_val);
+    }
 
     void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
     void visitChildNodes(AstNodeVisitor &p_visitor) override;
@@ -5,29 +5,29 @@
 #include "AST/ast.hpp"
 #include "AST/ConstantValue.hpp"
 #include "visitor/AstNodeVisitor.hpp"
-
-#include <memory>
-#include <string>
+#include "util/InternedString.hpp"
 
 class VariableNode final : public AstNode {
   private:
-    std::string m_name;
-    PTypeSharedPtr m_type;
-    std::shared_ptr<ConstantValueNode> m_constant_value_node_ptr;
+    InternedString m_name;
+    // shared with the other variables of the declaration
+    const PType *m_type;
+    ConstantValueNode *m_constant_value_node_ptr;
 
   public:
     ~VariableNode() = default;
-    VariableNode(const uint32_t line, const uint32_t col,
-                 const std::string &p_name, const PTypeSharedPtr &p_type,
-                 const std::shared_ptr<ConstantValueNode> &p_constant_value_node)
-        : AstNode{line, col}, m_name(p_name), m_type(p_type),
+    VariableNode(const Location p_location,
+                 const InternedString p_name, const PType *const p_type,
+                 ConstantValueNode *const p_constant_value_node)
+        : AstNode{AstNodeKind::kVariable, p_location},
+          m_name(p_name), m_type(p_type),
           m_constant_value_node_ptr(p_constant_value_node) {}
 
-    const std::string &getName() const { return m_name; }
+    InternedString getName() const { return m_name; }
     const char *getNameCString() const { return m_name.c_str(); }
     const char *getTypeCString() const { return m_type->getPTypeCString(); }
 
-    const PType *getTypePtr() const { return m_type.get(); }
+    const PType *getTypePtr() const { return m_type; }
 
     const Constant *getConstantPtr() const {
         if (!m_constant_value_node_ptr) {
@@ -36,6 +36,13 @@ class VariableNode final : public AstNode {
         return m_constant_value_node_ptr->getConstantPtr();
     }
 
+    // calls `p_function` on each child node, in the order they are visited
+    template <typename Function> void forEachChild(Function &&p_function) {
+        if (m_constant_value_node_ptr) {
+            p_function(*m_constant_value_node_ptr);
+        }
+    }
+
     void accept(AstNodeVisitor &p_visitor) override {
         p_visitor.visit(*this);
     }
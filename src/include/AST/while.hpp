@@ -5,21 +5,28 @@
 #include "AST/expression.hpp"
 #include "AST/CompoundStatement.hpp"
 
-#include <memory>
-
 class WhileNode final : public AstNode
 {
 private:
-  std::unique_ptr<ExpressionNode> m_condition;
-  std::unique_ptr<CompoundStatementNode> m_body;
+  ExpressionNode *m_condition;
+  CompoundStatementNode *m_body;
 
 public:
   ~WhileNode() = default;
-  WhileNode(const uint32_t line, const uint32_t col,
+  WhileNode(const Location p_location,
             ExpressionNode *p_condition, CompoundStatementNode *p_body)
-      : AstNode{line, col}, m_condition(p_condition), m_body(p_body) {}
-
-  const ExpressionNode &getCondition() const { return *m_condition.get(); }
+      : AstNode{AstNodeKind::kWhile, p_location},
+        m_condition(p_condition), m_body(p_body) {}
+
+  const ExpressionNode &getCondition() const { return *m_condition; }
+  const CompoundStatementNode &getBody() const { return *m_body; }
+
+  // calls `p_function` on each child node, in the order they are visited
+  template <typename Function> void forEachChild(Function &&p_function)
+  {
+    p_function(*m_condition);
+    p_function(*m_body);
+  }
 
   void accept(AstNodeVisitor &p_visitor) override { p_visitor.visit(*this); }
   void visitChildNodes(AstNodeVisitor &p_visitor) override;
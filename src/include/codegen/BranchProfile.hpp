@@ -0,0 +1,70 @@
+#ifndef CODEGEN_BRANCH_PROFILE_H
+#define CODEGEN_BRANCH_PROFILE_H
+
+#include "visitor/AstWalker.hpp"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Edge counts of the conditional branches, as written by the runtime of a
+// program compiled with -fprofile-generate. Branch sites are numbered by
+// BranchSiteNumbering, so a profile applies to any build of the source it was
+// collected from, whatever the code generation flags of either build.
+//
+// The file has a `pprof <number of sites>` header, followed by one
+// `<executions> <taken>` line per site, where `taken` counts the times the
+// condition held, i.e. the then-arm or the loop body was entered.
+class BranchProfile
+{
+public:
+  struct Site
+  {
+    uint32_t executed;
+    uint32_t taken;
+
+    uint32_t notTaken() const { return executed - taken; }
+  };
+
+private:
+  std::vector<Site> m_sites;
+  bool m_loaded = false;
+
+public:
+  // returns false if the file can't be read or is malformed
+  bool load(const std::string &p_path);
+
+  bool isLoaded() const { return m_loaded; }
+  uint32_t getNumSites() const { return m_sites.size(); }
+  // returns nullptr for sites beyond the profile
+  const Site *getSite(const uint32_t p_site) const;
+};
+
+// Numbers the if/while/for statements of a program in source order. It runs
+// before anything is folded or cloned: a clone shares the sites of the
+// function it copies, and a statement whose condition is folded keeps its
+// number.
+class BranchSiteNumbering final : public AstWalker<BranchSiteNumbering>
+{
+  friend class AstWalker<BranchSiteNumbering>;
+
+private:
+  std::map<const AstNode *, uint32_t> m_sites;
+
+public:
+  ~BranchSiteNumbering() = default;
+  BranchSiteNumbering() = default;
+
+  uint32_t getNumSites() const { return m_sites.size(); }
+  uint32_t getSite(const AstNode &p_statement) const;
+
+private:
+  using AstWalker<BranchSiteNumbering>::enter;
+
+  bool enter(IfNode &p_if);
+  bool enter(WhileNode &p_while);
+  bool enter(ForNode &p_for);
+};
+
+#endif
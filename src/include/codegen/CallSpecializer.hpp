@@ -0,0 +1,124 @@
+#ifndef CODEGEN_CALL_SPECIALIZER_H
+#define CODEGEN_CALL_SPECIALIZER_H
+
+#include "util/InternedString.hpp"
+#include "visitor/AstWalker.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class SymbolEntry;
+class SymbolManager;
+
+// A copy of `function` lowered with some of its parameters bound to the
+// constants its call sites pass. The bound arguments aren't passed at all:
+// the clone takes the remaining ones in their original order.
+struct Specialization
+{
+  FunctionNode *function;
+  std::string name;
+  std::vector<bool> bound;
+  std::vector<int32_t> values;
+
+  uint32_t getNumParams() const;
+  // argument register of the unbound parameter `p_param`
+  uint32_t getArgumentIndex(const uint32_t p_param) const;
+};
+
+// Call-site specialization: finds the calls that pass literals to
+// parameters the callee branches on and never assigns, and picks the clones
+// worth lowering. Calls that bind the same parameters to the same values
+// share one clone. Clones are taken from the calls nested in the most loops
+// first, until the AST nodes they copy exceed the growth budget.
+class CallSpecializer final : public AstWalker<CallSpecializer>
+{
+  friend class AstWalker<CallSpecializer>;
+
+public:
+  using Specializations = std::vector<std::unique_ptr<Specialization>>;
+
+private:
+  struct FunctionInfo
+  {
+    FunctionNode *node = nullptr;
+    std::vector<const SymbolEntry *> params;
+    std::vector<bool> assigned;
+    std::vector<bool> in_condition;
+    uint32_t size = 0;
+  };
+
+  struct CallSite
+  {
+    FunctionInvocationNode *node;
+    uint32_t loop_depth;
+    std::vector<bool> known;
+    std::vector<int32_t> values;
+  };
+
+  const SymbolManager *m_symbol_manager_ptr;
+  std::map<InternedString, FunctionInfo> m_functions;
+  FunctionInfo *m_current_function = nullptr;
+  uint32_t m_function_first_node = 0;
+  std::vector<CallSite> m_call_sites;
+  uint32_t m_loop_depth = 0;
+  bool m_in_condition = false;
+  // m_in_condition outside each call being walked, innermost last
+  std::vector<bool> m_outer_in_condition;
+  uint32_t m_num_nodes = 0;
+
+  Specializations m_specializations;
+  std::map<const FunctionInvocationNode *, const Specialization *> m_site_clones;
+
+public:
+  ~CallSpecializer() = default;
+  explicit CallSpecializer(const SymbolManager *const p_symbol_manager)
+      : m_symbol_manager_ptr(p_symbol_manager) {}
+
+  // `p_growth_percent`: the clones may add this share of the AST nodes in
+  // the bodies of all functions
+  void run(ProgramNode &p_program, const uint32_t p_growth_percent);
+
+  // the clone `p_call` is redirected to, or nullptr
+  const Specialization *
+  getSpecialization(const FunctionInvocationNode &p_call) const;
+  const Specializations &getSpecializations() const
+  {
+    return m_specializations;
+  }
+
+private:
+  using AstWalker<CallSpecializer>::leave;
+
+  bool enter(ProgramNode &p_program);
+  void leave(ProgramNode &p_program);
+  bool enter(FunctionNode &p_function);
+  void leave(FunctionNode &p_function);
+  bool enter(CompoundStatementNode &p_compound_statement);
+  void leave(CompoundStatementNode &p_compound_statement);
+  bool enter(FunctionInvocationNode &p_func_invocation);
+  void leave(FunctionInvocationNode &p_func_invocation);
+  bool enter(VariableReferenceNode &p_variable_ref);
+  bool enter(AssignmentNode &p_assignment);
+  bool enter(ReadNode &p_read);
+  bool enter(IfNode &p_if);
+  bool enter(WhileNode &p_while);
+  bool enter(ForNode &p_for);
+  void leave(ForNode &p_for);
+  // declarations aren't counted, every other node is only counted
+  bool enter(DeclNode &) { return true; }
+  template <typename Node> bool enter(Node &)
+  {
+    ++m_num_nodes;
+    return true;
+  }
+
+  // index of `p_entry` among the parameters of the current function, or -1
+  int findParam(const SymbolEntry *p_entry) const;
+  void markAssigned(const VariableReferenceNode &p_target);
+  void selectClones(const uint32_t p_growth_percent);
+};
+
+#endif
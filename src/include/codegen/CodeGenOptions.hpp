@@ -0,0 +1,108 @@
+#ifndef CODEGEN_CODE_GEN_OPTIONS_H
+#define CODEGEN_CODE_GEN_OPTIONS_H
+
+#include <cstdint>
+#include <string>
+
+struct SchedModel;
+
+// Knobs that the driver forwards to the code generator and the passes that
+// run over its output.
+struct CodeGenOptions
+{
+  // -Os: prefer smaller encodings over everything else. Passes that trade
+  // size for speed must consult this before growing the code.
+  bool optimize_size = false;
+
+  // emit `.option rvc` and prefer operands that fit the compressed encodings
+  bool compressed = false;
+
+  // fold functions with identical bodies into one
+  bool merge_functions = false;
+
+  // outline repeated instruction sequences into shared routines
+  bool outline = false;
+
+  // -fshrink-wrap: save ra and s0 only on the paths that need them
+  bool shrink_wrap = false;
+
+  // -fspecialize[=growth]: lower clones of the functions called with
+  // constant arguments, letting them grow the program by `growth` percent
+  bool specialize = false;
+  uint32_t specialize_growth = 50;
+
+  // -ffold-pure-calls: run the calls to pure functions with constant
+  // arguments at compile time and use their results as literals
+  bool fold_pure_calls = false;
+
+  // -fscev: replace the reductions in for loops with their closed forms,
+  // deleting the loops nothing else happens in
+  bool scalar_evolution = false;
+
+  // -fmemoize[=entries]: give each pure recursive function a direct-mapped
+  // cache of `memoize_entries` results (a power of two, at most
+  // kMaxMemoizeEntries), looked up by its arguments on entry;
+  // -fmemoize-stats counts its hits and misses and prints them to stderr
+  // when main returns
+  static constexpr uint32_t kMaxMemoizeEntries = 65536;
+  bool memoize = false;
+  uint32_t memoize_entries = 256;
+  bool memoize_stats = false;
+
+  // -fif-conversion: compute both values of an if statement that assigns one
+  // variable on either arm, and select one without branching
+  bool if_conversion = false;
+
+  // -march=: ISA string of the target core, e.g. rv32imac_zba_zbb. The
+  // extensions below are taken from it; instruction selection consults them
+  // and never emits an instruction of one that is missing.
+  std::string march = "rv32imac";
+  // mul, div, rem; calls to __mulsi3, __divsi3 and __modsi3 otherwise
+  bool ext_m = true;
+  // mul alone
+  bool zmmul = false;
+  // the compressed encodings; -mrvc and -Os only use them if present
+  bool ext_c = true;
+  // accepted, but no instruction of theirs is selected yet: the code
+  // generator doesn't lower reals or arrays
+  bool ext_f = false;
+  bool ext_d = false;
+  bool ext_v = false;
+  // sh1add, sh2add, sh3add
+  bool zba = false;
+  // min, max
+  bool zbb = false;
+  // czero.eqz, czero.nez
+  bool zicond = false;
+
+  // -fipra: treat the functions defined in the program as private to it,
+  // give them a custom calling convention and let callers keep values in
+  // the registers their callees don't clobber
+  bool ipra = false;
+
+  // -mtune=: latency table of the core to schedule for; no scheduling if null
+  const SchedModel *sched_model = nullptr;
+
+  // -fprofile-generate[=file]: count the edges of every conditional branch
+  // and write them to `profile_generate_path` (<source>.prof if empty) when
+  // main returns
+  bool profile_generate = false;
+  std::string profile_generate_path;
+
+  // -fprofile-use=file: lay out the branches after the counts in `file`
+  std::string profile_use_path;
+
+  // print the per-function code size table after code generation
+  bool size_report = false;
+
+  // returns false if `p_arg` isn't a code generation flag
+  bool parse(const char *p_arg);
+  // settles the flags that depend on each other once all are parsed
+  void finalize();
+
+private:
+  // returns false if `p_isa` isn't a RV32 ISA string
+  bool parseMarch(const char *p_isa);
+};
+
+#endif
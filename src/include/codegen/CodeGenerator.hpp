@@ -1,63 +1,168 @@
 #ifndef CODEGEN_CODE_GENERATOR_H
 #define CODEGEN_CODE_GENERATOR_H
 
+#include "AST/BinaryOperator.hpp"
+#include "AST/FlatAst.hpp"
+#include "codegen/BranchProfile.hpp"
+#include "codegen/CallSpecializer.hpp"
+#include "codegen/CodeGenOptions.hpp"
+#include "codegen/ConstantFolder.hpp"
+#include "codegen/IfConversion.hpp"
+#include "codegen/MachineFunction.hpp"
+#include "codegen/PureCallEvaluator.hpp"
+#include "codegen/ScalarEvolution.hpp"
 #include "sema/SymbolTable.hpp"
-#include "visitor/AstNodeVisitor.hpp"
+#include "util/InternedString.hpp"
+#include "visitor/AstWalker.hpp"
 
 #include <cstdio>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
-class CodeGenerator final : public AstNodeVisitor
+class CodeGenerator final : public AstWalker<CodeGenerator>
 {
+  friend class AstWalker<CodeGenerator>;
+
 private:
   const SymbolManager *m_symbol_manager_ptr;
   std::string m_source_file_path;
   /// NOTE: `FILE` cannot be simply deleted by `delete`, so we need a custom deleter.
   std::unique_ptr<FILE, decltype(&fclose)> m_output_file{nullptr, &fclose};
+  CodeGenOptions m_options;
+
+  /// NOTE: instructions are buffered per function and only written out after
+  /// the machine passes have run over the whole module.
+  std::string m_asm_buffer;
+  MachineModule m_module;
+  std::map<std::string, uint32_t> m_original_code_size;
+
+  /// NOTE: the number of an if/while/for statement indexes both the edge
+  /// counters and the loaded profile.
+  BranchSiteNumbering m_branch_sites;
+  std::string m_profile_generate_path;
+  BranchProfile m_profile;
+  /// NOTE: blocks that never ran under the profile, emitted to
+  /// .text.unlikely after the function they belong to.
+  std::string m_cold_buffer;
+  /// NOTE: the code around each cold block being emitted, innermost last.
+  std::vector<std::string> m_hot_code;
+
+  /// NOTE: returns branch to a label in front of the epilogue, allocated by
+  /// the first return of the function.
+  int m_return_label = -1;
+  int m_return_jumps = 0;
+  std::string::size_type m_return_jump_end = std::string::npos;
+
+  /// NOTE: clones of the functions called with constant arguments; while
+  /// one is lowered, its bound parameters are folded into the body. Loop
+  /// variables are bound the same way to evaluate closed forms.
+  CallSpecializer m_specializer;
+  const Specialization *m_specialization = nullptr;
+  ConstantFolder::Bindings m_constant_params;
+  PureCallEvaluator m_pure_calls;
+  /// NOTE: only built for the passes that have moved to it.
+  FlatAst m_flat_ast;
+
+  /// NOTE: memoized functions and the size of their cache entries, in
+  /// emitting order, which indexes their counters; the entry a call looked
+  /// up and the copies of its arguments are kept in frame slots below the
+  /// locals until it returns.
+  std::vector<std::pair<InternedString, uint32_t>> m_memoized_functions;
+  int m_memo_hit_label = -1;
+  int m_memo_entry_offset = 0;
+  std::vector<int> m_memo_key_offsets;
+
+  /// NOTE: statements of the loops being lowered whose effect is added after
+  /// the loop instead.
+  std::set<const AstNode *> m_folded_statements;
 
-  int fp_offset = 0;
   bool global_decl = true;
-  std::map<const SymbolEntry *, int> local_variable_offset;
   char var_ref_mode = 'r';
   int func_para_num = 0, para_reg_idx = 0;
   int label_num = 1;
+  /// NOTE: labels an if statement allocates in one step of its lowering and
+  /// places in a later one.
+  std::vector<int> m_pending_labels;
 
 public:
   ~CodeGenerator() = default;
   CodeGenerator(const std::string &source_file_name,
                 const std::string &save_path,
-                const SymbolManager *const p_symbol_manager);
-
-  void visit(ProgramNode &p_program) override;
-  void visit(DeclNode &p_decl) override;
-  void visit(VariableNode &p_variable) override;
-  void visit(ConstantValueNode &p_constant_value) override;
-  void visit(FunctionNode &p_function) override;
-  void visit(CompoundStatementNode &p_compound_statement) override;
-  void visit(PrintNode &p_print) override;
-  void visit(BinaryOperatorNode &p_bin_op) override;
-  void visit(UnaryOperatorNode &p_un_op) override;
-  void visit(FunctionInvocationNode &p_func_invocation) override;
-  void visit(VariableReferenceNode &p_variable_ref) override;
-  void visit(AssignmentNode &p_assignment) override;
-  void visit(ReadNode &p_read) override;
-  void visit(IfNode &p_if) override;
-  void visit(WhileNode &p_while) override;
-  void visit(ForNode &p_for) override;
-  void visit(ReturnNode &p_return) override;
+                const SymbolManager *const p_symbol_manager,
+                const CodeGenOptions &p_options);
 
-public:
-  void erase_scope_local_variable(size_t level)
-  {
-    for (auto &i : local_variable_offset)
-    {
-      if (i.first->getLevel() == level)
-      {
-        local_variable_offset.erase(i.first);
-      }
-    }
-  }
+private:
+  using AstWalker<CodeGenerator>::enter;
+  using AstWalker<CodeGenerator>::leave;
+
+  bool enter(ProgramNode &p_program);
+  bool enter(VariableNode &p_variable);
+  bool enter(ConstantValueNode &p_constant_value);
+  bool enter(FunctionNode &p_function);
+  bool enter(CompoundStatementNode &p_compound_statement);
+  void leave(CompoundStatementNode &p_compound_statement);
+  bool enter(PrintNode &p_print);
+  void leave(PrintNode &p_print);
+  bool enter(BinaryOperatorNode &p_bin_op);
+  void leave(BinaryOperatorNode &p_bin_op);
+  void leave(UnaryOperatorNode &p_un_op);
+  bool enter(FunctionInvocationNode &p_func_invocation);
+  bool enter(VariableReferenceNode &p_variable_ref);
+  bool enter(AssignmentNode &p_assignment);
+  void leave(AssignmentNode &p_assignment);
+  bool enter(ReadNode &p_read);
+  void leave(ReadNode &p_read);
+  bool enter(IfNode &p_if);
+  bool enter(WhileNode &p_while);
+  bool enter(ForNode &p_for);
+  void leave(ReturnNode &p_return);
+
+  void beginFunction();
+  void emitReturnBlock();
+  void endFunction(const std::string &p_name, const uint32_t p_num_params,
+                   const bool p_exported);
+  void runMachinePasses();
+  void printSizeReport() const;
+
+  // returns the profile of `p_site` if the site ran at all
+  const BranchProfile::Site *getProfiledSite(const uint32_t p_site) const;
+  void emitEdgeCounter(const uint32_t p_site, const bool p_taken);
+  // the code emitted until endColdBlock() goes to .text.unlikely
+  void beginColdBlock(const int p_label);
+  void endColdBlock();
+  void emitLoopAlignment(const BranchProfile::Site &p_site);
+  void emitProfileWrite();
+  void emitProfileData();
+
+  // returns the size in bytes of a cache entry of a function with
+  // `p_num_params` parameters
+  static uint32_t getMemoEntrySize(const uint32_t p_num_params);
+  bool isMemoizable(const FunctionNode &p_function, const int p_free_offset) const;
+  void emitMemoLookup(const FunctionNode &p_function, const int p_free_offset);
+  void emitMemoStore();
+  void emitMemoCounter(const bool p_hit);
+  void emitMemoReport();
+  void emitMemoData();
+
+  // the arguments are on the stack
+  void emitCall(const FunctionInvocationNode &p_func_invocation,
+                const Specialization *p_clone);
+  void emitMulDiv(const Operator p_op);
+  void emitScale(const int32_t p_factor);
+
+  void emitReductions(const ForNode &p_for, const ScalarEvolution &p_scev);
+  void emitSelect(const IfNode &p_if, const IfConversion &p_select);
+
+  // binds the parameters `p_clone` passes constants to in m_constant_params
+  void bindParams(const Specialization &p_clone);
+  void emitSpecialization(const Specialization &p_clone);
+  // returns false unless the clone being lowered or the pure calls in it
+  // fix `p_condition`
+  bool foldCondition(const ExpressionNode &p_condition, int32_t &p_value);
 };
 
 #endif
@@ -0,0 +1,65 @@
+#ifndef CODEGEN_CONSTANT_FOLDER_H
+#define CODEGEN_CONSTANT_FOLDER_H
+
+#include "visitor/AstWalker.hpp"
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+class PureCallEvaluator;
+class SymbolEntry;
+class SymbolManager;
+
+// Evaluates integer and boolean expressions whose leaves are literals or
+// variables bound to known values, with the results the lowered code would
+// compute on RV32 (booleans are 0 or 1). Names are resolved in the scopes
+// the symbol manager currently has open. Constants declared with `var x: 1`
+// are always known, and so are calls if a PureCallEvaluator is given.
+//
+// Operands are evaluated in order and their values kept on a stack; the walk
+// stops at the first one that isn't known.
+class ConstantFolder final : public AstWalker<ConstantFolder>
+{
+  friend class AstWalker<ConstantFolder>;
+
+public:
+  using Bindings = std::map<const SymbolEntry *, int32_t>;
+
+private:
+  const SymbolManager *m_symbol_manager_ptr;
+  const Bindings &m_bindings;
+  PureCallEvaluator *m_calls;
+
+  bool m_known = false;
+  std::vector<int32_t> m_values;
+
+public:
+  ~ConstantFolder() = default;
+  ConstantFolder(const SymbolManager *const p_symbol_manager,
+                 const Bindings &p_bindings,
+                 PureCallEvaluator *const p_calls = nullptr)
+      : m_symbol_manager_ptr(p_symbol_manager), m_bindings(p_bindings),
+        m_calls(p_calls) {}
+
+  // returns false if the value of `p_expr` isn't known at compile time
+  bool evaluate(const ExpressionNode &p_expr, int32_t &p_value);
+
+private:
+  using AstWalker<ConstantFolder>::enter;
+
+  bool enter(ConstantValueNode &p_constant_value);
+  void leave(BinaryOperatorNode &p_bin_op);
+  void leave(UnaryOperatorNode &p_un_op);
+  bool enter(FunctionInvocationNode &p_func_invocation);
+  void leave(FunctionInvocationNode &p_func_invocation);
+  bool enter(VariableReferenceNode &p_variable_ref);
+
+  // the nodes that aren't expressions have no value
+  template <typename Node> void leave(Node &) { giveUp(); }
+
+  void giveUp();
+  int32_t pop();
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef CODEGEN_FRAME_LAYOUT_H
+#define CODEGEN_FRAME_LAYOUT_H
+
+#include "visitor/AstWalker.hpp"
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+class SymbolEntry;
+class SymbolManager;
+
+// Assigns the s0-relative slots of the parameters and locals of one function
+// (or of the body of main) and records them in their SymbolEntry.
+//
+// Parameters keep a slot each, in order, right below the saved registers.
+// Locals are numbered in the order they are visited and live from their
+// first reference to their last one, extended over every loop they are
+// referenced in; locals whose ranges don't overlap share a slot, so sibling
+// scopes, for-loop variables and dead locals don't grow the frame.
+class FrameLayout final : public AstWalker<FrameLayout>
+{
+  friend class AstWalker<FrameLayout>;
+
+private:
+  struct LiveRange
+  {
+    uint32_t begin;
+    uint32_t end;
+  };
+
+  const SymbolManager *m_symbol_manager_ptr;
+  uint32_t m_num_params = 0;
+  // locals in order of their first reference
+  std::vector<const SymbolEntry *> m_locals;
+  std::map<const SymbolEntry *, LiveRange> m_ranges;
+  uint32_t m_position = 0;
+  // m_position when each loop being walked was entered
+  std::vector<uint32_t> m_loop_begins;
+  uint32_t m_num_slots = 0;
+
+public:
+  ~FrameLayout() = default;
+  explicit FrameLayout(const SymbolManager *const p_symbol_manager)
+      : m_symbol_manager_ptr(p_symbol_manager) {}
+
+  // lays out the frame of `p_root`, a FunctionNode or the body of main
+  void run(AstNode &p_root);
+  // offset of the first slot below the parameters and locals, free for the
+  // code generator's own use
+  int getEndOffset() const;
+
+private:
+  using AstWalker<FrameLayout>::enter;
+  using AstWalker<FrameLayout>::leave;
+
+  bool enter(VariableNode &p_variable);
+  bool enter(FunctionNode &p_function);
+  void leave(FunctionNode &p_function);
+  bool enter(CompoundStatementNode &p_compound_statement);
+  void leave(CompoundStatementNode &p_compound_statement);
+  void leave(VariableReferenceNode &p_variable_ref);
+  bool enter(WhileNode &p_while);
+  void leave(WhileNode &p_while);
+  bool enter(ForNode &p_for);
+  void leave(ForNode &p_for);
+
+  void reference(const SymbolEntry *p_entry);
+  // the values of the locals referenced in a loop must survive its back edge
+  void extendOverLoop(const uint32_t p_begin);
+  void assignSlots();
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef CODEGEN_IF_CONVERSION_H
+#define CODEGEN_IF_CONVERSION_H
+
+#include "AST/FlatAst.hpp"
+#include "visitor/AstNodeVisitor.hpp"
+
+#include <cstdint>
+
+class ExpressionNode;
+class SymbolManager;
+
+// Finds the if statements that can be lowered without branches.
+//
+// `if c then x := a else x := b`, with x a scalar integer or boolean
+// variable, is `x := c ? a : b`. Both values are computed before one of
+// them is picked, so a and b must be cheap and free of side effects: no
+// calls, no array elements (the condition may be what keeps an index in
+// bounds) and a few operators at most. If c compares a with b, the select
+// is their minimum or maximum.
+//
+// The arms are scanned in the flat AST of the program.
+class IfConversion final
+{
+public:
+  enum class Kind : uint8_t
+  {
+    kSelect,
+    kMin,
+    kMax
+  };
+
+private:
+  const SymbolManager *m_symbol_manager_ptr;
+  const FlatAst &m_flat_ast;
+  const VariableReferenceNode *m_target = nullptr;
+  const ExpressionNode *m_then_value = nullptr;
+  const ExpressionNode *m_else_value = nullptr;
+  Kind m_kind = Kind::kSelect;
+
+public:
+  ~IfConversion() = default;
+  IfConversion(const SymbolManager *const p_symbol_manager,
+               const FlatAst &p_flat_ast)
+      : m_symbol_manager_ptr(p_symbol_manager), m_flat_ast(p_flat_ast) {}
+
+  // returns false if `p_if` keeps its branches
+  bool analyze(const IfNode &p_if);
+
+  const VariableReferenceNode &getTarget() const { return *m_target; }
+  const ExpressionNode &getThenValue() const { return *m_then_value; }
+  const ExpressionNode &getElseValue() const { return *m_else_value; }
+  Kind getKind() const { return m_kind; }
+
+private:
+  // the assignment `p_arm` consists of, or nullptr
+  static const AssignmentNode *getOnlyAssignment(const CompoundStatementNode *p_arm);
+  bool isSpeculatable(const ExpressionNode &p_expr) const;
+  // both are the same variable or the same literal
+  bool isSameValue(const ExpressionNode &p_a, const ExpressionNode &p_b) const;
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef CODEGEN_MACHINE_FUNCTION_H
+#define CODEGEN_MACHINE_FUNCTION_H
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// One line of the emitted assembly. The code generator still renders its
+// templates as text; the text is split back into lines so that the passes
+// after code generation can inspect and rewrite single instructions.
+struct MachineInstr
+{
+  enum class KindEnum : uint8_t
+  {
+    kInstruction,
+    kLabel,
+    kDirective
+  };
+
+  KindEnum kind;
+  // mnemonic for instructions, name for labels, raw text for directives
+  std::string opcode;
+  std::vector<std::string> operands;
+
+  MachineInstr(const KindEnum p_kind, const std::string &p_opcode)
+      : kind(p_kind), opcode(p_opcode) {}
+  MachineInstr(const std::string &p_opcode,
+               const std::vector<std::string> &p_operands)
+      : kind(KindEnum::kInstruction), opcode(p_opcode),
+        operands(p_operands) {}
+
+  static MachineInstr parse(const std::string &p_line);
+
+  bool isInstruction() const { return kind == KindEnum::kInstruction; }
+  bool isLabel() const { return kind == KindEnum::kLabel; }
+  bool isDirective() const { return kind == KindEnum::kDirective; }
+
+  // encoded size in bytes; pseudo instructions count all the instructions
+  // they expand to
+  uint32_t getEncodedSize(const bool p_compressed) const;
+
+  std::string toString() const;
+};
+
+class MachineFunction
+{
+public:
+  using Instrs = std::vector<MachineInstr>;
+
+private:
+  std::string m_name;
+  Instrs m_instrs;
+  // set once the body has been merged into an identical function
+  std::string m_alias_of;
+  // arguments are stored to the frame right after the prologue, in order
+  uint32_t m_num_params = 0;
+  // false if only code in this module calls the function, which leaves its
+  // calling convention up to the passes
+  bool m_exported = true;
+
+public:
+  ~MachineFunction() = default;
+  MachineFunction(const std::string &p_name, const std::string &p_text);
+
+  const std::string &getName() const { return m_name; }
+  const char *getNameCString() const { return m_name.c_str(); }
+
+  Instrs &getInstrs() { return m_instrs; }
+  const Instrs &getInstrs() const { return m_instrs; }
+
+  uint32_t getNumParams() const { return m_num_params; }
+  void setNumParams(const uint32_t p_num_params) { m_num_params = p_num_params; }
+
+  bool isExported() const { return m_exported; }
+  void setExported(const bool p_exported) { m_exported = p_exported; }
+
+  uint32_t getCodeSize(const bool p_compressed) const;
+
+  bool isAlias() const { return !m_alias_of.empty(); }
+  const std::string &getAliasOf() const { return m_alias_of; }
+  // drops the body and defines the symbol as `p_target` instead
+  void makeAliasOf(const std::string &p_target);
+
+  void print(FILE *p_out_file) const;
+};
+
+// The whole output file: the file prologue and global data that precede the
+// functions, followed by the functions in emission order and the data that is
+// only known once all of them have been lowered.
+class MachineModule
+{
+public:
+  using Functions = std::vector<std::unique_ptr<MachineFunction>>;
+
+private:
+  std::string m_header;
+  Functions m_functions;
+  std::string m_trailer;
+
+public:
+  void appendHeader(const std::string &p_text) { m_header += p_text; }
+  void appendTrailer(const std::string &p_text) { m_trailer += p_text; }
+  void addFunction(MachineFunction *p_function)
+  {
+    m_functions.emplace_back(p_function);
+  }
+
+  Functions &getFunctions() { return m_functions; }
+  const Functions &getFunctions() const { return m_functions; }
+
+  void print(FILE *p_out_file) const;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef CODEGEN_MACHINE_PASSES_H
+#define CODEGEN_MACHINE_PASSES_H
+
+#include "codegen/CodeGenOptions.hpp"
+#include "codegen/MachineFunction.hpp"
+
+// Passes over the buffered assembly, run by CodeGenerator once the whole
+// program has been lowered. They are free functions since none of them keeps
+// state across modules.
+
+// Drops the saves of ra and s0 that the function doesn't need and moves the
+// save of ra to the paths that make calls.
+void shrinkWrapFunction(MachineFunction &p_function,
+                        const CodeGenOptions &p_options);
+
+// Rewrites scratch registers and operand orders so that the assembler can
+// pick the 2-byte RVC encodings.
+void compressFunction(MachineFunction &p_function,
+                      const CodeGenOptions &p_options);
+
+// Interprocedural register allocation: computes the registers each function
+// clobbers over the call graph, passes the arguments of private functions in
+// registers they leave alone, and forwards stored values to later loads
+// across the calls that preserve them.
+void allocateInterprocedural(MachineModule &p_module,
+                             const CodeGenOptions &p_options);
+
+// Per-core latencies used by the scheduler, selected by -mtune=.
+struct SchedModel
+{
+  const char *name;
+  uint32_t load_latency;
+  uint32_t mul_latency;
+  uint32_t div_latency;
+};
+
+// returns nullptr for an unknown core
+const SchedModel *findSchedModel(const char *p_name);
+
+// Reorders the instructions of each basic block to hide load and mul/div
+// latencies on in-order pipelines.
+void scheduleFunction(MachineFunction &p_function,
+                      const CodeGenOptions &p_options);
+
+// Folds functions whose bodies are identical up to their names into one body
+// plus `.set` aliases.
+void mergeIdenticalFunctions(MachineModule &p_module,
+                             const CodeGenOptions &p_options);
+
+// Hoists instruction sequences repeated across the module into millicode
+// routines called with `jal t0`.
+void outlineModule(MachineModule &p_module, const CodeGenOptions &p_options);
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef CODEGEN_PURE_CALL_EVALUATOR_H
+#define CODEGEN_PURE_CALL_EVALUATOR_H
+
+#include "codegen/ConstantFolder.hpp"
+#include "util/InternedString.hpp"
+#include "visitor/AstWalker.hpp"
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+class SymbolManager;
+
+// Runs calls to pure functions at compile time.
+//
+// A function is pure if it takes and returns integers or booleans, doesn't
+// print, read or assign global variables, and calls pure functions only. It
+// may still read global variables, so its result can change between calls
+// unless it reads global constants only; see readsGlobals. Its body is
+// interpreted over the AST with the arguments bound to its parameters. An
+// evaluation that takes more than a fixed number of steps, recurses too deep
+// or reaches anything the interpreter can't model (arrays, global variables,
+// variables read before they are assigned) gives up, and the call is lowered
+// as usual.
+//
+// The outcome of a call is kept by callee and arguments, failures included,
+// so the code generator may ask about a call site as often as it likes and
+// each call is run at most once. The steps are counted over the whole
+// compilation as well, so that many calls that all give up late can't make
+// it arbitrarily slow.
+class PureCallEvaluator final : public AstWalker<PureCallEvaluator>
+{
+  friend class AstWalker<PureCallEvaluator>;
+
+private:
+  struct Frame
+  {
+    ConstantFolder::Bindings values;
+    bool returned = false;
+    int32_t return_value = 0;
+  };
+
+  const SymbolManager *m_symbol_manager_ptr;
+  std::map<InternedString, FunctionNode *> m_pure_functions;
+  std::map<InternedString, std::set<InternedString>> m_callees;
+  // the pure functions whose own bodies read global variables
+  std::set<InternedString> m_global_readers;
+  using CallKey = std::pair<InternedString, std::vector<int32_t>>;
+  // results of the calls evaluated so far, by callee and arguments
+  std::map<CallKey, int32_t> m_results;
+  // the calls that couldn't be evaluated
+  std::set<CallKey> m_unknown;
+
+  Frame *m_frame = nullptr;
+  uint32_t m_depth = 0;
+  // steps taken over the whole compilation, and when the outermost call
+  // being evaluated started
+  uint32_t m_steps = 0;
+  uint32_t m_call_start = 0;
+  bool m_failed = false;
+
+public:
+  ~PureCallEvaluator() = default;
+  explicit PureCallEvaluator(const SymbolManager *const p_symbol_manager)
+      : m_symbol_manager_ptr(p_symbol_manager) {}
+
+  // finds the pure functions of `p_program`
+  void analyze(ProgramNode &p_program);
+  bool isPure(const InternedString p_name) const
+  {
+    return m_pure_functions.count(p_name) != 0;
+  }
+  // true if the pure function `p_name` may call itself
+  bool isRecursive(const InternedString p_name) const;
+  // true if the pure function `p_name`, or a function it calls, reads a
+  // global variable that isn't a constant
+  bool readsGlobals(const InternedString p_name) const;
+
+  // returns false if `p_call` can't be evaluated at compile time
+  bool call(const FunctionInvocationNode &p_call,
+            const std::vector<int32_t> &p_args, int32_t &p_result);
+
+private:
+  using AstWalker<PureCallEvaluator>::enter;
+  using AstWalker<PureCallEvaluator>::leave;
+
+  bool enter(DeclNode &p_decl);
+  bool enter(FunctionNode &p_function);
+  void leave(FunctionNode &p_function);
+  bool enter(CompoundStatementNode &p_compound_statement);
+  void leave(CompoundStatementNode &p_compound_statement);
+  bool enter(PrintNode &p_print);
+  bool enter(FunctionInvocationNode &p_func_invocation);
+  bool enter(AssignmentNode &p_assignment);
+  bool enter(ReadNode &p_read);
+  bool enter(IfNode &p_if);
+  bool enter(WhileNode &p_while);
+  bool enter(ForNode &p_for);
+  bool enter(ReturnNode &p_return);
+
+  bool isDone() const { return m_failed || m_frame->returned; }
+  void step();
+  bool evaluate(const ExpressionNode &p_expr, int32_t &p_value);
+  void assign(const VariableReferenceNode &p_target, const int32_t p_value);
+  // schedule the next iteration of a loop, if it runs
+  void iterate(const WhileNode &p_while);
+  void iterate(const ForNode &p_for, const SymbolEntry *p_loop_var,
+               const int32_t p_upper_bound);
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef CODEGEN_SCALAR_EVOLUTION_H
+#define CODEGEN_SCALAR_EVOLUTION_H
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+class AssignmentNode;
+class AstNode;
+class ForNode;
+class SymbolEntry;
+class SymbolManager;
+
+// Finds the reductions in the body of a for loop and their closed forms.
+//
+// A reduction is a statement `x := x + e` of the body, where x is an integer
+// variable and e a polynomial of degree d <= 3 in the loop variable i, all of
+// whose other operands the loop leaves alone. x may stand anywhere in a chain
+// of additions and subtractions, as long as it is added once: e is then the
+// right-hand side with x taken as 0. Over the N iterations from i = L, by
+// Newton's forward differences,
+//
+//   sum e(i) = C(N,1) e(L) + C(N,2) De(L) + ... + C(N,d+1) D^d e(L)
+//
+// which is a sum of e(L), ..., e(L+d) with weights known at compile time.
+// The identity holds for integers modulo 2^32 too, so it gives the wrapped
+// value the loop computes. A statement that reads or writes x, or writes an
+// operand of e, keeps the reduction in the loop.
+class ScalarEvolution
+{
+public:
+  struct Reduction
+  {
+    const AssignmentNode *update;
+    const SymbolEntry *accumulator;
+    // of e(L), e(L+1), ...
+    std::vector<uint32_t> weights;
+  };
+
+private:
+  const SymbolManager *m_symbol_manager_ptr;
+  std::vector<Reduction> m_reductions;
+  std::set<const AstNode *> m_folded;
+  bool m_loop_dead = false;
+
+public:
+  ~ScalarEvolution() = default;
+  explicit ScalarEvolution(const SymbolManager *const p_symbol_manager)
+      : m_symbol_manager_ptr(p_symbol_manager) {}
+
+  // `p_for` must be the innermost scope open in the symbol manager; returns
+  // false if no statement of its body folds
+  bool analyze(const ForNode &p_for);
+
+  const std::vector<Reduction> &getReductions() const { return m_reductions; }
+  bool isFolded(const AstNode &p_statement) const
+  {
+    return m_folded.count(&p_statement) != 0;
+  }
+  // nothing but reductions happens in the loop
+  bool isLoopDead() const { return m_loop_dead; }
+
+  // C(N,1), ..., C(N,d+1) turned into the weights of e(L), ..., e(L+d)
+  static std::vector<uint32_t> computeWeights(const uint64_t p_trip_count,
+                                              const uint32_t p_degree);
+};
+
+#endif
@@ -1,13 +1,16 @@
 #ifndef SEMA_SEMANTIC_ANALYZER_H
 #define SEMA_SEMANTIC_ANALYZER_H
 
+#include "AST/AstContext.hpp"
 #include "sema/SymbolTable.hpp"
-#include "visitor/AstNodeVisitor.hpp"
+#include "visitor/AstWalker.hpp"
 
 #include <set>
 #include <stack>
 
-class SemanticAnalyzer final : public AstNodeVisitor {
+class SemanticAnalyzer final : public AstWalker<SemanticAnalyzer> {
+    friend class AstWalker<SemanticAnalyzer>;
+
   private:
     enum class SemanticContext : uint8_t {
         kGlobal,
@@ -17,6 +20,8 @@ class SemanticAnalyzer final : public AstNodeVisitor {
     };
 
   private:
+    // holds the inferred types
+    AstContext &m_context;
     SymbolManager m_symbol_manager;
     std::stack<SemanticContext> m_context_stack;
     std::stack<const PType *> m_returned_type_stack;
@@ -27,31 +32,38 @@ class SemanticAnalyzer final : public AstNodeVisitor {
 
   public:
     ~SemanticAnalyzer() = default;
-    SemanticAnalyzer(const bool opt_dmp) : m_symbol_manager(opt_dmp) {}
-
-    void visit(ProgramNode &p_program) override;
-    void visit(DeclNode &p_decl) override;
-    void visit(VariableNode &p_variable) override;
-    void visit(ConstantValueNode &p_constant_value) override;
-    void visit(FunctionNode &p_function) override;
-    void visit(CompoundStatementNode &p_compound_statement) override;
-    void visit(PrintNode &p_print) override;
-    void visit(BinaryOperatorNode &p_bin_op) override;
-    void visit(UnaryOperatorNode &p_un_op) override;
-    void visit(FunctionInvocationNode &p_func_invocation) override;
-    void visit(VariableReferenceNode &p_variable_ref) override;
-    void visit(AssignmentNode &p_assignment) override;
-    void visit(ReadNode &p_read) override;
-    void visit(IfNode &p_if) override;
-    void visit(WhileNode &p_while) override;
-    void visit(ForNode &p_for) override;
-    void visit(ReturnNode &p_return) override;
+    SemanticAnalyzer(const bool opt_dmp, AstContext &p_context)
+        : m_context(p_context), m_symbol_manager(opt_dmp) {}
 
     bool hasError() const { return m_has_error; }
 
     const SymbolManager *getSymbolManager() const { return &m_symbol_manager; }
 
   private:
+    using AstWalker<SemanticAnalyzer>::enter;
+    using AstWalker<SemanticAnalyzer>::leave;
+
+    bool enter(ProgramNode &p_program);
+    void leave(ProgramNode &p_program);
+    bool enter(VariableNode &p_variable);
+    void leave(ConstantValueNode &p_constant_value);
+    bool enter(FunctionNode &p_function);
+    void leave(FunctionNode &p_function);
+    bool enter(CompoundStatementNode &p_compound_statement);
+    void leave(CompoundStatementNode &p_compound_statement);
+    void leave(PrintNode &p_print);
+    void leave(BinaryOperatorNode &p_bin_op);
+    void leave(UnaryOperatorNode &p_un_op);
+    void leave(FunctionInvocationNode &p_func_invocation);
+    void leave(VariableReferenceNode &p_variable_ref);
+    void leave(AssignmentNode &p_assignment);
+    void leave(ReadNode &p_read);
+    void leave(IfNode &p_if);
+    void leave(WhileNode &p_while);
+    bool enter(ForNode &p_for);
+    void leave(ForNode &p_for);
+    void leave(ReturnNode &p_return);
+
     bool isInForLoop() const {
         return m_context_stack.top() == SemanticContext::kForLoop;
     }
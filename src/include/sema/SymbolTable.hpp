@@ -3,12 +3,12 @@
 
 #include "AST/PType.hpp"
 #include "AST/function.hpp"
+#include "util/InternedString.hpp"
 
 #include <cstdint>
-#include <map>
 #include <memory>
 #include <stack>
-#include <string>
+#include <unordered_map>
 #include <vector>
 
 /*
@@ -50,28 +50,31 @@ class SymbolEntry {
     };
 
   private:
-    const std::string &m_name;
+    InternedString m_name;
     KindEnum m_kind;
     size_t m_level;
     const PType *m_p_type;
     Attribute m_attribute;
+    // s0-relative slot of a parameter or local, assigned by the code
+    // generator once the tables are complete
+    mutable int m_frame_offset = 0;
 
   public:
     ~SymbolEntry() = default;
 
-    SymbolEntry(const std::string &p_name, const KindEnum kind,
+    SymbolEntry(const InternedString p_name, const KindEnum kind,
                 const size_t level, const PType *const p_type,
                 const Constant *const p_constant)
         : m_name(p_name), m_kind(kind), m_level(level), m_p_type(p_type),
           m_attribute(p_constant) {}
 
-    SymbolEntry(const std::string &p_name, const KindEnum kind,
+    SymbolEntry(const InternedString p_name, const KindEnum kind,
                 const size_t level, const PType *const p_type,
                 const FunctionNode::DeclNodes *const p_parameters)
         : m_name(p_name), m_kind(kind), m_level(level), m_p_type(p_type),
           m_attribute(p_parameters) {}
 
-    const std::string &getName() const { return m_name; };
+    InternedString getName() const { return m_name; };
     const char *getNameCString() const { return m_name.c_str(); };
 
     const KindEnum getKind() const { return m_kind; };
@@ -81,6 +84,11 @@ class SymbolEntry {
     const PType *getTypePtr() const { return m_p_type; };
 
     const Attribute &getAttribute() const { return m_attribute; };
+
+    int getFrameOffset() const { return m_frame_offset; }
+    void setFrameOffset(const int p_offset) const {
+        m_frame_offset = p_offset;
+    }
 };
 
 class SymbolTable {
@@ -97,11 +105,11 @@ class SymbolTable {
 
     const Entries &getEntries() const { return m_entries; };
 
-    SymbolEntry *addSymbol(const std::string &p_name,
+    SymbolEntry *addSymbol(const InternedString p_name,
                            const SymbolEntry::KindEnum kind, const size_t level,
                            const PType *const p_type,
                            const Constant *const p_constant);
-    SymbolEntry *addSymbol(const std::string &p_name,
+    SymbolEntry *addSymbol(const InternedString p_name,
                            const SymbolEntry::KindEnum kind, const size_t level,
                            const PType *const p_type,
                            const FunctionNode::DeclNodes *const p_parameters);
@@ -110,7 +118,7 @@ class SymbolTable {
 class SymbolManager {
   public:
     using Tables = std::vector<std::unique_ptr<SymbolTable>>;
-    using NameEntryMap = std::map<std::string, SymbolEntry *>;
+    using NameEntryMap = std::unordered_map<InternedString, SymbolEntry *>;
 
   private:
     Tables m_in_use_tables;
@@ -119,7 +127,8 @@ class SymbolManager {
     Tables m_popped_tables;
 
     mutable NameEntryMap m_hash_entries;
-    mutable std::map<std::string, std::stack<SymbolEntry *>> m_hidden_entries;
+    mutable std::unordered_map<InternedString, std::stack<SymbolEntry *>>
+        m_hidden_entries;
 
     SymbolTable *m_current_table = nullptr;
     size_t m_current_level = 0;
@@ -144,21 +153,21 @@ class SymbolManager {
 
     template <typename AttributeType>
     friend SymbolEntry *
-    genericAddSymbol(SymbolManager &p_manager, const std::string &p_name,
+    genericAddSymbol(SymbolManager &p_manager, const InternedString p_name,
                      const SymbolEntry::KindEnum kind,
                      const PType *const p_type,
                      const AttributeType *const p_attribute);
 
-    SymbolEntry *addSymbol(const std::string &p_name,
+    SymbolEntry *addSymbol(const InternedString p_name,
                            const SymbolEntry::KindEnum kind,
                            const PType *const p_type,
                            const Constant *const p_constant);
-    SymbolEntry *addSymbol(const std::string &p_name,
+    SymbolEntry *addSymbol(const InternedString p_name,
                            const SymbolEntry::KindEnum kind,
                            const PType *const p_type,
                            const FunctionNode::DeclNodes *const p_parameters);
 
-    const SymbolEntry *lookup(const std::string &p_name) const;
+    const SymbolEntry *lookup(const InternedString p_name) const;
 
     const SymbolTable *getCurrentTable() const { return m_current_table; }
     size_t getCurrentLevel() const { return m_current_level; }
@@ -169,7 +178,7 @@ class SymbolManager {
 
   private:
     std::pair<bool, SymbolEntry *>
-    checkExistence(const std::string &p_name, const size_t current_level) const;
+    checkExistence(const InternedString p_name, const size_t current_level) const;
 };
 
 #endif
@@ -1,8 +1,8 @@
 #ifndef SEMA_ERROR_H
 #define SEMA_ERROR_H
 
-struct Location;
+class Location;
 
-void logSemanticError(const Location &, const char *format, ...);
+void logSemanticError(const Location, const char *format, ...);
 
 #endif
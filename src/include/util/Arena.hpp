@@ -0,0 +1,108 @@
+#ifndef UTIL_ARENA_H
+#define UTIL_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A bump allocator. Memory is handed out from the front of the current
+// block, and every block is freed at once when the arena is released, so an
+// object never returns its own memory.
+//
+// Nothing placed in the arena is destroyed. An object put there must keep
+// whatever it owns in the same arena, e.g. through ArenaVector or
+// ArenaString, or it leaks.
+class Arena {
+  private:
+    struct Block {
+        Block *prev;
+    };
+
+    char *m_cur = nullptr;
+    char *m_end = nullptr;
+    Block *m_last_block = nullptr;
+    size_t m_next_block_size = kMinBlockSize;
+    size_t m_bytes_allocated = 0;
+
+  public:
+    static constexpr size_t kMinBlockSize = 64 * 1024;
+    static constexpr size_t kMaxBlockSize = 4 * 1024 * 1024;
+
+    Arena() = default;
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    ~Arena() { release(); }
+
+    void *allocate(const size_t p_size, const size_t p_align) {
+        const uintptr_t cur = reinterpret_cast<uintptr_t>(m_cur);
+        const uintptr_t aligned = (cur + p_align - 1) & ~(p_align - 1);
+        if (m_cur && p_size <= static_cast<size_t>(m_end - m_cur) &&
+            aligned - cur <= static_cast<size_t>(m_end - m_cur) - p_size) {
+            m_cur = reinterpret_cast<char *>(aligned + p_size);
+            m_bytes_allocated += p_size;
+            return reinterpret_cast<void *>(aligned);
+        }
+        return allocateInNewBlock(p_size, p_align);
+    }
+
+    template <typename T, typename... Args> T *create(Args &&...p_args) {
+        return new (allocate(sizeof(T), alignof(T)))
+            T(std::forward<Args>(p_args)...);
+    }
+
+    // a NUL-terminated copy of `p_length` bytes of `p_text`
+    char *copyString(const char *p_text, const size_t p_length);
+
+    // Frees every block. The cost depends on the number of blocks, which
+    // grow geometrically, not on the number of objects.
+    void release();
+
+    // the bytes handed out, without the alignment padding and block tails
+    size_t getBytesAllocated() const { return m_bytes_allocated; }
+
+  private:
+    void *allocateInNewBlock(const size_t p_size, const size_t p_align);
+};
+
+// Lets the standard containers take their storage from an arena. Memory
+// given back to it is only reclaimed when the arena is released.
+template <typename T> class ArenaAllocator {
+  private:
+    Arena *m_arena;
+
+    template <typename U> friend class ArenaAllocator;
+
+  public:
+    using value_type = T;
+
+    ArenaAllocator(Arena &p_arena) : m_arena(&p_arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &p_other)
+        : m_arena(p_other.m_arena) {}
+
+    T *allocate(const size_t p_num) {
+        return static_cast<T *>(m_arena->allocate(p_num * sizeof(T), alignof(T)));
+    }
+    void deallocate(T *, const size_t) {}
+
+    Arena &getArena() const { return *m_arena; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &p_other) const {
+        return m_arena == p_other.m_arena;
+    }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> &p_other) const {
+        return m_arena != p_other.m_arena;
+    }
+};
+
+template <typename T> using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+using ArenaString =
+    std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef UTIL_INTERNED_STRING_H
+#define UTIL_INTERNED_STRING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// A name kept once in a table shared by the scanner, the AST and the symbol
+// tables, and passed around as its 32-bit index. Interning the same spelling
+// twice gives the same index, so names are compared, ordered and hashed as
+// integers. The spelling stays at the same address until the program exits.
+//
+// The order is the order of first appearance, not the alphabetical one.
+class InternedString {
+  public:
+    using Id = uint32_t;
+
+  private:
+    // 0 is the empty string
+    Id m_id = 0;
+
+    explicit InternedString(const Id p_id) : m_id(p_id) {}
+
+  public:
+    InternedString() = default;
+    InternedString(const char *p_text, const size_t p_length);
+    explicit InternedString(const char *p_text);
+    explicit InternedString(const std::string &p_text)
+        : InternedString(p_text.data(), p_text.size()) {}
+
+    // `p_id` must come from getId()
+    static InternedString fromId(const Id p_id) { return InternedString(p_id); }
+
+    Id getId() const { return m_id; }
+    const std::string &str() const;
+    const char *c_str() const { return str().c_str(); }
+    size_t size() const { return str().size(); }
+    bool empty() const { return m_id == 0; }
+
+    // the number of distinct strings interned so far, the empty one included
+    static size_t getNumInterned();
+
+    friend bool operator==(const InternedString p_a, const InternedString p_b) {
+        return p_a.m_id == p_b.m_id;
+    }
+    friend bool operator!=(const InternedString p_a, const InternedString p_b) {
+        return p_a.m_id != p_b.m_id;
+    }
+    friend bool operator<(const InternedString p_a, const InternedString p_b) {
+        return p_a.m_id < p_b.m_id;
+    }
+};
+
+namespace std {
+template <> struct hash<InternedString> {
+    size_t operator()(const InternedString p_string) const {
+        return p_string.getId();
+    }
+};
+} // namespace std
+
+#endif
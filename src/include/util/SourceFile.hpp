@@ -0,0 +1,76 @@
+#ifndef UTIL_SOURCE_FILE_H
+#define UTIL_SOURCE_FILE_H
+
+#include "util/SourceLocation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The source program, mapped into memory once. The scanner runs over the
+// mapping in place, and the listing and the diagnostics point into it
+// instead of copying or re-reading lines.
+//
+// The mapping is private and writable, since the lexers terminate each token
+// with a NUL byte while it is looked at. kPadding NUL bytes follow the text:
+// yy_scan_buffer() requires two, and the vector loads of the hand-written
+// lexer may read up to 15 bytes past the end.
+//
+// The beginnings of the lines are only looked up for diagnostics, so they are
+// found on the first lookup, by one memchr() pass over the text.
+//
+// Each file takes the next range of the 32-bit Location space when it is
+// opened: its own size plus one, for the end of the file. Location 0 is in
+// no file. The files of a run must fit in that space together.
+class SourceFile {
+  private:
+    char *m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_mapped_size = 0;
+    // the location of the first byte
+    uint32_t m_base = 0;
+
+    mutable std::vector<uint32_t> m_line_begins;
+
+  public:
+    static constexpr size_t kNumTrailingNuls = 2;
+    static constexpr size_t kPadding = 64;
+
+    SourceFile() = default;
+    SourceFile(const SourceFile &) = delete;
+    SourceFile &operator=(const SourceFile &) = delete;
+    ~SourceFile();
+
+    // returns false with errno set if `p_path` can't be mapped, or EFBIG if
+    // it doesn't fit in the locations left
+    bool open(const char *p_path);
+
+    char *getData() const { return m_data; }
+    // of the text alone
+    size_t getSize() const { return m_size; }
+    // of the text and the NUL bytes flex wants after it
+    size_t getBufferSize() const { return m_size + kNumTrailingNuls; }
+
+    uint32_t getNumLines() const;
+    // the text of line `p_line` (1-based), without its newline
+    const char *getLine(const uint32_t p_line, size_t &p_length) const;
+    // 1-based line and column of the byte at `p_offset`
+    void getLineAndColumn(const size_t p_offset, uint32_t &p_line,
+                          uint32_t &p_col) const;
+
+    // of the byte at `p_pos`, in the text or at its end
+    Location getLocation(const char *p_pos) const {
+        return Location(m_base + static_cast<uint32_t>(p_pos - m_data));
+    }
+    // the open file `p_location` is in, or nullptr
+    static const SourceFile *getFileOf(const Location p_location);
+    // the offset of `p_location` in this file, which must contain it
+    size_t getOffsetOf(const Location p_location) const {
+        return p_location.getOffset() - m_base;
+    }
+
+  private:
+    void buildLineIndex() const;
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef UTIL_SOURCE_LOCATION_H
+#define UTIL_SOURCE_LOCATION_H
+
+#include <cstdint>
+
+// A position in the source, kept as one 32-bit offset. The files opened in a
+// run are laid end to end in a single offset space, so the offset also says
+// which file it is in (see SourceFile). The line and the column are only
+// worked out when a diagnostic or a dump prints them.
+//
+// The default location is in no file, and decodes to line 0, column 0.
+class Location {
+  private:
+    uint32_t m_offset = 0;
+
+  public:
+    struct LineAndColumn {
+        uint32_t line;
+        uint32_t col;
+    };
+
+    Location() = default;
+    explicit Location(const uint32_t p_offset) : m_offset(p_offset) {}
+
+    uint32_t getOffset() const { return m_offset; }
+    bool isValid() const { return m_offset != 0; }
+
+    // looks the line up in the file; defined with SourceFile
+    LineAndColumn decode() const;
+
+    friend bool operator==(const Location p_a, const Location p_b) {
+        return p_a.m_offset == p_b.m_offset;
+    }
+    friend bool operator!=(const Location p_a, const Location p_b) {
+        return p_a.m_offset != p_b.m_offset;
+    }
+};
+
+#endif
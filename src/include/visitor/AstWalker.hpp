@@ -0,0 +1,141 @@
+#ifndef VISITOR_AST_WALKER_H
+#define VISITOR_AST_WALKER_H
+
+#include "AST/ast.hpp"
+#include "visitor/StaticAstVisitor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Walks a tree with a stack on the heap instead of recursing, so how deep the
+// input nests only costs memory: an expression or a statement nested a
+// million levels deep is walked in linear time, on a native stack that
+// doesn't grow with it.
+//
+// `Derived` provides, for the node classes it handles,
+//   bool enter(X &) - called before the children; false skips the children
+//                     and leave()
+//   void leave(X &) - called after the children
+// and brings the defaults for the others in with
+// `using AstWalker<Derived>::enter;` and `using AstWalker<Derived>::leave;`.
+//
+// A hook that needs a different order schedules it: the subtrees and the
+// steps it passes to schedule() run right after it, in the order given, and
+// before the children. Whatever a step has to hand over to a later one lives
+// in the pass, e.g. on a stack of its own. walk() can be called again from a
+// hook, for a subtree that isn't nested any deeper, and returns once that
+// subtree is done.
+template <typename Derived> class AstWalker {
+  public:
+    using Step = std::function<void()>;
+
+  private:
+    enum class Action : uint8_t { kEnter, kLeave, kStep };
+
+    struct Work {
+        AstNode *node;
+        Action action;
+    };
+
+    std::vector<Work> m_stack;
+    // the function of each kStep entry on the stack, in the same order
+    std::vector<Step> m_steps;
+    // what the running hook scheduled, in the order it runs
+    std::vector<Work> m_scheduled;
+    std::vector<Step> m_scheduled_steps;
+    bool m_stopped = false;
+
+  protected:
+    ~AstWalker() = default;
+
+    template <typename Node> bool enter(Node &) { return true; }
+    template <typename Node> void leave(Node &) {}
+
+    void schedule(AstNode &p_node) {
+        m_scheduled.push_back({&p_node, Action::kEnter});
+    }
+    // for the nodes the getters hand out as const
+    void schedule(const AstNode &p_node) {
+        schedule(const_cast<AstNode &>(p_node));
+    }
+    void schedule(Step p_step) {
+        m_scheduled.push_back({nullptr, Action::kStep});
+        m_scheduled_steps.push_back(std::move(p_step));
+    }
+    template <typename Node> void scheduleChildNodes(Node &p_node) {
+        p_node.forEachChild([this](AstNode &p_child) { schedule(p_child); });
+    }
+    template <typename Node> void scheduleChildNodes(const Node &p_node) {
+        scheduleChildNodes(const_cast<Node &>(p_node));
+    }
+    template <typename Node> void scheduleLeave(Node &p_node) {
+        m_scheduled.push_back({&p_node, Action::kLeave});
+    }
+
+    // drops the rest of the innermost walk, which returns after the hook
+    void stop() { m_stopped = true; }
+
+  public:
+    void walk(AstNode &p_root) {
+        auto &derived = static_cast<Derived &>(*this);
+        const size_t stack_base = m_stack.size();
+        const size_t steps_base = m_steps.size();
+
+        m_stack.push_back({&p_root, Action::kEnter});
+        while (m_stack.size() > stack_base) {
+            const Work work = m_stack.back();
+            m_stack.pop_back();
+
+            const size_t scheduled_base = m_scheduled.size();
+            const size_t scheduled_steps_base = m_scheduled_steps.size();
+            switch (work.action) {
+            case Action::kEnter:
+                dispatchOnKind(*work.node, [&](auto &p_node) {
+                    if (derived.enter(p_node)) {
+                        scheduleChildNodes(p_node);
+                        scheduleLeave(p_node);
+                    }
+                });
+                break;
+            case Action::kLeave:
+                dispatchOnKind(*work.node,
+                               [&](auto &p_node) { derived.leave(p_node); });
+                break;
+            case Action::kStep: {
+                const Step step = std::move(m_steps.back());
+                m_steps.pop_back();
+                step();
+                break;
+            }
+            }
+
+            if (m_stopped) {
+                m_stopped = false;
+                m_scheduled.resize(scheduled_base);
+                m_scheduled_steps.resize(scheduled_steps_base);
+                m_stack.resize(stack_base);
+                m_steps.resize(steps_base);
+                return;
+            }
+
+            // the stack pops the last one first
+            for (size_t i = m_scheduled.size(); i > scheduled_base; --i) {
+                m_stack.push_back(m_scheduled[i - 1]);
+            }
+            for (size_t i = m_scheduled_steps.size(); i > scheduled_steps_base;
+                 --i) {
+                m_steps.push_back(std::move(m_scheduled_steps[i - 1]));
+            }
+            m_scheduled.resize(scheduled_base);
+            m_scheduled_steps.resize(scheduled_steps_base);
+        }
+    }
+
+    // for the nodes the getters hand out as const
+    void walk(const AstNode &p_root) { walk(const_cast<AstNode &>(p_root)); }
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef VISITOR_STATIC_AST_VISITOR_H
+#define VISITOR_STATIC_AST_VISITOR_H
+
+#include "AST/ast.hpp"
+#include "visitor/AstNodeInclude.hpp"
+
+#include <utility>
+
+// Calls `p_function` with `p_node` cast to its node class, which the kind of
+// the node tells without a virtual call.
+template <typename Function>
+auto dispatchOnKind(AstNode &p_node, Function &&p_function)
+    -> decltype(p_function(std::declval<ProgramNode &>())) {
+    switch (p_node.getKind()) {
+    case AstNodeKind::kProgram:
+        return p_function(static_cast<ProgramNode &>(p_node));
+    case AstNodeKind::kDecl:
+        return p_function(static_cast<DeclNode &>(p_node));
+    case AstNodeKind::kVariable:
+        return p_function(static_cast<VariableNode &>(p_node));
+    case AstNodeKind::kConstantValue:
+        return p_function(static_cast<ConstantValueNode &>(p_node));
+    case AstNodeKind::kFunction:
+        return p_function(static_cast<FunctionNode &>(p_node));
+    case AstNodeKind::kCompoundStatement:
+        return p_function(static_cast<CompoundStatementNode &>(p_node));
+    case AstNodeKind::kPrint:
+        return p_function(static_cast<PrintNode &>(p_node));
+    case AstNodeKind::kBinaryOperator:
+        return p_function(static_cast<BinaryOperatorNode &>(p_node));
+    case AstNodeKind::kUnaryOperator:
+        return p_function(static_cast<UnaryOperatorNode &>(p_node));
+    case AstNodeKind::kFunctionInvocation:
+        return p_function(static_cast<FunctionInvocationNode &>(p_node));
+    case AstNodeKind::kVariableReference:
+        return p_function(static_cast<VariableReferenceNode &>(p_node));
+    case AstNodeKind::kAssignment:
+        return p_function(static_cast<AssignmentNode &>(p_node));
+    case AstNodeKind::kRead:
+        return p_function(static_cast<ReadNode &>(p_node));
+    case AstNodeKind::kIf:
+        return p_function(static_cast<IfNode &>(p_node));
+    case AstNodeKind::kWhile:
+        return p_function(static_cast<WhileNode &>(p_node));
+    case AstNodeKind::kFor:
+        return p_function(static_cast<ForNode &>(p_node));
+    case AstNodeKind::kReturn:
+        return p_function(static_cast<ReturnNode &>(p_node));
+    }
+    __builtin_unreachable();
+}
+
+// Dispatches on the kind of a node instead of through accept(), for the
+// passes that walk every node. `Derived` provides a visit() for each node
+// class; as it is known here, the calls are direct and can be inlined, where
+// accept() costs two virtual calls per node.
+//
+// A pass can be an AstNodeVisitor too: the visit() overrides of a final
+// class are what both kinds of dispatch end up calling.
+template <typename Derived> class StaticAstVisitor {
+  protected:
+    ~StaticAstVisitor() = default;
+
+  public:
+    void dispatch(AstNode &p_node) {
+        dispatchOnKind(p_node, [this](auto &p_node_of_kind) {
+            static_cast<Derived &>(*this).visit(p_node_of_kind);
+        });
+    }
+
+    // for the nodes the getters hand out as const
+    void dispatch(const AstNode &p_node) {
+        dispatch(const_cast<AstNode &>(p_node));
+    }
+
+    template <typename Node> void dispatchChildNodes(Node &p_node) {
+        p_node.forEachChild([this](AstNode &p_child) { dispatch(p_child); });
+    }
+};
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef VISITOR_TRAVERSAL_BENCHMARK_H
+#define VISITOR_TRAVERSAL_BENCHMARK_H
+
+class AstNode;
+
+// Walks the tree rooted at `p_root` through accept(), through
+// StaticAstVisitor and through AstWalker the same number of times, and prints
+// the time per node of each. The walks only count the nodes, so the
+// difference is the cost of the dispatch. A tree too deep to recurse into is
+// only walked by AstWalker; running this on inputs nested ten times deeper
+// each shows its time per node staying flat.
+void benchmarkTraversal(AstNode &p_root);
+
+#endif
@@ -0,0 +1,571 @@
+// Hand-written lexer for P, selected with --lexer=fast.
+//
+// It stands in for the flex scanner in scanner.l behind the same contract:
+// the same tokens with the same yylval and yylloc, yytext pointing to the
+// token, line_num, col_num and current_line kept up to date, the source and
+// token listings printed, and the pseudocomments honored. Where the rules of
+// scanner.l overlap, the longest match wins and ties go to the earlier rule,
+// as in flex; --verify-lexer checks that both agree on a source.
+//
+// Blanks, comments, identifiers and string literals are scanned 16 bytes at
+// a time with SSE2. The vector loads may read past the end of the text, into
+// the NUL padding SourceFile maps after it; NUL stops every scan. Keywords
+// are looked up in a perfect hash table.
+
+#include "parser.h"
+#include "util/SourceFile.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define MAX_ID_LENG 32
+
+extern uint32_t line_num;        /* declared in scanner.l */
+extern uint32_t col_num;         /* declared in scanner.l */
+extern const char *current_line; /* declared in scanner.l */
+extern uint32_t opt_src;         /* declared in scanner.l */
+extern uint32_t opt_tok;         /* declared in scanner.l */
+extern uint32_t opt_dmp;         /* declared in scanner.l */
+extern char *yytext;             /* declared by lex */
+
+namespace {
+
+const SourceFile *source = nullptr;
+char *cursor = nullptr;
+const char *text_end = nullptr;
+// yytext is terminated in place; the byte the NUL replaced goes back on the
+// next call
+char *held_pos = nullptr;
+char held_char = '\0';
+
+// ===========================================
+// > Character classes
+// ===========================================
+
+#ifdef __SSE2__
+
+// bit i is set if byte i of `p_v` lies in [p_low, p_low + p_span]
+inline uint32_t inRange(const __m128i p_v, const char p_low, const char p_span) {
+    const __m128i offset = _mm_sub_epi8(p_v, _mm_set1_epi8(p_low));
+    return _mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(p_span)), offset));
+}
+
+inline uint32_t equals(const __m128i p_v, const char p_c) {
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(p_v, _mm_set1_epi8(p_c)));
+}
+
+// the first byte at or after `p_pos` whose bit `p_stop_mask` sets
+template <typename StopMask>
+const char *findStop(const char *p_pos, StopMask p_stop_mask) {
+    for (;; p_pos += 16) {
+        const __m128i v =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_pos));
+        const uint32_t mask = p_stop_mask(v);
+        if (mask) {
+            return p_pos + __builtin_ctz(mask);
+        }
+    }
+}
+
+const char *skipBlanks(const char *p_pos) {
+    return findStop(p_pos, [](const __m128i p_v) {
+        return ~(equals(p_v, ' ') | equals(p_v, '\t')) & 0xffff;
+    });
+}
+
+const char *skipIdentifier(const char *p_pos) {
+    return findStop(p_pos, [](const __m128i p_v) {
+        const __m128i lower = _mm_or_si128(p_v, _mm_set1_epi8(0x20));
+        return ~(inRange(lower, 'a', 'z' - 'a') | inRange(p_v, '0', 9)) &
+               0xffff;
+    });
+}
+
+// '"', '\n' or NUL
+const char *findStringStop(const char *p_pos) {
+    return findStop(p_pos, [](const __m128i p_v) {
+        return equals(p_v, '"') | equals(p_v, '\n') | equals(p_v, '\0');
+    });
+}
+
+// '*', '\n' or NUL
+const char *findCommentStop(const char *p_pos) {
+    return findStop(p_pos, [](const __m128i p_v) {
+        return equals(p_v, '*') | equals(p_v, '\n') | equals(p_v, '\0');
+    });
+}
+
+#else
+
+const char *skipBlanks(const char *p_pos) {
+    while (*p_pos == ' ' || *p_pos == '\t') {
+        ++p_pos;
+    }
+    return p_pos;
+}
+
+const char *skipIdentifier(const char *p_pos) {
+    while (static_cast<unsigned>((*p_pos | 0x20) - 'a') <= 'z' - 'a' ||
+           static_cast<unsigned>(*p_pos - '0') <= 9) {
+        ++p_pos;
+    }
+    return p_pos;
+}
+
+const char *findStringStop(const char *p_pos) {
+    while (*p_pos != '"' && *p_pos != '\n' && *p_pos != '\0') {
+        ++p_pos;
+    }
+    return p_pos;
+}
+
+const char *findCommentStop(const char *p_pos) {
+    while (*p_pos != '*' && *p_pos != '\n' && *p_pos != '\0') {
+        ++p_pos;
+    }
+    return p_pos;
+}
+
+#endif
+
+inline bool isDigit(const char p_c) { return p_c >= '0' && p_c <= '9'; }
+
+size_t countDigits(const char *p_pos) {
+    const char *end = p_pos;
+    while (isDigit(*end)) {
+        ++end;
+    }
+    return end - p_pos;
+}
+
+// ===========================================
+// > Keywords
+// ===========================================
+
+struct Keyword {
+    const char *word;
+    uint8_t length;
+    int token;
+    // in the token listing
+    const char *name;
+};
+
+// A perfect hash of the 26 words that aren't identifiers: no two of them
+// share 5 * (first + last character) + length modulo 64.
+constexpr uint32_t kNumKeywordSlots = 64;
+
+inline uint32_t hashKeyword(const char *p_word, const size_t p_length) {
+    return (5 * (static_cast<uint8_t>(p_word[0]) +
+                 static_cast<uint8_t>(p_word[p_length - 1])) +
+            p_length) %
+           kNumKeywordSlots;
+}
+
+struct KeywordTable {
+    Keyword slots[kNumKeywordSlots] = {};
+
+    KeywordTable() {
+        static const Keyword kKeywords[] = {
+            {"mod", 3, MOD, "mod"},
+            {"and", 3, AND, "and"},
+            {"or", 2, OR, "or"},
+            {"not", 3, NOT, "not"},
+            {"var", 3, VAR, "KWvar"},
+            {"array", 5, ARRAY, "KWarray"},
+            {"of", 2, OF, "KWof"},
+            {"boolean", 7, BOOLEAN, "KWboolean"},
+            {"integer", 7, INTEGER, "KWinteger"},
+            {"real", 4, REAL, "KWreal"},
+            {"string", 6, STRING, "KWstring"},
+            {"true", 4, TRUE, "KWtrue"},
+            {"false", 5, FALSE, "KWfalse"},
+            {"def", 3, DEF, "KWdef"},
+            {"return", 6, RETURN, "KWreturn"},
+            {"begin", 5, BEGIN_, "KWbegin"},
+            {"end", 3, END, "KWend"},
+            {"while", 5, WHILE, "KWwhile"},
+            {"do", 2, DO, "KWdo"},
+            {"if", 2, IF, "KWif"},
+            {"then", 4, THEN, "KWthen"},
+            {"else", 4, ELSE, "KWelse"},
+            {"for", 3, FOR, "KWfor"},
+            {"to", 2, TO, "KWto"},
+            {"print", 5, PRINT, "KWprint"},
+            {"read", 4, READ, "KWread"},
+        };
+        for (const auto &keyword : kKeywords) {
+            slots[hashKeyword(keyword.word, keyword.length)] = keyword;
+        }
+    }
+
+    const Keyword *find(const char *p_word, const size_t p_length) const {
+        const Keyword &slot = slots[hashKeyword(p_word, p_length)];
+        if (slot.length == p_length &&
+            std::memcmp(slot.word, p_word, p_length) == 0) {
+            return &slot;
+        }
+        return nullptr;
+    }
+};
+
+const KeywordTable kKeywordTable;
+
+// ===========================================
+// > Numbers
+// ===========================================
+
+// The longest match of each number rule of scanner.l at `p_pos`, 0 if none:
+//   integer         0|[1-9][0-9]*
+//   oct_integer     0[0-7]+
+//   float           {integer}\.(0|[0-9]*[1-9])
+//   scientific      ({nonzero_integer}|{nonzero_float})[Ee][+-]?{integer}
+
+size_t matchInteger(const char *p_pos) {
+    if (*p_pos == '0') {
+        return 1;
+    }
+    return isDigit(*p_pos) ? 1 + countDigits(p_pos + 1) : 0;
+}
+
+size_t matchOctal(const char *p_pos) {
+    if (p_pos[0] != '0' || p_pos[1] < '0' || p_pos[1] > '7') {
+        return 0;
+    }
+    const char *end = p_pos + 1;
+    while (*end >= '0' && *end <= '7') {
+        ++end;
+    }
+    return end - p_pos;
+}
+
+// 0|[0-9]*[1-9]
+size_t matchFraction(const char *p_pos) {
+    size_t length = countDigits(p_pos);
+    while (length > 0 && p_pos[length - 1] == '0') {
+        --length;
+    }
+    return (length == 0 && *p_pos == '0') ? 1 : length;
+}
+
+size_t matchFloat(const char *p_pos) {
+    const size_t integral = matchInteger(p_pos);
+    if (integral == 0 || p_pos[integral] != '.') {
+        return 0;
+    }
+    const size_t fraction = matchFraction(p_pos + integral + 1);
+    return fraction ? integral + 1 + fraction : 0;
+}
+
+size_t matchScientific(const char *p_pos) {
+    // an exponent must follow the mantissa, so the mantissa takes whole
+    // runs of digits
+    size_t mantissa = 0;
+    if (*p_pos >= '1' && *p_pos <= '9') {
+        mantissa = 1 + countDigits(p_pos + 1);
+        if (p_pos[mantissa] == '.') {
+            const size_t fraction = countDigits(p_pos + mantissa + 1);
+            const char *last = p_pos + mantissa + fraction;
+            const bool valid = (fraction == 1 && *last == '0') ||
+                               (fraction > 0 && *last != '0');
+            mantissa = valid ? mantissa + 1 + fraction : 0;
+        }
+    } else if (p_pos[0] == '0' && p_pos[1] == '.') {
+        const size_t fraction = countDigits(p_pos + 2);
+        mantissa = (fraction > 0 && p_pos[1 + fraction] != '0') ? 2 + fraction
+                                                                 : 0;
+    }
+    if (mantissa == 0 || (p_pos[mantissa] != 'E' && p_pos[mantissa] != 'e')) {
+        return 0;
+    }
+
+    size_t exponent = mantissa + 1;
+    if (p_pos[exponent] == '+' || p_pos[exponent] == '-') {
+        ++exponent;
+    }
+    const size_t digits = matchInteger(p_pos + exponent);
+    return digits ? exponent + digits : 0;
+}
+
+// ===========================================
+// > Tokens
+// ===========================================
+
+void restoreHeldChar() {
+    if (held_pos) {
+        *held_pos = held_char;
+        held_pos = nullptr;
+    }
+}
+
+// what YY_USER_ACTION does for a match of `p_length` bytes at the cursor
+void match(const size_t p_length) {
+    yylloc = source->getLocation(cursor);
+    col_num += p_length;
+    cursor += p_length;
+}
+
+// points yytext to the `p_length` bytes at the cursor and moves past them
+void matchToken(const size_t p_length) {
+    yytext = cursor;
+    match(p_length);
+    held_pos = cursor;
+    held_char = *cursor;
+    *cursor = '\0';
+}
+
+int listToken(const int p_token, const char *p_name) {
+    if (opt_tok) {
+        printf("<%s>\n", p_name);
+    }
+    return p_token;
+}
+
+int listLiteral(const int p_token, const char *p_name, const char *p_literal) {
+    if (opt_tok) {
+        printf("<%s: %s>\n", p_name, p_literal);
+    }
+    return p_token;
+}
+
+int punctuation(const size_t p_length, const int p_token, const char *p_name) {
+    matchToken(p_length);
+    return listToken(p_token, p_name);
+}
+
+void newline() {
+    if (opt_src) {
+        printf("%d: %.*s\n", line_num, static_cast<int>(cursor - current_line),
+               current_line);
+    }
+    match(1);
+    ++line_num;
+    col_num = 1;
+    current_line = cursor;
+}
+
+[[noreturn]] void badCharacter() {
+    matchToken(1);
+    printf("Error at line %d: bad character \"%s\"\n", line_num, yytext);
+    exit(-1);
+}
+
+int identifier() {
+    const size_t length = skipIdentifier(cursor) - cursor;
+    const Keyword *keyword = kKeywordTable.find(cursor, length);
+    matchToken(length);
+    if (!keyword) {
+        yylval.identifier =
+            InternedString(yytext, std::min<size_t>(length, MAX_ID_LENG)).getId();
+        return listLiteral(ID, "id", yytext);
+    }
+
+    if (keyword->token == TRUE || keyword->token == FALSE) {
+        yylval.boolean = keyword->token == TRUE;
+    }
+    return listToken(keyword->token, keyword->name);
+}
+
+int number() {
+    const size_t lengths[] = {matchInteger(cursor), matchOctal(cursor),
+                              matchFloat(cursor), matchScientific(cursor)};
+    size_t rule = 0;
+    for (size_t i = 1; i < 4; ++i) {
+        if (lengths[i] > lengths[rule]) {
+            rule = i;
+        }
+    }
+
+    matchToken(lengths[rule]);
+    switch (rule) {
+    case 0:
+        yylval.integer = strtol(yytext, NULL, 10);
+        return listLiteral(INT_LITERAL, "integer", yytext);
+    case 1:
+        yylval.integer = strtol(yytext, NULL, 8);
+        return listLiteral(INT_LITERAL, "oct_integer", yytext);
+    case 2:
+        yylval.real = atof(yytext);
+        return listLiteral(REAL_LITERAL, "float", yytext);
+    default:
+        yylval.real = atof(yytext);
+        return listLiteral(REAL_LITERAL, "scientific", yytext);
+    }
+}
+
+// \"([^"\n]|\"\")*\"
+int stringLiteral() {
+    // each quote could end the literal; a second quote right after it
+    // continues the literal if more follows
+    const char *end = nullptr;
+    for (const char *pos = cursor + 1;;) {
+        const char *stop = findStringStop(pos);
+        if (*stop == '\0' && stop < text_end) {
+            pos = stop + 1;
+            continue;
+        }
+        if (*stop != '"') {
+            break;
+        }
+        end = stop + 1;
+        if (stop[1] != '"') {
+            break;
+        }
+        pos = stop + 2;
+    }
+    if (!end) {
+        badCharacter();
+    }
+
+    const size_t length = end - cursor;
+    matchToken(length);
+    // the quotes don't make it, so the literal fits in `length` bytes
+    char *string_literal = static_cast<char *>(malloc(length));
+    char *out = string_literal;
+    for (const char *in = yytext + 1; in < yytext + length - 1; ++in) {
+        *out++ = *in;
+        if (*in == '"') {
+            ++in;
+        }
+    }
+    *out = '\0';
+    yylval.string = string_literal;
+    return listLiteral(STRING_LITERAL, "string", string_literal);
+}
+
+// "//".* and the pseudocomments "//&"[STD][+-].*
+void lineComment() {
+    const char *newline = static_cast<const char *>(
+        std::memchr(cursor, '\n', text_end - cursor));
+    const size_t length = (newline ? newline : text_end) - cursor;
+
+    if (length >= 5 && cursor[2] == '&' &&
+        (cursor[4] == '+' || cursor[4] == '-')) {
+        const uint32_t value = (cursor[4] == '+') ? 1 : 0;
+        switch (cursor[3]) {
+        case 'S':
+            opt_src = value;
+            break;
+        case 'T':
+            opt_tok = value;
+            break;
+        case 'D':
+            opt_dmp = value;
+            break;
+        }
+    }
+    match(length);
+}
+
+// from "/*" to "*/" or the end of the text
+void blockComment() {
+    match(2);
+    for (;;) {
+        const char *stop = findCommentStop(cursor);
+        if (stop >= text_end) {
+            match(text_end - cursor);
+            return;
+        }
+        match(stop - cursor);
+        if (*stop == '\n') {
+            newline();
+        } else if (stop[0] == '*' && stop[1] == '/') {
+            match(2);
+            return;
+        } else {
+            match(1);
+        }
+    }
+}
+
+} // namespace
+
+void beginFastLexing(const SourceFile &p_source) {
+    source = &p_source;
+    cursor = p_source.getData();
+    text_end = p_source.getData() + p_source.getSize();
+    held_pos = nullptr;
+}
+
+int fastLex() {
+    restoreHeldChar();
+    for (;;) {
+        if (cursor >= text_end) {
+            return 0;
+        }
+
+        switch (*cursor) {
+        case ' ':
+        case '\t':
+            match(skipBlanks(cursor) - cursor);
+            break;
+        case '\n':
+            newline();
+            break;
+        case '/':
+            if (cursor[1] == '/') {
+                lineComment();
+            } else if (cursor[1] == '*') {
+                blockComment();
+            } else {
+                return punctuation(1, DIVIDE, "/");
+            }
+            break;
+        case ',':
+            return punctuation(1, COMMA, ",");
+        case ';':
+            return punctuation(1, SEMICOLON, ";");
+        case ':':
+            if (cursor[1] == '=') {
+                return punctuation(2, ASSIGN, ":=");
+            }
+            return punctuation(1, COLON, ":");
+        case '(':
+            return punctuation(1, L_PARENTHESIS, "(");
+        case ')':
+            return punctuation(1, R_PARENTHESIS, ")");
+        case '[':
+            return punctuation(1, L_BRACKET, "[");
+        case ']':
+            return punctuation(1, R_BRACKET, "]");
+        case '+':
+            return punctuation(1, PLUS, "+");
+        case '-':
+            return punctuation(1, MINUS, "-");
+        case '*':
+            return punctuation(1, MULTIPLY, "*");
+        case '<':
+            if (cursor[1] == '=') {
+                return punctuation(2, LESS_OR_EQUAL, "<=");
+            }
+            if (cursor[1] == '>') {
+                return punctuation(2, NOT_EQUAL, "<>");
+            }
+            return punctuation(1, LESS, "<");
+        case '>':
+            if (cursor[1] == '=') {
+                return punctuation(2, GREATER_OR_EQUAL, ">=");
+            }
+            return punctuation(1, GREATER, ">");
+        case '=':
+            return punctuation(1, EQUAL, "=");
+        case '"':
+            return stringLiteral();
+        default:
+            if (isDigit(*cursor)) {
+                return number();
+            }
+            if (static_cast<unsigned>((*cursor | 0x20) - 'a') <= 'z' - 'a') {
+                return identifier();
+            }
+            badCharacter();
+        }
+    }
+}
@@ -15,198 +15,200 @@ static void outputIndentationSpace(const uint32_t indentation) {
     std::printf("%*s", indentation, "");
 }
 
-void AstDumper::visit(ProgramNode &p_program) {
+bool AstDumper::enter(ProgramNode &p_program) {
     outputIndentationSpace(m_indentation);
 
+    const auto location = p_program.getLocation().decode();
     std::printf("program <line: %u, col: %u> %s %s\n",
-                p_program.getLocation().line, p_program.getLocation().col,
+                location.line, location.col,
                 p_program.getNameCString(), "void");
 
     incrementIndentation();
-    p_program.visitChildNodes(*this);
-    decrementIndentation();
+    return true;
 }
 
-void AstDumper::visit(DeclNode &p_decl) {
+bool AstDumper::enter(DeclNode &p_decl) {
     outputIndentationSpace(m_indentation);
 
-    std::printf("declaration <line: %u, col: %u>\n", p_decl.getLocation().line,
-                p_decl.getLocation().col);
+    const auto location = p_decl.getLocation().decode();
+    std::printf("declaration <line: %u, col: %u>\n", location.line,
+                location.col);
 
     incrementIndentation();
-    p_decl.visitChildNodes(*this);
-    decrementIndentation();
+    return true;
 }
 
-void AstDumper::visit(VariableNode &p_variable) {
+bool AstDumper::enter(VariableNode &p_variable) {
     outputIndentationSpace(m_indentation);
 
+    const auto location = p_variable.getLocation().decode();
     std::printf("variable <line: %u, col: %u> %s %s\n",
-                p_variable.getLocation().line, p_variable.getLocation().col,
+                location.line, location.col,
                 p_variable.getNameCString(), p_variable.getTypeCString());
 
     incrementIndentation();
-    p_variable.visitChildNodes(*this);
-    decrementIndentation();
+    return true;
 }
 
-void AstDumper::visit(ConstantValueNode &p_constant_value) {
+bool AstDumper::enter(ConstantValueNode &p_constant_value) {
     outputIndentationSpace(m_indentation);
 
+    const auto location = p_constant_value.getLocation().decode();
     std::printf("constant <line: %u, col: %u> %s\n",
-                p_constant_value.getLocation().line,
-                p_constant_value.getLocation().col,
+                location.line,
+                location.col,
                 p_constant_value.getConstantValueCString());
+    return false;
 }
 
-void AstDumper::visit(FunctionNode &p_function) {
+bool AstDumper::enter(FunctionNode &p_function) {
     outputIndentationSpace(m_indentation);
 
+    const auto location = p_function.getLocation().decode();
     std::printf("function declaration <line: %u, col: %u> %s %s\n",
-                p_function.getLocation().line, p_function.getLocation().col,
+                location.line, location.col,
                 p_function.getNameCString(), p_function.getPrototypeCString());
 
     incrementIndentation();
-    p_function.visitChildNodes(*this);
-    decrementIndentation();
+    return true;
 }
 
-void AstDumper::visit(CompoundStatementNode &p_compound_statement) {
+bool AstDumper::enter(CompoundStatementNode &p_compound_statement) {
     outputIndentationSpace(m_indentation);
 
+    const auto location = p_compound_statement.getLocation().decode();
     std::printf("compound statement <line: %u, col: %u>\n",
-                p_compound_statement.getLocation().line,
-                p_compound_statement.getLocation().col);
+                location.line,
+                location.col);
 
     incrementIndentation();
-    p_compound_statement.visitChildNodes(*this);
-    decrementIndentation();
+    return true;
 }
 
-void AstDumper::visit(PrintNode &p_print) {
+bool AstDumper::enter(PrintNode &p_print) {
     outputIndentationSpace(m_indentation);
 
+    const auto location = p_print.getLocation().decode();
     std::printf("print statement <line: %u, col: %u>\n",
-                p_print.getLocation().line, p_print.getLocation().col);
+                location.line, location.col);
 
     incrementIndentation();
-    p_print.visitChildNodes(*this);
-    decrementIndentation();
+    return true;
 }
 
-void AstDumper::visit(BinaryOperatorNode &p_bin_op) {
+bool AstDumper::enter(BinaryOperatorNode &p_bin_op) {
     outputIndentationSpace(m_indentation);
 
+    const auto location = p_bin_op.getLocation().decode();
     std::printf("binary operator <line: %u, col: %u> %s\n",
-                p_bin_op.getLocation().line, p_bin_op.getLocation().col,
+                location.line, location.col,
                 p_bin_op.getOpCString());
 
     incrementIndentation();
-    p_bin_op.visitChildNodes(*this);
-    decrementIndentation();
+    return true;
 }
 
-void AstDumper::visit(UnaryOperatorNode &p_un_op) {
+bool AstDumper::enter(UnaryOperatorNode &p_un_op) {
     outputIndentationSpace(m_indentation);
 
+    const auto location = p_un_op.getLocation().decode();
     std::printf("unary operator <line: %u, col: %u> %s\n",
-                p_un_op.getLocation().line, p_un_op.getLocation().col,
+                location.line, location.col,
                 p_un_op.getOpCString());
 
     incrementIndentation();
-    p_un_op.visitChildNodes(*this);
-    decrementIndentation();
+    return true;
 }
 
-void AstDumper::visit(FunctionInvocationNode &p_func_invocation) {
+bool AstDumper::enter(FunctionInvocationNode &p_func_invocation) {
     outputIndentationSpace(m_indentation);
 
+    const auto location = p_func_invocation.getLocation().decode();
     std::printf("function invocation <line: %u, col: %u> %s\n",
-                p_func_invocation.getLocation().line,
-                p_func_invocation.getLocation().col,
+                location.line,
+                location.col,
                 p_func_invocation.getNameCString());
 
     incrementIndentation();
-    p_func_invocation.visitChildNodes(*this);
-    decrementIndentation();
+    return true;
 }
 
-void AstDumper::visit(VariableReferenceNode &p_variable_ref) {
+bool AstDumper::enter(VariableReferenceNode &p_variable_ref) {
     outputIndentationSpace(m_indentation);
 
+    const auto location = p_variable_ref.getLocation().decode();
     std::printf("variable reference <line: %u, col: %u> %s\n",
-                p_variable_ref.getLocation().line,
-                p_variable_ref.getLocation().col,
+                location.line,
+                location.col,
                 p_variable_ref.getNameCString());
 
     incrementIndentation();
-    p_variable_ref.visitChildNodes(*this);
-    decrementIndentation();
+    return true;
 }
 
-void AstDumper::visit(AssignmentNode &p_assignment) {
+bool AstDumper::enter(AssignmentNode &p_assignment) {
     outputIndentationSpace(m_indentation);
 
+    const auto location = p_assignment.getLocation().decode();
     std::printf("assignment statement <line: %u, col: %u>\n",
-                p_assignment.getLocation().line,
-                p_assignment.getLocation().col);
+                location.line,
+                location.col);
 
     incrementIndentation();
-    p_assignment.visitChildNodes(*this);
-    decrementIndentation();
+    return true;
 }
 
-void AstDumper::visit(ReadNode &p_read) {
+bool AstDumper::enter(ReadNode &p_read) {
     outputIndentationSpace(m_indentation);
 
+    const auto location = p_read.getLocation().decode();
     std::printf("read statement <line: %u, col: %u>\n",
-                p_read.getLocation().line, p_read.getLocation().col);
+                location.line, location.col);
 
     incrementIndentation();
-    p_read.visitChildNodes(*this);
-    decrementIndentation();
+    return true;
 }
 
-void AstDumper::visit(IfNode &p_if) {
+bool AstDumper::enter(IfNode &p_if) {
     outputIndentationSpace(m_indentation);
 
-    std::printf("if statement <line: %u, col: %u>\n", p_if.getLocation().line,
-                p_if.getLocation().col);
+    const auto location = p_if.getLocation().decode();
+    std::printf("if statement <line: %u, col: %u>\n", location.line,
+                location.col);
 
     incrementIndentation();
-    p_if.visitChildNodes(*this);
-    decrementIndentation();
+    return true;
 }
 
-void AstDumper::visit(WhileNode &p_while) {
+bool AstDumper::enter(WhileNode &p_while) {
     outputIndentationSpace(m_indentation);
 
+    const auto location = p_while.getLocation().decode();
     std::printf("while statement <line: %u, col: %u>\n",
-                p_while.getLocation().line, p_while.getLocation().col);
+                location.line, location.col);
 
     incrementIndentation();
-    p_while.visitChildNodes(*this);
-    decrementIndentation();
+    return true;
 }
 
-void AstDumper::visit(ForNode &p_for) {
+bool AstDumper::enter(ForNode &p_for) {
     outputIndentationSpace(m_indentation);
 
-    std::printf("for statement <line: %u, col: %u>\n", p_for.getLocation().line,
-                p_for.getLocation().col);
+    const auto location = p_for.getLocation().decode();
+    std::printf("for statement <line: %u, col: %u>\n", location.line,
+                location.col);
 
     incrementIndentation();
-    p_for.visitChildNodes(*this);
-    decrementIndentation();
+    return true;
 }
 
-void AstDumper::visit(ReturnNode &p_return) {
+bool AstDumper::enter(ReturnNode &p_return) {
     outputIndentationSpace(m_indentation);
 
+    const auto location = p_return.getLocation().decode();
     std::printf("return statement <line: %u, col: %u>\n",
-                p_return.getLocation().line, p_return.getLocation().col);
+                location.line, location.col);
 
     incrementIndentation();
-    p_return.visitChildNodes(*this);
-    decrementIndentation();
+    return true;
 }
@@ -0,0 +1,170 @@
+#include "AST/FlatAst.hpp"
+#include "AST/PType.hpp"
+#include "visitor/AstNodeInclude.hpp"
+#include "visitor/AstWalker.hpp"
+
+constexpr FlatAst::Index FlatAst::kNoNode;
+constexpr FlatAst::TypeId FlatAst::kNoType;
+
+// Appends each node before its children, the way they are visited.
+class FlatAst::Builder final : public AstWalker<FlatAst::Builder> {
+    friend class AstWalker<Builder>;
+
+  private:
+    FlatAst &m_flat_ast;
+    // the nodes whose subtrees are being appended
+    std::vector<Index> m_open_nodes;
+    std::unordered_map<const PType *, TypeId> m_type_ids;
+
+  public:
+    ~Builder() = default;
+    explicit Builder(FlatAst &p_flat_ast) : m_flat_ast(p_flat_ast) {}
+
+  private:
+    bool enter(ProgramNode &p_program) {
+        return add(p_program, p_program.getTypePtr(),
+                   p_program.getName().getId());
+    }
+    bool enter(DeclNode &p_decl) { return add(p_decl); }
+    bool enter(VariableNode &p_variable) {
+        return add(p_variable, p_variable.getTypePtr(),
+                   p_variable.getName().getId());
+    }
+    bool enter(ConstantValueNode &p_constant_value) {
+        return add(p_constant_value, p_constant_value.getTypePtr());
+    }
+    bool enter(FunctionNode &p_function) {
+        return add(p_function, p_function.getTypePtr(),
+                   p_function.getName().getId());
+    }
+    bool enter(CompoundStatementNode &p_compound_statement) {
+        return add(p_compound_statement);
+    }
+    bool enter(PrintNode &p_print) { return add(p_print); }
+    bool enter(BinaryOperatorNode &p_bin_op) {
+        return add(p_bin_op, p_bin_op.getInferredType(),
+                   static_cast<uint32_t>(p_bin_op.getOp()));
+    }
+    bool enter(UnaryOperatorNode &p_un_op) {
+        return add(p_un_op, p_un_op.getInferredType(),
+                   static_cast<uint32_t>(p_un_op.getOp()));
+    }
+    bool enter(FunctionInvocationNode &p_func_invocation) {
+        return add(p_func_invocation, p_func_invocation.getInferredType(),
+                   p_func_invocation.getName().getId());
+    }
+    bool enter(VariableReferenceNode &p_variable_ref) {
+        return add(p_variable_ref, p_variable_ref.getInferredType(),
+                   p_variable_ref.getName().getId());
+    }
+    bool enter(AssignmentNode &p_assignment) { return add(p_assignment); }
+    bool enter(ReadNode &p_read) { return add(p_read); }
+    bool enter(IfNode &p_if) { return add(p_if); }
+    bool enter(WhileNode &p_while) { return add(p_while); }
+    bool enter(ForNode &p_for) { return add(p_for); }
+    bool enter(ReturnNode &p_return) { return add(p_return); }
+
+    template <typename Node> void leave(Node &) {
+        m_flat_ast.m_subtree_ends[m_open_nodes.back()] =
+            static_cast<Index>(m_flat_ast.m_kinds.size());
+        m_open_nodes.pop_back();
+    }
+
+    bool add(AstNode &p_node, const PType *const p_type = nullptr,
+             const uint32_t p_payload = 0) {
+        const Index parent =
+            m_open_nodes.empty() ? kNoNode : m_open_nodes.back();
+        m_open_nodes.push_back(
+            m_flat_ast.append(p_node, getTypeId(p_type), p_payload, parent));
+        return true;
+    }
+
+    TypeId getTypeId(const PType *const p_type) {
+        if (!p_type) {
+            return kNoType;
+        }
+        // types are interned, so equal types are the same object
+        const auto result = m_type_ids.emplace(
+            p_type, static_cast<TypeId>(m_flat_ast.m_type_table.size()));
+        if (result.second) {
+            m_flat_ast.m_type_table.push_back(p_type);
+        }
+        return result.first->second;
+    }
+};
+
+void FlatAst::build(ProgramNode &p_program) {
+    clear();
+    m_type_table.push_back(nullptr);
+
+    Builder builder(*this);
+    builder.walk(p_program);
+
+    // Children come after their parent and in visiting order, so bucketing
+    // them by parent in index order keeps each operand list in order.
+    const Index num_nodes = static_cast<Index>(size());
+    m_operand_begins.assign(num_nodes + 1, 0);
+    for (Index node = 1; node < num_nodes; ++node) {
+        ++m_operand_begins[m_parents[node] + 1];
+    }
+    for (Index node = 0; node < num_nodes; ++node) {
+        m_operand_begins[node + 1] += m_operand_begins[node];
+    }
+
+    m_operands.resize(num_nodes ? num_nodes - 1 : 0);
+    std::vector<Index> next(m_operand_begins.begin(), m_operand_begins.end() - 1);
+    for (Index node = 1; node < num_nodes; ++node) {
+        m_operands[next[m_parents[node]]++] = node;
+    }
+}
+
+void FlatAst::clear() {
+    m_kinds.clear();
+    m_locations.clear();
+    m_types.clear();
+    m_payloads.clear();
+    m_parents.clear();
+    m_subtree_ends.clear();
+    m_operand_begins.clear();
+    m_operands.clear();
+    m_type_table.clear();
+    m_nodes.clear();
+    m_node_indices.clear();
+}
+
+FlatAst::Index FlatAst::append(AstNode &p_node, const TypeId p_type,
+                               const uint32_t p_payload, const Index p_parent) {
+    const auto index = static_cast<Index>(m_kinds.size());
+    m_kinds.push_back(p_node.getKind());
+    m_locations.push_back(p_node.getLocation());
+    m_types.push_back(p_type);
+    m_payloads.push_back(p_payload);
+    m_parents.push_back(p_parent);
+    m_subtree_ends.push_back(index + 1);
+    m_nodes.push_back(&p_node);
+    // a shared initializer keeps the index it was first seen at
+    m_node_indices.emplace(&p_node, index);
+    return index;
+}
+
+InternedString FlatAst::getName(const Index p_node) const {
+    switch (m_kinds[p_node]) {
+    case Kind::kProgram:
+    case Kind::kVariable:
+    case Kind::kFunction:
+    case Kind::kFunctionInvocation:
+    case Kind::kVariableReference:
+        return InternedString::fromId(m_payloads[p_node]);
+    default:
+        return InternedString();
+    }
+}
+
+FlatAst::Index FlatAst::indexOf(const AstNode &p_node) const {
+    const auto it = m_node_indices.find(&p_node);
+    return it == m_node_indices.end() ? kNoNode : it->second;
+}
+
+void FlatAst::accept(const Index p_node, AstNodeVisitor &p_visitor) const {
+    m_nodes[p_node]->accept(p_visitor);
+}
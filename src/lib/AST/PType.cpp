@@ -1,41 +1,23 @@
 #include "AST/PType.hpp"
 
 #include <cassert>
+#include <string>
 
 const char *kTypeString[] = {"void", "integer", "real", "boolean", "string"};
 
-// logical constness
-const char *PType::getPTypeCString() const {
-    if (!m_type_string_is_valid) {
-        m_type_string += kTypeString[static_cast<size_t>(m_type)];
+PType::PType(Arena &p_arena, const PrimitiveTypeEnum type,
+             const uint64_t *p_dims_begin, const uint64_t *p_dims_end)
+    : m_type(type), m_dimensions(p_dims_begin, p_dims_end, p_arena),
+      m_type_string(kTypeString[static_cast<size_t>(type)], p_arena) {
+    if (m_dimensions.size() != 0) {
+        m_type_string += " ";
 
-        if (m_dimensions.size() != 0) {
-            m_type_string += " ";
-
-            for (const auto &dim : m_dimensions) {
-                m_type_string += "[" + std::to_string(dim) + "]";
-            }
+        for (const auto &dim : m_dimensions) {
+            m_type_string += "[";
+            m_type_string += std::to_string(dim).c_str();
+            m_type_string += "]";
         }
-        m_type_string_is_valid = true;
     }
-
-    return m_type_string.c_str();
-}
-
-PType *PType::getStructElementType(const std::size_t nth) const {
-    if (nth > m_dimensions.size()) {
-        return nullptr;
-    }
-
-    auto *type_ptr = new PType(m_type);
-
-    std::vector<uint64_t> dims;
-    for (std::size_t i = nth; i < m_dimensions.size(); ++i) {
-        dims.emplace_back(m_dimensions[i]);
-    }
-    type_ptr->setDimensions(dims);
-
-    return type_ptr;
 }
 
 bool PType::compare(const PType *p_type) const {
@@ -62,6 +44,11 @@ bool PType::compare(const PType *p_type) const {
         return false;
     }
 
+    // interned, so the same dimensions and primitive type are the same object
+    if (p_type == this) {
+        return true;
+    }
+
     // dimensions comparison
     auto &dimensions = p_type->getDimensions();
     if (m_dimensions.size() != dimensions.size()) {
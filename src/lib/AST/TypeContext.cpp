@@ -0,0 +1,60 @@
+#include "AST/TypeContext.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+constexpr size_t TypeContext::kNumPrimitiveTypes;
+
+size_t TypeContext::KeyHash::operator()(const Key &p_key) const {
+    size_t hash = static_cast<size_t>(p_key.primitive);
+    for (const uint64_t *dim = p_key.dims_begin; dim != p_key.dims_end; ++dim) {
+        hash = hash * 31 + std::hash<uint64_t>()(*dim);
+    }
+    return hash;
+}
+
+bool TypeContext::KeyEqual::operator()(const Key &p_a, const Key &p_b) const {
+    return p_a.primitive == p_b.primitive &&
+           p_a.dims_end - p_a.dims_begin == p_b.dims_end - p_b.dims_begin &&
+           std::equal(p_a.dims_begin, p_a.dims_end, p_b.dims_begin);
+}
+
+const PType *TypeContext::getArrayType(const PType::PrimitiveTypeEnum p_primitive,
+                                       const uint64_t *p_dims_begin,
+                                       const uint64_t *p_dims_end) {
+    if (p_dims_begin == p_dims_end) {
+        return getType(p_primitive);
+    }
+
+    const auto it =
+        m_array_types.find(Key{p_primitive, p_dims_begin, p_dims_end, nullptr});
+    if (it != m_array_types.end()) {
+        return it->type;
+    }
+
+    const auto *const type =
+        m_arena.create<PType>(m_arena, p_primitive, p_dims_begin, p_dims_end);
+    const auto &dims = type->getDimensions();
+    m_array_types.insert(
+        Key{p_primitive, dims.data(), dims.data() + dims.size(), type});
+    return type;
+}
+
+const PType *TypeContext::getElementType(const PType *p_type,
+                                         const size_t p_num_indices) {
+    const auto &dims = p_type->getDimensions();
+    if (p_num_indices > dims.size()) {
+        return nullptr;
+    }
+    if (p_num_indices == 0) {
+        return p_type;
+    }
+    return getArrayType(p_type->getPrimitiveType(),
+                        dims.data() + p_num_indices, dims.data() + dims.size());
+}
+
+void TypeContext::clear() {
+    std::fill(std::begin(m_scalar_types), std::end(m_scalar_types), nullptr);
+    m_array_types.clear();
+}
@@ -1,7 +1,5 @@
 #include "AST/UnaryOperator.hpp"
 
 void UnaryOperatorNode::visitChildNodes(AstNodeVisitor &p_visitor) {
-    auto visit_ast_node = [&](auto &ast_node) { ast_node->accept(p_visitor); };
-
-    visit_ast_node(m_operand);
+    forEachChild([&](AstNode &p_child) { p_child.accept(p_visitor); });
 }
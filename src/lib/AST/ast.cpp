@@ -3,7 +3,7 @@
 // prevent the linker from complaining
 AstNode::~AstNode() {}
 
-AstNode::AstNode(const uint32_t line, const uint32_t col)
-    : location(line, col) {}
+AstNode::AstNode(const AstNodeKind p_kind, const Location p_location)
+    : location(p_location), m_kind(p_kind) {}
 
-const Location &AstNode::getLocation() const { return location; }
+Location AstNode::getLocation() const { return location; }
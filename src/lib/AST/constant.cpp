@@ -1,5 +1,7 @@
 #include "AST/constant.hpp"
 
+#include <string>
+
 static const char *kTFString[] = {"false", "true"};
 
 // logical constness
@@ -7,10 +9,10 @@ const char *Constant::getConstantValueCString() const {
     if (!m_constant_value_string_is_valid) {
         switch (m_type->getPrimitiveType()) {
         case PType::PrimitiveTypeEnum::kIntegerType:
-            m_constant_value_string = std::to_string(m_value.integer);
+            m_constant_value_string = std::to_string(m_value.integer).c_str();
             break;
         case PType::PrimitiveTypeEnum::kRealType:
-            m_constant_value_string = std::to_string(m_value.real);
+            m_constant_value_string = std::to_string(m_value.real).c_str();
             break;
         case PType::PrimitiveTypeEnum::kBoolType:
             m_constant_value_string = kTFString[m_value.boolean];
@@ -16,7 +16,7 @@ const ConstantValueNode &ForNode::getLowerBound() const
 const ConstantValueNode &ForNode::getUpperBound() const
 {
     const auto *const upper_ptr =
-        dynamic_cast<const ConstantValueNode *>(m_end_condition.get());
+        dynamic_cast<const ConstantValueNode *>(m_end_condition);
 
     assert(upper_ptr && "Shouldn't reach here since the syntax has "
                         "ensured that it will be a constant value");
@@ -24,17 +24,14 @@ const ConstantValueNode &ForNode::getUpperBound() const
     return *upper_ptr;
 }
 
-std::string ForNode::getLoopVarName() const
+InternedString ForNode::getLoopVarName() const
 {
     return m_loop_var_decl->getVariables()[0]->getName();
 }
 
 void ForNode::visitChildNodes(AstNodeVisitor &p_visitor)
 {
-    m_loop_var_decl->accept(p_visitor);
-    m_init_stmt->accept(p_visitor);
-    m_end_condition->accept(p_visitor);
-    m_body->accept(p_visitor);
+    forEachChild([&](AstNode &p_child) { p_child.accept(p_visitor); });
 }
 
 void ForNode::visitLoopVarInitNodes(AstNodeVisitor &p_visitor)
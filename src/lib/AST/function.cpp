@@ -1,8 +1,6 @@
 #include "AST/function.hpp"
 #include "AST/decl.hpp"
 
-#include <algorithm>
-
 FunctionNode::DeclNodes::size_type
 FunctionNode::getParametersNum(const DeclNodes &p_parameters) {
     FunctionNode::DeclNodes::size_type num = 0;
@@ -37,7 +35,7 @@ const char *FunctionNode::getPrototypeCString() const {
         m_prototype_string = m_ret_type->getPTypeCString();
 
         m_prototype_string += " (";
-        m_prototype_string += getParametersTypeString(m_parameters);
+        m_prototype_string += getParametersTypeString(m_parameters).c_str();
         m_prototype_string += ")";
 
         m_prototype_string_is_valid = true;
@@ -47,17 +45,23 @@ const char *FunctionNode::getPrototypeCString() const {
 }
 
 void FunctionNode::visitChildNodes(AstNodeVisitor &p_visitor) {
-    auto visit_ast_node = [&](auto &ast_node) { ast_node->accept(p_visitor); };
-
-    for_each(m_parameters.begin(), m_parameters.end(), visit_ast_node);
+    forEachChild([&](AstNode &p_child) { p_child.accept(p_visitor); });
+}
 
+void FunctionNode::visitBodyChildNodes(AstNodeVisitor &p_visitor) {
     if (m_body) {
-        visit_ast_node(m_body);
+        m_body->visitChildNodes(p_visitor);
     }
 }
 
-void FunctionNode::visitBodyChildNodes(AstNodeVisitor &p_visitor) {
+void FunctionNode::visitParameterNodes(AstNodeVisitor &p_visitor) {
+    for (auto &parameter : m_parameters) {
+        parameter->accept(p_visitor);
+    }
+}
+
+void FunctionNode::visitBodyNode(AstNodeVisitor &p_visitor) {
     if (m_body) {
-        m_body->visitChildNodes(p_visitor);
+        m_body->accept(p_visitor);
     }
 }
@@ -2,12 +2,7 @@
 
 void IfNode::visitChildNodes(AstNodeVisitor &p_visitor)
 {
-    m_condition->accept(p_visitor);
-    m_body->accept(p_visitor);
-    if (m_else_body)
-    {
-        m_else_body->accept(p_visitor);
-    }
+    forEachChild([&](AstNode &p_child) { p_child.accept(p_visitor); });
 }
 
 void IfNode::visitExpressionNode(AstNodeVisitor &p_visitor)
@@ -0,0 +1,57 @@
+#include "codegen/BranchProfile.hpp"
+#include "visitor/AstNodeInclude.hpp"
+
+#include <cstdio>
+
+bool BranchProfile::load(const std::string &p_path)
+{
+    FILE *file = fopen(p_path.c_str(), "r");
+    if (!file)
+        return false;
+
+    unsigned num_sites = 0;
+    bool ok = fscanf(file, "pprof %u", &num_sites) == 1;
+    for (unsigned i = 0; ok && i < num_sites; ++i)
+    {
+        Site site;
+        ok = fscanf(file, "%u %u", &site.executed, &site.taken) == 2 &&
+             site.taken <= site.executed;
+        m_sites.emplace_back(site);
+    }
+    fclose(file);
+
+    if (!ok)
+        m_sites.clear();
+    m_loaded = ok;
+    return ok;
+}
+
+const BranchProfile::Site *BranchProfile::getSite(const uint32_t p_site) const
+{
+    if (p_site >= m_sites.size())
+        return nullptr;
+    return &m_sites[p_site];
+}
+
+uint32_t BranchSiteNumbering::getSite(const AstNode &p_statement) const
+{
+    return m_sites.at(&p_statement);
+}
+
+bool BranchSiteNumbering::enter(IfNode &p_if)
+{
+    m_sites.emplace(&p_if, m_sites.size());
+    return true;
+}
+
+bool BranchSiteNumbering::enter(WhileNode &p_while)
+{
+    m_sites.emplace(&p_while, m_sites.size());
+    return true;
+}
+
+bool BranchSiteNumbering::enter(ForNode &p_for)
+{
+    m_sites.emplace(&p_for, m_sites.size());
+    return true;
+}
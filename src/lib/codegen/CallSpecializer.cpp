@@ -0,0 +1,282 @@
+#include "codegen/CallSpecializer.hpp"
+#include "codegen/ConstantFolder.hpp"
+#include "sema/SymbolTable.hpp"
+#include "visitor/AstNodeInclude.hpp"
+
+#include <algorithm>
+
+// the argument registers; functions taking more keep their signature
+static constexpr uint32_t kMaxSpecializedParams = 8;
+// lower bound of the growth budget, so that small programs get a clone too
+static constexpr uint32_t kMinGrowthNodes = 64;
+
+uint32_t Specialization::getNumParams() const
+{
+    return std::count(bound.begin(), bound.end(), false);
+}
+
+uint32_t Specialization::getArgumentIndex(const uint32_t p_param) const
+{
+    return std::count(bound.begin(), bound.begin() + p_param, false);
+}
+
+void CallSpecializer::run(ProgramNode &p_program, const uint32_t p_growth_percent)
+{
+    walk(p_program);
+    selectClones(p_growth_percent);
+}
+
+const Specialization *
+CallSpecializer::getSpecialization(const FunctionInvocationNode &p_call) const
+{
+    auto found = m_site_clones.find(&p_call);
+    return found == m_site_clones.end() ? nullptr : found->second;
+}
+
+void CallSpecializer::selectClones(const uint32_t p_growth_percent)
+{
+    struct Candidate
+    {
+        FunctionInfo *callee;
+        std::vector<bool> bound;
+        std::vector<int32_t> values;
+        std::vector<const FunctionInvocationNode *> sites;
+        uint32_t loop_depth = 0;
+    };
+    std::vector<Candidate> candidates;
+
+    for (const auto &site : m_call_sites)
+    {
+        auto callee = m_functions.find(site.node->getName());
+        if (callee == m_functions.end())
+            continue;
+        auto &info = callee->second;
+        if (!info.node->hasBody() || info.params.size() > kMaxSpecializedParams ||
+            info.params.size() != site.known.size())
+            continue;
+
+        // only parameters that decide branches are worth a clone
+        std::vector<bool> bound(info.params.size(), false);
+        std::vector<int32_t> values(info.params.size(), 0);
+        bool any_bound = false;
+        for (uint32_t i = 0; i < info.params.size(); ++i)
+        {
+            if (site.known[i] && !info.assigned[i] && info.in_condition[i])
+            {
+                bound[i] = true;
+                values[i] = site.values[i];
+                any_bound = true;
+            }
+        }
+        if (!any_bound)
+            continue;
+
+        auto same_clone = [&](const Candidate &p_candidate) {
+            return p_candidate.callee == &info && p_candidate.bound == bound &&
+                   p_candidate.values == values;
+        };
+        auto existing = std::find_if(candidates.begin(), candidates.end(), same_clone);
+        if (existing == candidates.end())
+        {
+            candidates.push_back(Candidate{&info, bound, values, {}, 0});
+            existing = candidates.end() - 1;
+        }
+        existing->sites.emplace_back(site.node);
+        existing->loop_depth = std::max(existing->loop_depth, site.loop_depth);
+    }
+
+    // calls in loops first, then the clones that serve more calls, then the
+    // cheaper ones
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const Candidate &p_a, const Candidate &p_b) {
+                         if (p_a.loop_depth != p_b.loop_depth)
+                             return p_a.loop_depth > p_b.loop_depth;
+                         if (p_a.sites.size() != p_b.sites.size())
+                             return p_a.sites.size() > p_b.sites.size();
+                         return p_a.callee->size < p_b.callee->size;
+                     });
+
+    uint32_t total_size = 0;
+    for (const auto &function : m_functions)
+        total_size += function.second.size;
+    uint32_t budget =
+        std::max(total_size * p_growth_percent / 100, kMinGrowthNodes);
+
+    std::map<const FunctionInfo *, uint32_t> num_clones;
+    for (const auto &candidate : candidates)
+    {
+        if (candidate.callee->size > budget)
+            continue;
+        budget -= candidate.callee->size;
+
+        auto *clone = new Specialization{
+            candidate.callee->node,
+            candidate.callee->node->getName().str() + ".constprop." +
+                std::to_string(num_clones[candidate.callee]++),
+            candidate.bound, candidate.values};
+        m_specializations.emplace_back(clone);
+        for (const auto *site : candidate.sites)
+            m_site_clones[site] = clone;
+    }
+}
+
+int CallSpecializer::findParam(const SymbolEntry *p_entry) const
+{
+    if (!m_current_function)
+        return -1;
+    const auto &params = m_current_function->params;
+    auto found = std::find(params.begin(), params.end(), p_entry);
+    return found == params.end() ? -1 : found - params.begin();
+}
+
+void CallSpecializer::markAssigned(const VariableReferenceNode &p_target)
+{
+    const int param = findParam(m_symbol_manager_ptr->lookup(p_target.getName()));
+    if (param >= 0)
+        m_current_function->assigned[param] = true;
+}
+
+bool CallSpecializer::enter(ProgramNode &p_program)
+{
+    m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(p_program.getSymbolTable());
+    return true;
+}
+
+void CallSpecializer::leave(ProgramNode &p_program)
+{
+    m_symbol_manager_ptr->removeSymbolsFromHashTable(p_program.getSymbolTable());
+}
+
+bool CallSpecializer::enter(FunctionNode &p_function)
+{
+    auto &info = m_functions[p_function.getName()];
+    info.node = &p_function;
+    if (p_function.getSymbolTable())
+    {
+        for (const auto &entry : p_function.getSymbolTable()->getEntries())
+        {
+            if (entry->getKind() == SymbolEntry::KindEnum::kParameterKind)
+                info.params.emplace_back(entry.get());
+        }
+    }
+    info.assigned.assign(info.params.size(), false);
+    info.in_condition.assign(info.params.size(), false);
+
+    m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(p_function.getSymbolTable());
+    m_current_function = &info;
+    m_function_first_node = m_num_nodes;
+    return true;
+}
+
+void CallSpecializer::leave(FunctionNode &p_function)
+{
+    m_current_function->size = m_num_nodes - m_function_first_node;
+    m_current_function = nullptr;
+    m_symbol_manager_ptr->removeSymbolsFromHashTable(p_function.getSymbolTable());
+}
+
+bool CallSpecializer::enter(CompoundStatementNode &p_compound_statement)
+{
+    ++m_num_nodes;
+    m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+        p_compound_statement.getSymbolTable());
+    return true;
+}
+
+void CallSpecializer::leave(CompoundStatementNode &p_compound_statement)
+{
+    m_symbol_manager_ptr->removeSymbolsFromHashTable(
+        p_compound_statement.getSymbolTable());
+}
+
+bool CallSpecializer::enter(FunctionInvocationNode &)
+{
+    ++m_num_nodes;
+    // the arguments aren't conditions of the caller
+    m_outer_in_condition.push_back(m_in_condition);
+    m_in_condition = false;
+    return true;
+}
+
+void CallSpecializer::leave(FunctionInvocationNode &p_func_invocation)
+{
+    m_in_condition = m_outer_in_condition.back();
+    m_outer_in_condition.pop_back();
+
+    const ConstantFolder::Bindings no_bindings;
+    ConstantFolder folder(m_symbol_manager_ptr, no_bindings);
+
+    CallSite site{&p_func_invocation, m_loop_depth, {}, {}};
+    for (const auto &arg : p_func_invocation.getArguments())
+    {
+        int32_t value = 0;
+        site.known.push_back(folder.evaluate(*arg, value));
+        site.values.push_back(value);
+    }
+    m_call_sites.emplace_back(std::move(site));
+}
+
+bool CallSpecializer::enter(VariableReferenceNode &p_variable_ref)
+{
+    ++m_num_nodes;
+    if (m_in_condition)
+    {
+        const int param =
+            findParam(m_symbol_manager_ptr->lookup(p_variable_ref.getName()));
+        if (param >= 0)
+            m_current_function->in_condition[param] = true;
+    }
+    return true;
+}
+
+bool CallSpecializer::enter(AssignmentNode &p_assignment)
+{
+    ++m_num_nodes;
+    markAssigned(p_assignment.getLvalue());
+    return true;
+}
+
+bool CallSpecializer::enter(ReadNode &p_read)
+{
+    ++m_num_nodes;
+    markAssigned(p_read.getTarget());
+    return true;
+}
+
+bool CallSpecializer::enter(IfNode &p_if)
+{
+    ++m_num_nodes;
+    m_in_condition = true;
+    schedule(p_if.getCondition());
+    schedule([this] { m_in_condition = false; });
+    schedule(p_if.getBody());
+    if (p_if.getElseBody())
+        schedule(*p_if.getElseBody());
+    return false;
+}
+
+bool CallSpecializer::enter(WhileNode &p_while)
+{
+    ++m_num_nodes;
+    ++m_loop_depth;
+    m_in_condition = true;
+    schedule(p_while.getCondition());
+    schedule([this] { m_in_condition = false; });
+    schedule(p_while.getBody());
+    schedule([this] { --m_loop_depth; });
+    return false;
+}
+
+bool CallSpecializer::enter(ForNode &p_for)
+{
+    ++m_num_nodes;
+    m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(p_for.getSymbolTable());
+    ++m_loop_depth;
+    return true;
+}
+
+void CallSpecializer::leave(ForNode &p_for)
+{
+    --m_loop_depth;
+    m_symbol_manager_ptr->removeSymbolsFromHashTable(p_for.getSymbolTable());
+}
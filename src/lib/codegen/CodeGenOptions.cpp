@@ -0,0 +1,194 @@
+#include "codegen/CodeGenOptions.hpp"
+#include "codegen/MachinePasses.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <string>
+
+bool CodeGenOptions::parse(const char *p_arg)
+{
+    if (strcmp(p_arg, "-Os") == 0)
+    {
+        optimize_size = true;
+        compressed = true;
+        merge_functions = true;
+        outline = true;
+        shrink_wrap = true;
+        size_report = true;
+        return true;
+    }
+    if (strcmp(p_arg, "-mrvc") == 0)
+    {
+        compressed = true;
+        return true;
+    }
+    if (strcmp(p_arg, "-fmerge-functions") == 0)
+    {
+        merge_functions = true;
+        return true;
+    }
+    if (strcmp(p_arg, "-moutline") == 0)
+    {
+        outline = true;
+        return true;
+    }
+    if (strcmp(p_arg, "-fshrink-wrap") == 0)
+    {
+        shrink_wrap = true;
+        return true;
+    }
+    if (strcmp(p_arg, "-fspecialize") == 0)
+    {
+        specialize = true;
+        return true;
+    }
+    if (strncmp(p_arg, "-fspecialize=", 13) == 0)
+    {
+        char *end = nullptr;
+        specialize = true;
+        specialize_growth = strtoul(p_arg + 13, &end, 10);
+        return end != p_arg + 13 && *end == '\0';
+    }
+    if (strcmp(p_arg, "-ffold-pure-calls") == 0)
+    {
+        fold_pure_calls = true;
+        return true;
+    }
+    if (strcmp(p_arg, "-fscev") == 0)
+    {
+        scalar_evolution = true;
+        return true;
+    }
+    if (strcmp(p_arg, "-fmemoize") == 0)
+    {
+        memoize = true;
+        return true;
+    }
+    if (strncmp(p_arg, "-fmemoize=", 10) == 0)
+    {
+        char *end = nullptr;
+        memoize = true;
+        const unsigned long entries = strtoul(p_arg + 10, &end, 10);
+        if (end == p_arg + 10 || *end != '\0' || entries == 0 ||
+            (entries & (entries - 1)) != 0)
+            return false;
+        if (entries > kMaxMemoizeEntries)
+        {
+            fprintf(stderr, "-fmemoize: a cache holds at most %u entries\n",
+                    kMaxMemoizeEntries);
+            return false;
+        }
+        memoize_entries = entries;
+        return true;
+    }
+    if (strcmp(p_arg, "-fmemoize-stats") == 0)
+    {
+        memoize = true;
+        memoize_stats = true;
+        return true;
+    }
+    if (strcmp(p_arg, "-fif-conversion") == 0)
+    {
+        if_conversion = true;
+        return true;
+    }
+    if (strncmp(p_arg, "-march=", 7) == 0)
+    {
+        return parseMarch(p_arg + 7);
+    }
+    if (strcmp(p_arg, "-fipra") == 0)
+    {
+        ipra = true;
+        return true;
+    }
+    if (strncmp(p_arg, "-mtune=", 7) == 0)
+    {
+        sched_model = findSchedModel(p_arg + 7);
+        return sched_model != nullptr;
+    }
+    if (strcmp(p_arg, "-fschedule-insns") == 0)
+    {
+        if (!sched_model)
+            sched_model = findSchedModel("generic");
+        return true;
+    }
+    if (strcmp(p_arg, "-fprofile-generate") == 0)
+    {
+        profile_generate = true;
+        return true;
+    }
+    if (strncmp(p_arg, "-fprofile-generate=", 19) == 0)
+    {
+        profile_generate = true;
+        profile_generate_path = p_arg + 19;
+        return !profile_generate_path.empty();
+    }
+    if (strncmp(p_arg, "-fprofile-use=", 14) == 0)
+    {
+        profile_use_path = p_arg + 14;
+        return !profile_use_path.empty();
+    }
+    if (strcmp(p_arg, "-fsize-report") == 0)
+    {
+        size_report = true;
+        return true;
+    }
+    return false;
+}
+
+void CodeGenOptions::finalize()
+{
+    // -Os and -mrvc come before or after -march
+    compressed = compressed && ext_c;
+}
+
+bool CodeGenOptions::parseMarch(const char *p_isa)
+{
+    static const std::set<std::string> kMultiLetterExtensions = {
+        "zba", "zbb", "zbc", "zbs", "zicond", "zicsr", "zifencei", "zmmul"};
+
+    // rv32 followed by the base ISA and single-letter extensions, then
+    // multi-letter extensions separated by underscores. RV32E is rejected:
+    // the code generator uses t3 and a6-a7, which it doesn't have.
+    const std::string isa = p_isa;
+    if (isa.compare(0, 4, "rv32") != 0 || isa.size() < 5 ||
+        (isa[4] != 'i' && isa[4] != 'g'))
+        return false;
+
+    std::set<std::string> extensions;
+    if (isa[4] == 'g')
+        extensions = {"m", "a", "f", "d", "zicsr", "zifencei"};
+    size_t pos = 5;
+    while (pos < isa.size() && isa[pos] != '_')
+    {
+        if (!strchr("mafdcbv", isa[pos]))
+            return false;
+        if (isa[pos] == 'b')
+            extensions.insert({"zba", "zbb", "zbs"});
+        extensions.insert(isa.substr(pos++, 1));
+    }
+    while (pos < isa.size())
+    {
+        const size_t end = std::min(isa.find('_', pos + 1), isa.size());
+        const std::string extension = isa.substr(pos + 1, end - pos - 1);
+        if (!kMultiLetterExtensions.count(extension))
+            return false;
+        extensions.insert(extension);
+        pos = end;
+    }
+
+    march = isa;
+    ext_m = extensions.count("m") != 0;
+    zmmul = extensions.count("zmmul") != 0;
+    ext_c = extensions.count("c") != 0;
+    ext_f = extensions.count("f") != 0;
+    ext_d = extensions.count("d") != 0;
+    ext_v = extensions.count("v") != 0;
+    zba = extensions.count("zba") != 0;
+    zbb = extensions.count("zbb") != 0;
+    zicond = extensions.count("zicond") != 0;
+    return true;
+}
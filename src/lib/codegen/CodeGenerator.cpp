@@ -1,4 +1,6 @@
 #include "codegen/CodeGenerator.hpp"
+#include "codegen/FrameLayout.hpp"
+#include "codegen/MachinePasses.hpp"
 #include "visitor/AstNodeInclude.hpp"
 
 #include <map>
@@ -10,9 +12,11 @@
 
 CodeGenerator::CodeGenerator(const std::string &source_file_name,
                              const std::string &save_path,
-                             const SymbolManager *const p_symbol_manager)
+                             const SymbolManager *const p_symbol_manager,
+                             const CodeGenOptions &p_options)
     : m_symbol_manager_ptr(p_symbol_manager),
-      m_source_file_path(source_file_name)
+      m_source_file_path(source_file_name), m_options(p_options),
+      m_specializer(p_symbol_manager), m_pure_calls(p_symbol_manager)
 {
     // FIXME: assume that the source file is always xxxx.p
     const auto &real_path =
@@ -33,17 +37,764 @@ CodeGenerator::CodeGenerator(const std::string &source_file_name,
         source_file_name.substr(slash_pos, dot_pos - slash_pos) + ".S"};
     m_output_file.reset(fopen(output_file_path.c_str(), "w"));
     assert(m_output_file.get() && "Failed to open output file");
+
+    if (m_options.profile_generate)
+    {
+        m_profile_generate_path =
+            m_options.profile_generate_path.empty()
+                ? source_file_name.substr(slash_pos, dot_pos - slash_pos) + ".prof"
+                : m_options.profile_generate_path;
+    }
+    if (!m_options.profile_use_path.empty() &&
+        !m_profile.load(m_options.profile_use_path))
+    {
+        fprintf(stderr, "warning: cannot read profile '%s', ignored\n",
+                m_options.profile_use_path.c_str());
+    }
 }
 
-static void dumpInstructions(FILE *p_out_file, const char *format, ...)
+static void dumpInstructions(std::string &p_buffer, const char *format, ...)
 {
     va_list args;
     va_start(args, format);
-    vfprintf(p_out_file, format, args);
+    va_list args_copy;
+    va_copy(args_copy, args);
+    const int length = vsnprintf(nullptr, 0, format, args_copy);
+    va_end(args_copy);
+
+    const auto old_size = p_buffer.size();
+    p_buffer.resize(old_size + length + 1);
+    vsnprintf(&p_buffer[old_size], length + 1, format, args);
+    p_buffer.resize(old_size + length);
     va_end(args);
 }
 
-void CodeGenerator::visit(ProgramNode &p_program)
+void CodeGenerator::beginFunction()
+{
+    // everything before the first function is file prologue or global data
+    m_module.appendHeader(m_asm_buffer);
+    m_asm_buffer.clear();
+}
+
+void CodeGenerator::emitReturnBlock()
+{
+    // a return that ends the body just falls through into the epilogue
+    if (m_return_jump_end == m_asm_buffer.size())
+    {
+        m_asm_buffer.erase(m_asm_buffer.rfind("    j L"));
+        m_return_jumps--;
+    }
+    if (m_return_jumps > 0)
+    {
+        dumpInstructions(m_asm_buffer, "L%d:\n", m_return_label);
+    }
+
+    m_return_label = -1;
+    m_return_jumps = 0;
+    m_return_jump_end = std::string::npos;
+}
+
+void CodeGenerator::endFunction(const std::string &p_name,
+                                const uint32_t p_num_params,
+                                const bool p_exported)
+{
+    if (!m_cold_buffer.empty())
+    {
+        constexpr const char *const emit_cold_section =
+            ".section    .text.unlikely\n"
+            "    .align 2\n"
+            "    .type %s.cold, @function\n"
+            "%s.cold:\n";
+
+        dumpInstructions(m_asm_buffer, emit_cold_section, p_name.c_str(),
+                         p_name.c_str());
+        m_asm_buffer += m_cold_buffer;
+        dumpInstructions(m_asm_buffer, "    .size %s.cold, .-%s.cold\n",
+                         p_name.c_str(), p_name.c_str());
+        m_cold_buffer.clear();
+    }
+
+    auto *function = new MachineFunction(p_name, m_asm_buffer);
+    function->setNumParams(p_num_params);
+    function->setExported(p_exported);
+    m_asm_buffer.clear();
+
+    m_original_code_size[p_name] = function->getCodeSize(false);
+    m_module.addFunction(function);
+}
+
+void CodeGenerator::runMachinePasses()
+{
+    for (auto &function : m_module.getFunctions())
+    {
+        // matches the frame as the templates emit it
+        shrinkWrapFunction(*function, m_options);
+        compressFunction(*function, m_options);
+    }
+    // registers are final once compressFunction has renamed them; the
+    // arguments must still be popped in the order the templates emit them
+    allocateInterprocedural(m_module, m_options);
+    for (auto &function : m_module.getFunctions())
+    {
+        scheduleFunction(*function, m_options);
+    }
+    // merge before outlining so that duplicated bodies aren't outlined twice
+    mergeIdenticalFunctions(m_module, m_options);
+    outlineModule(m_module, m_options);
+}
+
+// ===========================================
+// > Call-site specialization
+// ===========================================
+
+void CodeGenerator::bindParams(const Specialization &p_clone)
+{
+    uint32_t param = 0;
+    for (const auto &entry : p_clone.function->getSymbolTable()->getEntries())
+    {
+        if (entry->getKind() != SymbolEntry::KindEnum::kParameterKind)
+            continue;
+        if (p_clone.bound[param])
+            m_constant_params.emplace(entry.get(), p_clone.values[param]);
+        ++param;
+    }
+}
+
+void CodeGenerator::emitSpecialization(const Specialization &p_clone)
+{
+    bindParams(p_clone);
+    m_specialization = &p_clone;
+    walk(*p_clone.function);
+    m_specialization = nullptr;
+    m_constant_params.clear();
+}
+
+bool CodeGenerator::foldCondition(const ExpressionNode &p_condition,
+                                  int32_t &p_value)
+{
+    if (m_constant_params.empty() && !m_options.fold_pure_calls)
+        return false;
+    return ConstantFolder(m_symbol_manager_ptr, m_constant_params,
+                          m_options.fold_pure_calls ? &m_pure_calls : nullptr)
+        .evaluate(p_condition, p_value);
+}
+
+// ===========================================
+// > Target features
+// ===========================================
+
+// t0 := t1 <op> t0 for mul, div and rem. Without the M extension the libgcc
+// routines compute them; they take the operands in a0 and a1, which hold
+// nothing while an expression is evaluated.
+void CodeGenerator::emitMulDiv(const Operator p_op)
+{
+    const char *opcode, *routine;
+    switch (p_op)
+    {
+    case Operator::kMultiplyOp:
+        opcode = "mul";
+        routine = "__mulsi3";
+        break;
+    case Operator::kDivideOp:
+        opcode = "div";
+        routine = "__divsi3";
+        break;
+    default:
+        opcode = "rem";
+        routine = "__modsi3";
+    }
+
+    if (m_options.ext_m || (m_options.zmmul && p_op == Operator::kMultiplyOp))
+    {
+        dumpInstructions(m_asm_buffer, "    %s t0, t1, t0\n", opcode);
+        return;
+    }
+
+    constexpr const char *const call_routine =
+        "    mv a0, t1\n"
+        "    mv a1, t0\n"
+        "    jal ra, %s\n"
+        "    mv t0, a0\n";
+
+    dumpInstructions(m_asm_buffer, call_routine, routine);
+}
+
+// t0 := t0 * p_factor, with shifts and, given Zba, shNadd where they do
+void CodeGenerator::emitScale(const int32_t p_factor)
+{
+    uint32_t magnitude = p_factor < 0 ? 0u - static_cast<uint32_t>(p_factor)
+                                      : static_cast<uint32_t>(p_factor);
+    if (magnitude == 0)
+    {
+        dumpInstructions(m_asm_buffer, "    li t0, 0\n");
+        return;
+    }
+
+    int shift = 0;
+    while ((magnitude & 1) == 0)
+    {
+        magnitude >>= 1;
+        ++shift;
+    }
+
+    // 3, 5 and 9 are t0 shifted by 1, 2 or 3 and added to itself
+    const int add_shift = magnitude == 3 ? 1 : magnitude == 5 ? 2 : magnitude == 9 ? 3 : 0;
+    if (magnitude != 1 && !(m_options.zba && add_shift))
+    {
+        dumpInstructions(m_asm_buffer, "    li t1, %d\n", p_factor);
+        emitMulDiv(Operator::kMultiplyOp);
+        return;
+    }
+
+    if (magnitude != 1)
+        dumpInstructions(m_asm_buffer, "    sh%dadd t0, t0, t0\n", add_shift);
+    if (shift)
+        dumpInstructions(m_asm_buffer, "    slli t0, t0, %d\n", shift);
+    if (p_factor < 0)
+        dumpInstructions(m_asm_buffer, "    sub t0, zero, t0\n");
+}
+
+// ===========================================
+// > Scalar evolution
+// ===========================================
+
+// x := x + (w0 * e(L) + w1 * e(L+1) + ...) for each reduction of the loop,
+// where e is the right-hand side with x bound to 0; the sum is computed here
+// if e only depends on the loop variable
+void CodeGenerator::emitReductions(const ForNode &p_for,
+                                   const ScalarEvolution &p_scev)
+{
+    const SymbolEntry *loop_var = m_symbol_manager_ptr->lookup(p_for.getLoopVarName());
+    const uint32_t lower =
+        static_cast<uint32_t>(p_for.getLowerBound().getConstantPtr()->integer());
+
+    constexpr const char *const combine_terms =
+        "    lw t0, 0(sp)\n"
+        "    addi sp, sp, 4\n"
+        "    lw t1, 0(sp)\n"
+        "    addi sp, sp, 4\n"
+        "    %s t0, t1, t0\n"
+        "    addi sp, sp, -4\n"
+        "    sw t0, 0(sp)\n";
+
+    for (const auto &reduction : p_scev.getReductions())
+    {
+        m_folded_statements.erase(reduction.update);
+
+        // the loop doesn't run
+        const auto &weights = reduction.weights;
+        if (std::all_of(weights.begin(), weights.end(),
+                        [](const uint32_t p_weight) { return p_weight == 0; }))
+            continue;
+
+        const auto &step = reduction.update->getExpr();
+
+        ConstantFolder::Bindings bindings = m_constant_params;
+        bindings[reduction.accumulator] = 0;
+        bool known = true;
+        uint32_t total = 0;
+        for (uint32_t k = 0; k < weights.size() && known; ++k)
+        {
+            int32_t value;
+            bindings[loop_var] = static_cast<int32_t>(lower + k);
+            if (weights[k] != 0)
+                known = ConstantFolder(m_symbol_manager_ptr, bindings)
+                            .evaluate(step, value);
+            if (known && weights[k] != 0)
+                total += weights[k] * static_cast<uint32_t>(value);
+        }
+
+        auto &target = const_cast<VariableReferenceNode &>(reduction.update->getLvalue());
+        var_ref_mode = 'l';
+        walk(target);
+        walk(target);
+
+        if (known)
+        {
+            constexpr const char *const load_sum =
+                "    li t0, %d\n"
+                "    addi sp, sp, -4\n"
+                "    sw t0, 0(sp)\n";
+
+            dumpInstructions(m_asm_buffer, load_sum, static_cast<int32_t>(total));
+        }
+        else
+        {
+            m_constant_params[reduction.accumulator] = 0;
+            bool first = true;
+            for (uint32_t k = 0; k < weights.size(); ++k)
+            {
+                if (weights[k] == 0)
+                    continue;
+
+                m_constant_params[loop_var] = static_cast<int32_t>(lower + k);
+                walk(step);
+                if (weights[k] != 1)
+                {
+                    dumpInstructions(m_asm_buffer, "    lw t0, 0(sp)\n");
+                    emitScale(static_cast<int32_t>(weights[k]));
+                    dumpInstructions(m_asm_buffer, "    sw t0, 0(sp)\n");
+                }
+                if (!first)
+                {
+                    dumpInstructions(m_asm_buffer, combine_terms, "add");
+                }
+                first = false;
+            }
+            m_constant_params.erase(loop_var);
+            m_constant_params.erase(reduction.accumulator);
+        }
+
+        dumpInstructions(m_asm_buffer, combine_terms, "add");
+
+        const char *const assignment_statement =
+            "    lw t0, 0(sp)\n"
+            "    addi sp, sp, 4\n"
+            "    lw t1, 0(sp)\n"
+            "    addi sp, sp, 4\n"
+            "    sw t0, 0(t1)\n";
+
+        dumpInstructions(m_asm_buffer, assignment_statement);
+    }
+}
+
+// ===========================================
+// > If-conversion
+// ===========================================
+
+void CodeGenerator::emitSelect(const IfNode &p_if, const IfConversion &p_select)
+{
+    var_ref_mode = 'l';
+    walk(p_select.getTarget());
+
+    const auto kind = p_select.getKind();
+    if (m_options.zbb && kind != IfConversion::Kind::kSelect)
+    {
+        // the condition compares the two values themselves
+        walk(p_select.getThenValue());
+        walk(p_select.getElseValue());
+
+        constexpr const char *const min_max =
+            "    lw t0, 0(sp)\n"
+            "    addi sp, sp, 4\n"
+            "    lw t1, 0(sp)\n"
+            "    addi sp, sp, 4\n"
+            "    %s t0, t1, t0\n"
+            "    addi sp, sp, -4\n"
+            "    sw t0, 0(sp)\n";
+
+        dumpInstructions(m_asm_buffer, min_max,
+                         kind == IfConversion::Kind::kMin ? "min" : "max");
+    }
+    else
+    {
+        walk(p_if.getCondition());
+        walk(p_select.getThenValue());
+        walk(p_select.getElseValue());
+
+        constexpr const char *const pop_select_operands =
+            "    lw t0, 0(sp)\n"
+            "    lw t1, 4(sp)\n"
+            "    lw t2, 8(sp)\n"
+            "    addi sp, sp, 12\n";
+
+        dumpInstructions(m_asm_buffer, pop_select_operands);
+
+        if (m_options.zicond)
+        {
+            constexpr const char *const select_with_czero =
+                "    czero.eqz t1, t1, t2\n"
+                "    czero.nez t0, t0, t2\n"
+                "    or t0, t0, t1\n";
+
+            dumpInstructions(m_asm_buffer, select_with_czero);
+        }
+        else
+        {
+            // the condition is 0 or 1, so -c masks in the difference of
+            // the then-value from the else-value
+            constexpr const char *const select_with_mask =
+                "    sub t2, zero, t2\n"
+                "    xor t1, t1, t0\n"
+                "    and t1, t1, t2\n"
+                "    xor t0, t0, t1\n";
+
+            dumpInstructions(m_asm_buffer, select_with_mask);
+        }
+
+        dumpInstructions(m_asm_buffer, "    addi sp, sp, -4\n    sw t0, 0(sp)\n");
+    }
+
+    const char *const assignment_statement =
+        "    lw t0, 0(sp)\n"
+        "    addi sp, sp, 4\n"
+        "    lw t1, 0(sp)\n"
+        "    addi sp, sp, 4\n"
+        "    sw t0, 0(t1)\n";
+
+    dumpInstructions(m_asm_buffer, assignment_statement);
+}
+
+// ===========================================
+// > Memoization
+// ===========================================
+
+// the words of an entry: valid flag, arguments, result
+uint32_t CodeGenerator::getMemoEntrySize(const uint32_t p_num_params)
+{
+    uint32_t size = 4;
+    while (size < 4 * (p_num_params + 2))
+        size *= 2;
+    return size;
+}
+
+// A function reading global variables may return something else for the
+// same arguments once they are assigned. The lookup also needs a word for the
+// entry and one per argument below `p_free_offset`, inside the fixed 128-byte
+// frame: the expression stack grows right below it.
+bool CodeGenerator::isMemoizable(const FunctionNode &p_function,
+                                 const int p_free_offset) const
+{
+    const int num_params = (int)p_function.getParametersNum(p_function.getParameters());
+    return m_options.memoize && num_params > 0 &&
+           p_free_offset - 4 * num_params >= -128 &&
+           m_pure_calls.isRecursive(p_function.getName()) &&
+           !m_pure_calls.readsGlobals(p_function.getName());
+}
+
+// Looks the arguments up in the cache of `p_function` and returns the result
+// straight away on a hit. The cache is indexed by `h = h * 31 + argument`
+// over the arguments; a miss runs the body, and emitMemoStore fills the
+// entry once it has returned.
+void CodeGenerator::emitMemoLookup(const FunctionNode &p_function,
+                                   const int p_free_offset)
+{
+    std::vector<int> param_offsets;
+    for (const auto &entry : p_function.getSymbolTable()->getEntries())
+    {
+        if (entry->getKind() == SymbolEntry::KindEnum::kParameterKind)
+            param_offsets.push_back(entry->getFrameOffset());
+    }
+
+    const uint32_t entry_size = getMemoEntrySize(param_offsets.size());
+    m_memoized_functions.emplace_back(p_function.getName(), entry_size);
+    m_memo_entry_offset = p_free_offset;
+    m_memo_key_offsets.clear();
+    m_memo_hit_label = label_num++;
+    const int miss_label = label_num++;
+
+    // the body may assign its parameters, so the keys are stored from copies
+    for (uint32_t i = 0; i < param_offsets.size(); ++i)
+    {
+        const int copy_offset = p_free_offset - 4 * (int)(i + 1);
+        m_memo_key_offsets.push_back(copy_offset);
+
+        if (i == 0)
+        {
+            constexpr const char *const hash_first_argument =
+                "    lw t0, %d(s0)\n"
+                "    sw t0, %d(s0)\n";
+
+            dumpInstructions(m_asm_buffer, hash_first_argument,
+                             param_offsets[i], copy_offset);
+            continue;
+        }
+
+        constexpr const char *const hash_argument =
+            "    slli t1, t0, 5\n"
+            "    sub t0, t1, t0\n"
+            "    lw t1, %d(s0)\n"
+            "    sw t1, %d(s0)\n"
+            "    add t0, t0, t1\n";
+
+        dumpInstructions(m_asm_buffer, hash_argument, param_offsets[i],
+                         copy_offset);
+    }
+
+    const uint32_t mask = m_options.memoize_entries - 1;
+    if (mask < 2048)
+    {
+        dumpInstructions(m_asm_buffer, "    andi t0, t0, %u\n", mask);
+    }
+    else
+    {
+        dumpInstructions(m_asm_buffer, "    li t1, %u\n    and t0, t0, t1\n", mask);
+    }
+
+    uint32_t shift = 0;
+    while ((1u << shift) < entry_size)
+        ++shift;
+
+    constexpr const char *const load_cache_entry =
+        "    slli t0, t0, %u\n"
+        "    la t1, %s.memo\n"
+        "    add t0, t0, t1\n"
+        "    sw t0, %d(s0)\n"
+        "    lw t1, 0(t0)\n"
+        "    beq t1, zero, L%d\n";
+
+    dumpInstructions(m_asm_buffer, load_cache_entry, shift,
+                     p_function.getNameCString(), m_memo_entry_offset,
+                     miss_label);
+
+    constexpr const char *const compare_key =
+        "    lw t1, %d(t0)\n"
+        "    lw t2, %d(s0)\n"
+        "    bne t1, t2, L%d\n";
+
+    for (uint32_t i = 0; i < m_memo_key_offsets.size(); ++i)
+    {
+        dumpInstructions(m_asm_buffer, compare_key, 4 * (i + 1),
+                         m_memo_key_offsets[i], miss_label);
+    }
+
+    dumpInstructions(m_asm_buffer, "    lw a0, %d(t0)\n",
+                     4 * (int)(m_memo_key_offsets.size() + 1));
+    emitMemoCounter(true);
+    dumpInstructions(m_asm_buffer, "    j L%d\n", m_memo_hit_label);
+
+    dumpInstructions(m_asm_buffer, "L%d:\n", miss_label);
+    emitMemoCounter(false);
+}
+
+// after the body has returned its result in a0
+void CodeGenerator::emitMemoStore()
+{
+    if (m_memo_hit_label < 0)
+        return;
+
+    dumpInstructions(m_asm_buffer, "    lw t0, %d(s0)\n", m_memo_entry_offset);
+
+    constexpr const char *const store_key =
+        "    lw t1, %d(s0)\n"
+        "    sw t1, %d(t0)\n";
+
+    for (uint32_t i = 0; i < m_memo_key_offsets.size(); ++i)
+    {
+        dumpInstructions(m_asm_buffer, store_key, m_memo_key_offsets[i],
+                         4 * (i + 1));
+    }
+
+    // the entry is only marked valid once it is complete
+    constexpr const char *const store_result =
+        "    sw a0, %d(t0)\n"
+        "    li t1, 1\n"
+        "    sw t1, 0(t0)\n"
+        "L%d:\n";
+
+    dumpInstructions(m_asm_buffer, store_result,
+                     4 * (int)(m_memo_key_offsets.size() + 1),
+                     m_memo_hit_label);
+
+    m_memo_hit_label = -1;
+    m_memo_key_offsets.clear();
+}
+
+void CodeGenerator::emitMemoCounter(const bool p_hit)
+{
+    if (!m_options.memoize_stats)
+        return;
+
+    // a0 may hold the result already
+    constexpr const char *const increment_counter =
+        "    la t2, __memo_counters+%u\n"
+        "    lw t3, 0(t2)\n"
+        "    addi t3, t3, 1\n"
+        "    sw t3, 0(t2)\n";
+
+    const uint32_t function = m_memoized_functions.size() - 1;
+    dumpInstructions(m_asm_buffer, increment_counter,
+                     (function * 2 + (p_hit ? 0 : 1)) * 4);
+}
+
+// before main returns: __memo_report(names, counters, number of functions),
+// provided by the runtime next to printInt and readInt
+void CodeGenerator::emitMemoReport()
+{
+    if (!m_options.memoize_stats || m_memoized_functions.empty())
+        return;
+
+    constexpr const char *const write_report =
+        "    la a0, __memo_names\n"
+        "    la a1, __memo_counters\n"
+        "    li a2, %u\n"
+        "    jal ra, __memo_report\n";
+
+    dumpInstructions(m_asm_buffer, write_report,
+                     (uint32_t)m_memoized_functions.size());
+}
+
+void CodeGenerator::emitMemoData()
+{
+    if (m_memoized_functions.empty())
+        return;
+
+    std::string data;
+    for (const auto &function : m_memoized_functions)
+    {
+        dumpInstructions(data, ".comm %s.memo, %u, 4\n", function.first.c_str(),
+                         m_options.memoize_entries * function.second);
+    }
+
+    if (m_options.memoize_stats)
+    {
+        dumpInstructions(data, ".section    .rodata\n");
+        for (uint32_t i = 0; i < m_memoized_functions.size(); ++i)
+        {
+            dumpInstructions(data, "__memo_name_%u:\n    .string \"%s\"\n", i,
+                             m_memoized_functions[i].first.c_str());
+        }
+        dumpInstructions(data, "    .align 2\n__memo_names:\n");
+        for (uint32_t i = 0; i < m_memoized_functions.size(); ++i)
+        {
+            dumpInstructions(data, "    .word __memo_name_%u\n", i);
+        }
+        dumpInstructions(data, ".comm __memo_counters, %u, 4\n",
+                         (uint32_t)m_memoized_functions.size() * 8);
+    }
+    m_module.appendTrailer(data);
+}
+
+// ===========================================
+// > Profile-guided layout
+// ===========================================
+
+// loops that iterate at least this many times per entry get their header
+// aligned to a fetch block
+static constexpr uint32_t kHotLoopMinTrips = 8;
+
+const BranchProfile::Site *
+CodeGenerator::getProfiledSite(const uint32_t p_site) const
+{
+    if (!m_profile.isLoaded())
+        return nullptr;
+    const auto *site = m_profile.getSite(p_site);
+    return (site && site->executed > 0) ? site : nullptr;
+}
+
+// counts the executions of the branch of `p_site`, or with `p_taken` the
+// times its condition held
+void CodeGenerator::emitEdgeCounter(const uint32_t p_site, const bool p_taken)
+{
+    if (!m_options.profile_generate)
+        return;
+
+    // t0 and t1 may still hold the operands of the branch
+    constexpr const char *const increment_counter =
+        "    la t2, __profile_counters+%u\n"
+        "    lw t3, 0(t2)\n"
+        "    addi t3, t3, 1\n"
+        "    sw t3, 0(t2)\n";
+
+    dumpInstructions(m_asm_buffer, increment_counter,
+                     (p_site * 2 + (p_taken ? 1 : 0)) * 4);
+}
+
+void CodeGenerator::beginColdBlock(const int p_label)
+{
+    m_hot_code.emplace_back();
+    m_hot_code.back().swap(m_asm_buffer);
+
+    dumpInstructions(m_asm_buffer, "L%d:\n", p_label);
+}
+
+void CodeGenerator::endColdBlock()
+{
+    // blocks nested in the body have already been appended
+    m_cold_buffer += m_asm_buffer;
+    m_return_jump_end = std::string::npos;
+
+    m_asm_buffer.swap(m_hot_code.back());
+    m_hot_code.pop_back();
+}
+
+void CodeGenerator::emitLoopAlignment(const BranchProfile::Site &p_site)
+{
+    if (m_options.optimize_size)
+        return;
+    if (p_site.taken >= kHotLoopMinTrips * std::max(p_site.notTaken(), 1u))
+    {
+        dumpInstructions(m_asm_buffer, "    .p2align 3\n");
+    }
+}
+
+// before main returns: __profile_write(path, counters, number of sites),
+// provided by the runtime next to printInt and readInt
+void CodeGenerator::emitProfileWrite()
+{
+    if (!m_options.profile_generate)
+        return;
+
+    constexpr const char *const write_profile =
+        "    la a0, __profile_path\n"
+        "    la a1, __profile_counters\n"
+        "    la a2, __profile_num_sites\n"
+        "    lw a2, 0(a2)\n"
+        "    jal ra, __profile_write\n";
+
+    dumpInstructions(m_asm_buffer, write_profile);
+}
+
+void CodeGenerator::emitProfileData()
+{
+    if (!m_options.profile_generate)
+        return;
+
+    std::string escaped_path;
+    for (const char c : m_profile_generate_path)
+    {
+        if (c == '"' || c == '\\')
+            escaped_path += '\\';
+        escaped_path += c;
+    }
+
+    constexpr const char *const emit_profile_data =
+        ".section    .rodata\n"
+        "    .align 2\n"
+        "__profile_num_sites:\n"
+        "    .word %u\n"
+        "__profile_path:\n"
+        "    .string \"%s\"\n"
+        ".comm __profile_counters, %u, 4\n";
+
+    std::string data;
+    dumpInstructions(data, emit_profile_data, m_branch_sites.getNumSites(),
+                     escaped_path.c_str(),
+                     std::max(m_branch_sites.getNumSites(), 1u) * 8);
+    m_module.appendTrailer(data);
+}
+
+void CodeGenerator::printSizeReport() const
+{
+    uint32_t total_before = 0, total_after = 0;
+
+    printf("%-33s%10s%10s%10s\n", "Function", "Before", "After", "Saved");
+    for (const auto &function : m_module.getFunctions())
+    {
+        auto found = m_original_code_size.find(function->getName());
+        const uint32_t before =
+            (found != m_original_code_size.end()) ? found->second : 0;
+        const uint32_t after = function->getCodeSize(m_options.compressed);
+
+        if (function->isAlias())
+        {
+            printf("%-33s%10u%10u%10d  (merged into %s)\n",
+                   function->getNameCString(), before, after,
+                   (int)before - (int)after, function->getAliasOf().c_str());
+        }
+        else
+        {
+            printf("%-33s%10u%10u%10d\n", function->getNameCString(), before,
+                   after, (int)before - (int)after);
+        }
+        total_before += before;
+        total_after += after;
+    }
+    printf("%-33s%10u%10u%10d\n", "(total)", total_before, total_after,
+           (int)total_before - (int)total_after);
+}
+
+bool CodeGenerator::enter(ProgramNode &p_program)
 {
     // Generate RISC-V instructions for program header
     // clang-format off
@@ -51,22 +802,67 @@ void CodeGenerator::visit(ProgramNode &p_program)
         "    .file \"%s\"\n"
         "    .option nopic\n";
     // clang-format on
-    dumpInstructions(m_output_file.get(), riscv_assembly_file_prologue,
+    dumpInstructions(m_asm_buffer, riscv_assembly_file_prologue,
                      m_source_file_path.c_str());
+    if (m_options.compressed)
+    {
+        dumpInstructions(m_asm_buffer, "    .option rvc\n");
+    }
+    else if (!m_options.ext_c)
+    {
+        // keep an assembler that defaults to C from compressing for a core
+        // without it
+        dumpInstructions(m_asm_buffer, "    .option norvc\n");
+    }
+    // the assembler needn't be run with a matching -march; `.option arch`
+    // needs binutils 2.38 or later, so it is only emitted for the Z
+    // extensions, which older assemblers can't be told about otherwise
+    for (const auto &extension : {std::make_pair(m_options.zba, "zba"),
+                                  std::make_pair(m_options.zbb, "zbb"),
+                                  std::make_pair(m_options.zicond, "zicond")})
+    {
+        if (extension.first)
+            dumpInstructions(m_asm_buffer, "    .option arch, +%s\n", extension.second);
+    }
 
     // Reconstruct the hash table for looking up the symbol entry
     // Hint: Use symbol_manager->lookup(symbol_name) to get the symbol entry.
     m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
         p_program.getSymbolTable());
 
+    if (m_options.if_conversion)
+    {
+        m_flat_ast.build(p_program);
+    }
+
+    m_branch_sites.walk(p_program);
+    if (m_profile.isLoaded() && m_profile.getNumSites() != m_branch_sites.getNumSites())
+    {
+        fprintf(stderr, "warning: profile '%s' was collected from a different program, ignored\n",
+                m_options.profile_use_path.c_str());
+        m_profile = BranchProfile();
+    }
+
     auto visit_ast_node = [&](auto &ast_node)
-    { ast_node->accept(*this); };
+    { walk(*ast_node); };
     for_each(p_program.getDeclNodes().begin(), p_program.getDeclNodes().end(), visit_ast_node);
+
+    if (m_options.specialize)
+    {
+        m_specializer.run(p_program, m_options.specialize_growth);
+    }
+    if (m_options.fold_pure_calls || m_options.memoize)
+    {
+        m_pure_calls.analyze(p_program);
+    }
     for_each(p_program.getFuncNodes().begin(), p_program.getFuncNodes().end(), visit_ast_node);
+    for (const auto &clone : m_specializer.getSpecializations())
+    {
+        emitSpecialization(*clone);
+    }
 
-    fp_offset = -8;
     global_decl = false;
-    local_variable_offset.clear();
+    FrameLayout(m_symbol_manager_ptr).run(const_cast<CompoundStatementNode &>(p_program.getBody()));
 
     const char *const emit_main_function_section =
         ".section    .text\n"
@@ -75,7 +871,8 @@ void CodeGenerator::visit(ProgramNode &p_program)
         "    .type main, @function\n"
         "main:\n";
 
-    dumpInstructions(m_output_file.get(), emit_main_function_section);
+    beginFunction();
+    dumpInstructions(m_asm_buffer, emit_main_function_section);
 
     // the main function prologue
     const char *const main_function_prologue =
@@ -84,9 +881,13 @@ void CodeGenerator::visit(ProgramNode &p_program)
         "    sw s0, 120(sp)\n"
         "    addi s0, sp, 128\n";
 
-    dumpInstructions(m_output_file.get(), main_function_prologue);
+    dumpInstructions(m_asm_buffer, main_function_prologue);
 
-    const_cast<CompoundStatementNode &>(p_program.getBody()).accept(*this);
+    walk(p_program.getBody());
+
+    emitReturnBlock();
+    emitProfileWrite();
+    emitMemoReport();
 
     // the main function epilogue
     const char *const main_function_epilogue =
@@ -96,18 +897,25 @@ void CodeGenerator::visit(ProgramNode &p_program)
         "    jr ra\n"
         "    .size main, .-main\n";
 
-    dumpInstructions(m_output_file.get(), main_function_epilogue);
+    dumpInstructions(m_asm_buffer, main_function_epilogue);
+    endFunction("main", 0, true);
+    emitProfileData();
+    emitMemoData();
 
     // Remove the entries in the hash table
     m_symbol_manager_ptr->removeSymbolsFromHashTable(p_program.getSymbolTable());
-}
 
-void CodeGenerator::visit(DeclNode &p_decl)
-{
-    p_decl.visitChildNodes(*this);
+    runMachinePasses();
+    m_module.print(m_output_file.get());
+
+    if (m_options.size_report)
+    {
+        printSizeReport();
+    }
+    return false;
 }
 
-void CodeGenerator::visit(VariableNode &p_variable)
+bool CodeGenerator::enter(VariableNode &p_variable)
 {
     if ((int)m_symbol_manager_ptr->getCurrentLevel() == 0 && global_decl) // global variable declaration
     {
@@ -117,7 +925,7 @@ void CodeGenerator::visit(VariableNode &p_variable)
                 ".section    .rodata\n"
                 "    .align 2\n";
 
-            dumpInstructions(m_output_file.get(), emit_rodata_section);
+            dumpInstructions(m_asm_buffer, emit_rodata_section);
 
             constexpr const char *const emit_symbol_to_global_symbol_table =
                 "    .globl %s\n"
@@ -125,19 +933,18 @@ void CodeGenerator::visit(VariableNode &p_variable)
                 "%s:\n"
                 "    .word %s\n";
 
-            dumpInstructions(m_output_file.get(), emit_symbol_to_global_symbol_table,
+            dumpInstructions(m_asm_buffer, emit_symbol_to_global_symbol_table,
                              p_variable.getNameCString(), p_variable.getNameCString(), p_variable.getNameCString(),
                              p_variable.getConstantPtr()->getConstantValueCString());
         }
         else // isn't a global constant variable declaration
         {
-            dumpInstructions(m_output_file.get(), ".comm %s, 4, 4\n", p_variable.getNameCString());
+            dumpInstructions(m_asm_buffer, ".comm %s, 4, 4\n", p_variable.getNameCString());
         }
     }
     else if (func_para_num <= 0) // local variable declaration
     {
-        fp_offset -= 4;
-        local_variable_offset[m_symbol_manager_ptr->lookup(p_variable.getName())] = fp_offset;
+        const int var_loc = m_symbol_manager_ptr->lookup(p_variable.getName())->getFrameOffset();
 
         if (p_variable.getConstantPtr())
         {
@@ -145,28 +952,26 @@ void CodeGenerator::visit(VariableNode &p_variable)
                 "    li t0, %s\n"
                 "    sw t0, %d(s0)\n";
 
-            dumpInstructions(m_output_file.get(), store_value_to_local_variable,
-                             p_variable.getConstantPtr()->getConstantValueCString(), fp_offset);
+            dumpInstructions(m_asm_buffer, store_value_to_local_variable,
+                             p_variable.getConstantPtr()->getConstantValueCString(), var_loc);
         }
     }
     else // function parameter declaration
     {
-        fp_offset -= 4;
-        local_variable_offset[m_symbol_manager_ptr->lookup(p_variable.getName())] = fp_offset;
+        const SymbolEntry *param_info = m_symbol_manager_ptr->lookup(p_variable.getName());
 
-        if (para_reg_idx < 8) // a0 ~ a7
+        // a0 ~ a7; the rest stay on the caller's stack, and the parameters a
+        // specialization binds aren't passed at all
+        if (para_reg_idx < 8 && !m_constant_params.count(param_info))
         {
-            constexpr const char *const store_register_to_stack =
-                "    sw a%d, %d(s0)\n";
+            const int arg_reg_idx =
+                m_specialization ? (int)m_specialization->getArgumentIndex(para_reg_idx) : para_reg_idx;
 
-            dumpInstructions(m_output_file.get(), store_register_to_stack, para_reg_idx, fp_offset);
-        }
-        else // s8 ~ s11
-        {
             constexpr const char *const store_register_to_stack =
-                "    sw s%d, %d(s0)\n";
+                "    sw a%d, %d(s0)\n";
 
-            dumpInstructions(m_output_file.get(), store_register_to_stack, para_reg_idx, fp_offset);
+            dumpInstructions(m_asm_buffer, store_register_to_stack, arg_reg_idx,
+                             param_info->getFrameOffset());
         }
 
         para_reg_idx++;
@@ -176,9 +981,10 @@ void CodeGenerator::visit(VariableNode &p_variable)
             para_reg_idx = 0;
         }
     }
+    return false;
 }
 
-void CodeGenerator::visit(ConstantValueNode &p_constant_value)
+bool CodeGenerator::enter(ConstantValueNode &p_constant_value)
 {
     std::string const_value = p_constant_value.getConstantValueCString();
     PType::PrimitiveTypeEnum const_value_type = p_constant_value.getTypePtr()->getPrimitiveType();
@@ -196,11 +1002,15 @@ void CodeGenerator::visit(ConstantValueNode &p_constant_value)
         "    addi sp, sp, -4\n"
         "    sw t0, 0(sp)\n";
 
-    dumpInstructions(m_output_file.get(), load_constant_value, const_value.c_str());
+    dumpInstructions(m_asm_buffer, load_constant_value, const_value.c_str());
+    return false;
 }
 
-void CodeGenerator::visit(FunctionNode &p_function)
+bool CodeGenerator::enter(FunctionNode &p_function)
 {
+    FrameLayout layout(m_symbol_manager_ptr);
+    layout.run(p_function);
+
     // Reconstruct the hash table for looking up the symbol entry
     m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(p_function.getSymbolTable());
 
@@ -211,12 +1021,13 @@ void CodeGenerator::visit(FunctionNode &p_function)
         "    .type %s, @function\n"
         "%s:\n";
 
-    dumpInstructions(m_output_file.get(), emit_function_section,
-                     p_function.getNameCString(), p_function.getNameCString(), p_function.getNameCString());
+    const std::string &name = m_specialization ? m_specialization->name : p_function.getName().str();
+
+    beginFunction();
+    dumpInstructions(m_asm_buffer, emit_function_section,
+                     name.c_str(), name.c_str(), name.c_str());
 
-    fp_offset = -8;
     global_decl = false;
-    local_variable_offset.clear();
 
     const char *const function_prologue =
         "    addi sp, sp, -128\n"
@@ -224,15 +1035,29 @@ void CodeGenerator::visit(FunctionNode &p_function)
         "    sw s0, 120(sp)\n"
         "    addi s0, sp, 128\n";
 
-    dumpInstructions(m_output_file.get(), function_prologue);
+    dumpInstructions(m_asm_buffer, function_prologue);
 
     func_para_num = (int)p_function.getParametersNum(p_function.getParameters());
     para_reg_idx = 0;
 
-    p_function.visitChildNodes(*this);
+    for (auto *const parameter : p_function.getParameters())
+    {
+        walk(*parameter);
+    }
+    if (!m_specialization && isMemoizable(p_function, layout.getEndOffset()))
+    {
+        emitMemoLookup(p_function, layout.getEndOffset());
+    }
+    if (p_function.hasBody())
+    {
+        walk(*p_function.getBody());
+    }
 
     func_para_num = para_reg_idx = 0;
 
+    emitReturnBlock();
+    emitMemoStore();
+
     constexpr const char *const main_function_epilogue =
         "    lw ra, 124(sp)\n"
         "    lw s0, 120(sp)\n"
@@ -240,42 +1065,82 @@ void CodeGenerator::visit(FunctionNode &p_function)
         "    jr ra\n"
         "    .size %s, .-%s\n";
 
-    dumpInstructions(m_output_file.get(), main_function_epilogue,
-                     p_function.getNameCString(), p_function.getNameCString());
+    dumpInstructions(m_asm_buffer, main_function_epilogue, name.c_str(), name.c_str());
+    // only main and the functions defined outside the program are called
+    // from outside the program
+    endFunction(name,
+                m_specialization ? m_specialization->getNumParams()
+                                 : p_function.getParametersNum(p_function.getParameters()),
+                !p_function.hasBody());
 
     // Remove the entries in the hash table
     m_symbol_manager_ptr->removeSymbolsFromHashTable(p_function.getSymbolTable());
+    return false;
 }
 
-void CodeGenerator::visit(CompoundStatementNode &p_compound_statement)
+bool CodeGenerator::enter(CompoundStatementNode &p_compound_statement)
 {
     // Reconstruct the hash table for looking up the symbol entry
     m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
         p_compound_statement.getSymbolTable());
+    return true;
+}
 
-    p_compound_statement.visitChildNodes(*this);
-
+void CodeGenerator::leave(CompoundStatementNode &p_compound_statement)
+{
     // Remove the entries in the hash table
     m_symbol_manager_ptr->removeSymbolsFromHashTable(
         p_compound_statement.getSymbolTable());
 }
 
-void CodeGenerator::visit(PrintNode &p_print)
+bool CodeGenerator::enter(PrintNode &)
 {
     var_ref_mode = 'r';
-    p_print.visitChildNodes(*this);
+    return true;
+}
 
+void CodeGenerator::leave(PrintNode &)
+{
     const char *const print_statement =
         "    lw a0, 0(sp)\n"
         "    addi sp, sp, 4\n"
         "    jal ra, printInt\n";
 
-    dumpInstructions(m_output_file.get(), print_statement);
+    dumpInstructions(m_asm_buffer, print_statement);
 }
 
-void CodeGenerator::visit(BinaryOperatorNode &p_bin_op)
+bool CodeGenerator::enter(BinaryOperatorNode &p_bin_op)
 {
-    p_bin_op.visitChildNodes(*this);
+    // a product with a known factor needs no multiplier
+    if (p_bin_op.getOp() == Operator::kMultiplyOp)
+    {
+        ConstantFolder folder(m_symbol_manager_ptr, m_constant_params,
+                              m_options.fold_pure_calls ? &m_pure_calls : nullptr);
+        const ExpressionNode *operand = nullptr;
+        int32_t factor;
+        if (folder.evaluate(p_bin_op.getRightOperand(), factor))
+            operand = &p_bin_op.getLeftOperand();
+        else if (folder.evaluate(p_bin_op.getLeftOperand(), factor))
+            operand = &p_bin_op.getRightOperand();
+
+        if (operand)
+        {
+            schedule(*operand);
+            schedule([this, factor]
+                     {
+                         dumpInstructions(m_asm_buffer, "    lw t0, 0(sp)\n");
+                         emitScale(factor);
+                         dumpInstructions(m_asm_buffer, "    sw t0, 0(sp)\n");
+                     });
+            return false;
+        }
+    }
+    return true;
+}
+
+void CodeGenerator::leave(BinaryOperatorNode &p_bin_op)
+{
+    Operator op_type = p_bin_op.getOp();
 
     const char *const pop_stack_values =
         "    lw t0, 0(sp)\n"
@@ -283,54 +1148,48 @@ void CodeGenerator::visit(BinaryOperatorNode &p_bin_op)
         "    lw t1, 0(sp)\n"
         "    addi sp, sp, 4\n";
 
-    dumpInstructions(m_output_file.get(), pop_stack_values);
+    dumpInstructions(m_asm_buffer, pop_stack_values);
 
     constexpr const char *const arithmetic_boolean_operation =
         "    %s t0, t1, t0\n";
 
-    Operator op_type = p_bin_op.getOp();
-
     switch (op_type)
     {
     case Operator::kMultiplyOp:
-        dumpInstructions(m_output_file.get(), arithmetic_boolean_operation, "mul");
-        break;
     case Operator::kDivideOp:
-        dumpInstructions(m_output_file.get(), arithmetic_boolean_operation, "div");
-        break;
     case Operator::kModOp:
-        dumpInstructions(m_output_file.get(), arithmetic_boolean_operation, "rem");
+        emitMulDiv(op_type);
         break;
     case Operator::kPlusOp:
-        dumpInstructions(m_output_file.get(), arithmetic_boolean_operation, "add");
+        dumpInstructions(m_asm_buffer, arithmetic_boolean_operation, "add");
         break;
     case Operator::kMinusOp:
-        dumpInstructions(m_output_file.get(), arithmetic_boolean_operation, "sub");
+        dumpInstructions(m_asm_buffer, arithmetic_boolean_operation, "sub");
         break;
     case Operator::kLessOp:
-        dumpInstructions(m_output_file.get(), "    slt t0, t1, t0\n");
+        dumpInstructions(m_asm_buffer, "    slt t0, t1, t0\n");
         break;
     case Operator::kLessOrEqualOp:
-        dumpInstructions(m_output_file.get(), "    slt t0, t0, t1\n    xori t0, t0, 1\n");
+        dumpInstructions(m_asm_buffer, "    slt t0, t0, t1\n    xori t0, t0, 1\n");
         break;
     case Operator::kGreaterOp:
-        dumpInstructions(m_output_file.get(), "    slt t0, t0, t1\n");
+        dumpInstructions(m_asm_buffer, "    slt t0, t0, t1\n");
         break;
     case Operator::kGreaterOrEqualOp:
-        dumpInstructions(m_output_file.get(), "    slt t0, t1, t0\n    xori t0, t0, 1\n");
+        dumpInstructions(m_asm_buffer, "    slt t0, t1, t0\n    xori t0, t0, 1\n");
         break;
     case Operator::kEqualOp:
-        dumpInstructions(m_output_file.get(),
+        dumpInstructions(m_asm_buffer,
                          "    slt t2, t1, t0\n    slt t3, t0, t1\n    or t0, t2, t3\n    xori t0, t0, 1\n");
         break;
     case Operator::kNotEqualOp:
-        dumpInstructions(m_output_file.get(), "    slt t2, t1, t0\n    slt t3, t0, t1\n    or t0, t2, t3\n");
+        dumpInstructions(m_asm_buffer, "    slt t2, t1, t0\n    slt t3, t0, t1\n    or t0, t2, t3\n");
         break;
     case Operator::kAndOp:
-        dumpInstructions(m_output_file.get(), arithmetic_boolean_operation, "and");
+        dumpInstructions(m_asm_buffer, arithmetic_boolean_operation, "and");
         break;
     case Operator::kOrOp:
-        dumpInstructions(m_output_file.get(), arithmetic_boolean_operation, "or");
+        dumpInstructions(m_asm_buffer, arithmetic_boolean_operation, "or");
         break;
     default:;
     }
@@ -339,28 +1198,26 @@ void CodeGenerator::visit(BinaryOperatorNode &p_bin_op)
         "    addi sp, sp, -4\n"
         "    sw t0, 0(sp)\n";
 
-    dumpInstructions(m_output_file.get(), store_result_to_stack);
+    dumpInstructions(m_asm_buffer, store_result_to_stack);
 }
 
-void CodeGenerator::visit(UnaryOperatorNode &p_un_op)
+void CodeGenerator::leave(UnaryOperatorNode &p_un_op)
 {
-    p_un_op.visitChildNodes(*this);
-
     const char *const pop_stack_values =
         "    lw t0, 0(sp)\n"
         "    addi sp, sp, 4\n";
 
-    dumpInstructions(m_output_file.get(), pop_stack_values);
+    dumpInstructions(m_asm_buffer, pop_stack_values);
 
     Operator op_type = p_un_op.getOp();
 
     switch (op_type)
     {
     case Operator::kNegOp:
-        dumpInstructions(m_output_file.get(), "    sub t0, zero, t0\n");
+        dumpInstructions(m_asm_buffer, "    sub t0, zero, t0\n");
         break;
     case Operator::kNotOp:
-        dumpInstructions(m_output_file.get(), "    xori t0, t0, 1\n");
+        dumpInstructions(m_asm_buffer, "    xori t0, t0, 1\n");
         break;
     default:;
     }
@@ -369,51 +1226,132 @@ void CodeGenerator::visit(UnaryOperatorNode &p_un_op)
         "    addi sp, sp, -4\n"
         "    sw t0, 0(sp)\n";
 
-    dumpInstructions(m_output_file.get(), store_result_to_stack);
+    dumpInstructions(m_asm_buffer, store_result_to_stack);
 }
 
-void CodeGenerator::visit(FunctionInvocationNode &p_func_invocation)
+bool CodeGenerator::enter(FunctionInvocationNode &p_func_invocation)
 {
-    p_func_invocation.visitChildNodes(*this);
-
-    func_para_num = (int)p_func_invocation.getArguments().size();
+    int32_t result;
+    if (m_options.fold_pure_calls &&
+        ConstantFolder(m_symbol_manager_ptr, m_constant_params, &m_pure_calls)
+            .evaluate(p_func_invocation, result))
+    {
+        constexpr const char *const load_call_result =
+            "    li t0, %d\n"
+            "    addi sp, sp, -4\n"
+            "    sw t0, 0(sp)\n";
 
-    constexpr const char *const load_arguments_to_regisers =
-        "    lw %c%d, 0(sp)\n"
-        "    addi sp, sp, 4\n";
+        dumpInstructions(m_asm_buffer, load_call_result, result);
+        return false;
+    }
 
-    for (para_reg_idx = func_para_num - 1; para_reg_idx >= 0; para_reg_idx--)
+    const Specialization *clone = m_specializer.getSpecialization(p_func_invocation);
+    if (clone)
     {
-        if (para_reg_idx < 8)
+        // the clone has the constant arguments built in
+        const auto &args = p_func_invocation.getArguments();
+        for (uint32_t i = 0; i < args.size(); ++i)
         {
-            dumpInstructions(m_output_file.get(), load_arguments_to_regisers, 'a', para_reg_idx);
+            if (!clone->bound[i])
+                schedule(*args[i]);
         }
-        else
+    }
+    else
+    {
+        scheduleChildNodes(p_func_invocation);
+    }
+    schedule([this, &p_func_invocation, clone]
+             { emitCall(p_func_invocation, clone); });
+    return false;
+}
+
+void CodeGenerator::emitCall(const FunctionInvocationNode &p_func_invocation,
+                             const Specialization *p_clone)
+{
+    func_para_num = p_clone ? (int)p_clone->getNumParams()
+                            : (int)p_func_invocation.getArguments().size();
+    const int stack_para_num = std::max(func_para_num - 8, 0);
+
+    if (stack_para_num == 0)
+    {
+        constexpr const char *const load_arguments_to_regisers =
+            "    lw a%d, 0(sp)\n"
+            "    addi sp, sp, 4\n";
+
+        for (para_reg_idx = func_para_num - 1; para_reg_idx >= 0; para_reg_idx--)
         {
-            dumpInstructions(m_output_file.get(), load_arguments_to_regisers, 's', para_reg_idx);
+            dumpInstructions(m_asm_buffer, load_arguments_to_regisers, para_reg_idx);
         }
     }
+    else
+    {
+        // The arguments lie on the stack in evaluation order, the last one on
+        // top. The top slots, once reversed, are the outgoing argument area
+        // the psABI expects: the ninth argument at 0(sp), the tenth at 4(sp),
+        // ... They're reversed before the first eight are loaded into a0 ~ a7
+        // in place, since the swap needs scratch registers and -mrvc renames
+        // those to argument registers (see Compression.cpp).
+        constexpr const char *const swap_stack_arguments =
+            "    lw t0, %d(sp)\n"
+            "    lw t1, %d(sp)\n"
+            "    sw t1, %d(sp)\n"
+            "    sw t0, %d(sp)\n";
+
+        for (int low = 0, high = stack_para_num - 1; low < high; low++, high--)
+        {
+            dumpInstructions(m_asm_buffer, swap_stack_arguments, 4 * low,
+                             4 * high, 4 * low, 4 * high);
+        }
 
-    func_para_num = 0;
-    para_reg_idx = 0;
+        constexpr const char *const load_argument_to_register =
+            "    lw a%d, %d(sp)\n";
+
+        for (para_reg_idx = 0; para_reg_idx < 8; para_reg_idx++)
+        {
+            dumpInstructions(m_asm_buffer, load_argument_to_register, para_reg_idx,
+                             4 * (func_para_num - 1 - para_reg_idx));
+        }
+    }
 
     constexpr const char *const call_function =
         "    jal ra, %s\n";
 
-    dumpInstructions(m_output_file.get(), call_function, p_func_invocation.getNameCString());
+    dumpInstructions(m_asm_buffer, call_function,
+                     p_clone ? p_clone->name.c_str() : p_func_invocation.getNameCString());
+
+    if (stack_para_num > 0)
+    {
+        // release the outgoing arguments together with the register ones
+        dumpInstructions(m_asm_buffer, "    addi sp, sp, %d\n", 4 * func_para_num);
+    }
+
+    func_para_num = 0;
+    para_reg_idx = 0;
 
     const char *const store_return_value_to_stack =
         "    mv t0, a0\n"
         "    addi sp, sp, -4\n"
         "    sw t0, 0(sp)\n";
 
-    dumpInstructions(m_output_file.get(), store_return_value_to_stack);
+    dumpInstructions(m_asm_buffer, store_return_value_to_stack);
 }
 
-void CodeGenerator::visit(VariableReferenceNode &p_variable_ref)
+bool CodeGenerator::enter(VariableReferenceNode &p_variable_ref)
 {
     const SymbolEntry *var_info = m_symbol_manager_ptr->lookup(p_variable_ref.getName());
 
+    auto bound_param = m_constant_params.find(var_info);
+    if (bound_param != m_constant_params.end()) // never assigned, see CallSpecializer
+    {
+        constexpr const char *const load_constant_param =
+            "    li t0, %d\n"
+            "    addi sp, sp, -4\n"
+            "    sw t0, 0(sp)\n";
+
+        dumpInstructions(m_asm_buffer, load_constant_param, bound_param->second);
+        return false;
+    }
+
     if (var_ref_mode == 'l')
     {
         if (var_info->getLevel() == 0) // global variable address
@@ -423,18 +1361,18 @@ void CodeGenerator::visit(VariableReferenceNode &p_variable_ref)
                 "    la t0, %s\n"
                 "    sw t0, 0(sp)\n";
 
-            dumpInstructions(m_output_file.get(), load_global_variable, p_variable_ref.getNameCString());
+            dumpInstructions(m_asm_buffer, load_global_variable, p_variable_ref.getNameCString());
         }
         else // local variable address
         {
-            int var_loc = local_variable_offset[var_info];
+            int var_loc = var_info->getFrameOffset();
 
             constexpr const char *const load_local_variable =
                 "    addi t0, s0, %d\n"
                 "    addi sp, sp, -4\n"
                 "    sw t0, 0(sp)\n";
 
-            dumpInstructions(m_output_file.get(), load_local_variable, var_loc);
+            dumpInstructions(m_asm_buffer, load_local_variable, var_loc);
         }
     }
     else // var_ref_mode = 'r'
@@ -448,29 +1386,36 @@ void CodeGenerator::visit(VariableReferenceNode &p_variable_ref)
                 "    addi sp, sp, -4\n"
                 "    sw t0, 0(sp)\n";
 
-            dumpInstructions(m_output_file.get(), load_global_variable, p_variable_ref.getNameCString());
+            dumpInstructions(m_asm_buffer, load_global_variable, p_variable_ref.getNameCString());
         }
         else // local variable value
         {
-            int var_loc = local_variable_offset[var_info];
+            int var_loc = var_info->getFrameOffset();
 
             constexpr const char *const load_local_variable =
                 "    lw t0, %d(s0)\n"
                 "    addi sp, sp, -4\n"
                 "    sw t0, 0(sp)\n";
 
-            dumpInstructions(m_output_file.get(), load_local_variable, var_loc);
+            dumpInstructions(m_asm_buffer, load_local_variable, var_loc);
         }
     }
 
     var_ref_mode = 'r';
+    return false;
 }
 
-void CodeGenerator::visit(AssignmentNode &p_assignment)
+bool CodeGenerator::enter(AssignmentNode &p_assignment)
 {
+    if (m_folded_statements.count(&p_assignment))
+        return false;
+
     var_ref_mode = 'l';
-    p_assignment.visitChildNodes(*this);
+    return true;
+}
 
+void CodeGenerator::leave(AssignmentNode &)
+{
     const char *const assignment_statement =
         "    lw t0, 0(sp)\n"
         "    addi sp, sp, 4\n"
@@ -478,169 +1423,488 @@ void CodeGenerator::visit(AssignmentNode &p_assignment)
         "    addi sp, sp, 4\n"
         "    sw t0, 0(t1)\n";
 
-    dumpInstructions(m_output_file.get(), assignment_statement);
+    dumpInstructions(m_asm_buffer, assignment_statement);
 }
 
-void CodeGenerator::visit(ReadNode &p_read)
+bool CodeGenerator::enter(ReadNode &)
 {
     var_ref_mode = 'l';
-    p_read.visitChildNodes(*this);
+    return true;
+}
 
+void CodeGenerator::leave(ReadNode &)
+{
     const char *const read_statement =
         "    jal ra, readInt\n"
         "    lw t0, 0(sp)\n"
         "    addi sp, sp, 4\n"
         "    sw a0, 0(t0)\n";
 
-    dumpInstructions(m_output_file.get(), read_statement);
+    dumpInstructions(m_asm_buffer, read_statement);
 }
 
-void CodeGenerator::visit(IfNode &p_if)
+// The statements below are lowered as a sequence of steps around their
+// parts, scheduled on the walk's stack, so that how deeply they nest costs no
+// native stack. Conditions are expressions, which allocate no labels, so
+// allocating the labels up front keeps them numbered as they are placed.
+
+bool CodeGenerator::enter(IfNode &p_if)
 {
-    p_if.visitExpressionNode(*this);
+    const uint32_t site = m_branch_sites.getSite(p_if);
 
-    const char *const branch_statement =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    beq t0, zero, L%d\n";
+    // the profile counts the statement as if its condition were evaluated,
+    // so that it matches the builds that don't fold it
+    int32_t condition;
+    if (foldCondition(p_if.getCondition(), condition))
+    {
+        emitEdgeCounter(site, false);
+        if (condition)
+        {
+            emitEdgeCounter(site, true);
+            schedule(p_if.getBody());
+        }
+        else if (p_if.hasElse())
+        {
+            schedule(*p_if.getElseBody());
+        }
+        return false;
+    }
 
-    int first_label = label_num;
-    label_num++;
-    dumpInstructions(m_output_file.get(), branch_statement, first_label); // L1
+    const auto *profile = getProfiledSite(site);
 
-    p_if.visitIfBodyNode(*this);
+    // an arm that never ran is better off out of line; the edge counters
+    // need the branch
+    IfConversion select(m_symbol_manager_ptr, m_flat_ast);
+    if (m_options.if_conversion && !m_options.profile_generate &&
+        !(profile && (profile->taken == 0 || profile->notTaken() == 0)) &&
+        select.analyze(p_if))
+    {
+        emitSelect(p_if, select);
+        return false;
+    }
+
+    schedule(p_if.getCondition());
+
+    // pops the condition and branches to `p_label` with `p_branch`
+    auto schedule_branch = [&](const char *const p_branch, const int p_label)
+    {
+        schedule([this, site, p_branch, p_label]
+                 {
+                     const char *const pop_condition =
+                         "    lw t0, 0(sp)\n"
+                         "    addi sp, sp, 4\n";
+
+                     dumpInstructions(m_asm_buffer, pop_condition);
+                     emitEdgeCounter(site, false);
+                     dumpInstructions(m_asm_buffer, p_branch, p_label);
+                 });
+    };
+
+    auto schedule_if_body = [&]()
+    {
+        schedule([this, site]
+                 { emitEdgeCounter(site, true); });
+        schedule(p_if.getBody());
+    };
+
+    auto schedule_else_body = [&]()
+    {
+        if (p_if.hasElse())
+            schedule(*p_if.getElseBody());
+    };
 
     constexpr const char *const jump_statement =
         "    j L%d\n";
 
-    if (p_if.hasElse())
+    if (profile && profile->taken == 0) // the then-arm never ran
+    {
+        int cold_label = label_num;
+        label_num++;
+        int end_label = label_num;
+        label_num++;
+        schedule_branch("    bne t0, zero, L%d\n", cold_label);
+
+        schedule_else_body();
+
+        schedule([this, cold_label, end_label]
+                 {
+                     dumpInstructions(m_asm_buffer, "L%d:\n", end_label);
+                     beginColdBlock(cold_label);
+                 });
+        schedule_if_body();
+        schedule([this, end_label]
+                 {
+                     dumpInstructions(m_asm_buffer, jump_statement, end_label);
+                     endColdBlock();
+                 });
+    }
+    else if (profile && p_if.hasElse() && profile->notTaken() == 0) // the else-arm never ran
+    {
+        int cold_label = label_num;
+        label_num++;
+        int end_label = label_num;
+        label_num++;
+        schedule_branch("    beq t0, zero, L%d\n", cold_label);
+
+        schedule_if_body();
+
+        schedule([this, cold_label, end_label]
+                 {
+                     dumpInstructions(m_asm_buffer, "L%d:\n", end_label);
+                     beginColdBlock(cold_label);
+                 });
+        schedule_else_body();
+        schedule([this, end_label]
+                 {
+                     dumpInstructions(m_asm_buffer, jump_statement, end_label);
+                     endColdBlock();
+                 });
+    }
+    else if (profile && p_if.hasElse() && profile->notTaken() > profile->taken)
     {
-        int second_label = label_num;
+        // the else-arm is the hot path, let it fall through
+        int then_label = label_num;
         label_num++;
-        dumpInstructions(m_output_file.get(), jump_statement, second_label);
+        int end_label = label_num;
+        label_num++;
+        schedule_branch("    bne t0, zero, L%d\n", then_label);
+
+        schedule_else_body();
 
-        dumpInstructions(m_output_file.get(), "L%d:\n", first_label);
+        schedule([this, then_label, end_label]
+                 {
+                     dumpInstructions(m_asm_buffer, jump_statement, end_label);
+                     dumpInstructions(m_asm_buffer, "L%d:\n", then_label);
+                 });
 
-        p_if.visitElseBodyNode(*this);
+        schedule_if_body();
 
-        dumpInstructions(m_output_file.get(), "L%d:\n", second_label); // L2
+        schedule([this, end_label]
+                 { dumpInstructions(m_asm_buffer, "L%d:\n", end_label); });
     }
     else
     {
-        dumpInstructions(m_output_file.get(), "L%d:\n", first_label);
+        int first_label = label_num;
+        label_num++;
+        schedule_branch("    beq t0, zero, L%d\n", first_label); // L1
+
+        schedule_if_body();
 
-        p_if.visitElseBodyNode(*this);
+        if (p_if.hasElse())
+        {
+            // numbered after the labels of the then-arm
+            schedule([this, first_label]
+                     {
+                         int second_label = label_num;
+                         label_num++;
+                         m_pending_labels.push_back(second_label);
+                         dumpInstructions(m_asm_buffer, jump_statement, second_label);
+
+                         dumpInstructions(m_asm_buffer, "L%d:\n", first_label);
+                     });
+
+            schedule_else_body();
+
+            schedule([this]
+                     {
+                         dumpInstructions(m_asm_buffer, "L%d:\n", m_pending_labels.back()); // L2
+                         m_pending_labels.pop_back();
+                     });
+        }
+        else
+        {
+            schedule([this, first_label]
+                     { dumpInstructions(m_asm_buffer, "L%d:\n", first_label); });
+        }
     }
+    return false;
 }
 
-void CodeGenerator::visit(WhileNode &p_while)
+bool CodeGenerator::enter(WhileNode &p_while)
 {
+    const uint32_t site = m_branch_sites.getSite(p_while);
+
+    int32_t condition;
+    if (foldCondition(p_while.getCondition(), condition) && !condition)
+    {
+        emitEdgeCounter(site, false);
+        return false;
+    }
+
+    const auto *profile = getProfiledSite(site);
+
+    // pops the condition and branches to `p_label` with `p_branch`
+    auto schedule_condition = [&](const char *const p_branch, const int p_label)
+    {
+        schedule(p_while.getCondition());
+        schedule([this, site, p_branch, p_label]
+                 {
+                     const char *const pop_condition =
+                         "    lw t0, 0(sp)\n"
+                         "    addi sp, sp, 4\n";
+
+                     dumpInstructions(m_asm_buffer, pop_condition);
+                     emitEdgeCounter(site, false);
+                     dumpInstructions(m_asm_buffer, p_branch, p_label);
+                 });
+    };
+
+    auto schedule_body = [&]()
+    {
+        schedule([this, site]
+                 { emitEdgeCounter(site, true); });
+        schedule(p_while.getBody());
+    };
+
+    if (profile && profile->taken > 0)
+    {
+        // rotated loop: the back edge is the only branch taken per iteration
+        int body_label = label_num;
+        label_num++;
+        int condition_label = label_num;
+        label_num++;
+        dumpInstructions(m_asm_buffer, "    j L%d\n", condition_label);
+        emitLoopAlignment(*profile);
+        dumpInstructions(m_asm_buffer, "L%d:\n", body_label);
+
+        schedule_body();
+
+        schedule([this, condition_label]
+                 { dumpInstructions(m_asm_buffer, "L%d:\n", condition_label); });
+
+        schedule_condition("    bne t0, zero, L%d\n", body_label);
+        return false;
+    }
+
     int first_label = label_num;
     label_num++;
-    dumpInstructions(m_output_file.get(), "L%d:\n", first_label);
+    dumpInstructions(m_asm_buffer, "L%d:\n", first_label);
 
-    p_while.visitConditionNode(*this);
-
-    const char *const branch_statement =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    beq t0, zero, L%d\n";
+    if (profile) // the body never ran
+    {
+        int cold_label = label_num;
+        label_num++;
+        schedule_condition("    bne t0, zero, L%d\n", cold_label);
+
+        schedule([this, cold_label]
+                 { beginColdBlock(cold_label); });
+        schedule_body();
+        schedule([this, first_label]
+                 {
+                     dumpInstructions(m_asm_buffer, "    j L%d\n", first_label);
+                     endColdBlock();
+                 });
+        return false;
+    }
 
     int second_label = label_num;
     label_num++;
 
-    dumpInstructions(m_output_file.get(), branch_statement, second_label);
+    schedule_condition("    beq t0, zero, L%d\n", second_label);
 
-    p_while.visitBodyNode(*this);
+    schedule_body();
 
-    dumpInstructions(m_output_file.get(), "    j L%d\n", first_label);
+    schedule([this, first_label, second_label]
+             {
+                 dumpInstructions(m_asm_buffer, "    j L%d\n", first_label);
 
-    dumpInstructions(m_output_file.get(), "L%d:\n", second_label);
+                 dumpInstructions(m_asm_buffer, "L%d:\n", second_label);
+             });
+    return false;
 }
 
-void CodeGenerator::visit(ForNode &p_for)
+bool CodeGenerator::enter(ForNode &p_for)
 {
     // Reconstruct the hash table for looking up the symbol entry
     m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
         p_for.getSymbolTable());
 
-    p_for.visitLoopVarInitNodes(*this);
-
-    int first_label = label_num;
-    label_num++;
-    dumpInstructions(m_output_file.get(), "L%d:\n", first_label);
-
-    const SymbolEntry *loop_var_info = m_symbol_manager_ptr->lookup(p_for.getLoopVarName());
-    int loop_var_loc = local_variable_offset[loop_var_info];
+    const uint32_t site = m_branch_sites.getSite(p_for);
+    const auto *profile = getProfiledSite(site);
 
-    const char *const store_loop_var_value_to_stack =
-        "    lw t0, %d(s0)\n"
-        "    addi sp, sp, -4\n"
-        "    sw t0, 0(sp)\n";
+    // kept until the loop is done, for the reductions; the edge counters
+    // need the loop
+    auto scev = std::make_shared<ScalarEvolution>(m_symbol_manager_ptr);
+    const bool has_reductions = m_options.scalar_evolution &&
+                                !m_options.profile_generate &&
+                                scev->analyze(p_for);
+    if (has_reductions && scev->isLoopDead())
+    {
+        emitReductions(p_for, *scev);
+        m_symbol_manager_ptr->removeSymbolsFromHashTable(p_for.getSymbolTable());
+        return false;
+    }
+    if (has_reductions)
+    {
+        for (const auto &reduction : scev->getReductions())
+        {
+            m_folded_statements.insert(reduction.update);
+        }
+    }
 
-    dumpInstructions(m_output_file.get(), store_loop_var_value_to_stack, loop_var_loc);
+    schedule(p_for.getLoopVarDecl());
+    schedule(p_for.getInitStatement());
 
-    p_for.visitEndConditionNode(*this);
+    const SymbolEntry *loop_var_info = m_symbol_manager_ptr->lookup(p_for.getLoopVarName());
+    int loop_var_loc = loop_var_info->getFrameOffset();
 
-    const char *const load_operands =
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    lw t1, 0(sp)\n"
-        "    addi sp, sp, 4\n";
+    // leaves the loop variable in t1 and the upper bound in t0, and branches
+    // to `p_label` with `p_branch`
+    auto schedule_condition = [&](const char *const p_branch, const int p_label)
+    {
+        schedule([this, loop_var_loc]
+                 {
+                     const char *const store_loop_var_value_to_stack =
+                         "    lw t0, %d(s0)\n"
+                         "    addi sp, sp, -4\n"
+                         "    sw t0, 0(sp)\n";
+
+                     dumpInstructions(m_asm_buffer, store_loop_var_value_to_stack, loop_var_loc);
+                 });
+
+        schedule(p_for.getEndCondition());
+
+        schedule([this, site, p_branch, p_label]
+                 {
+                     const char *const load_operands =
+                         "    lw t0, 0(sp)\n"
+                         "    addi sp, sp, 4\n"
+                         "    lw t1, 0(sp)\n"
+                         "    addi sp, sp, 4\n";
+
+                     dumpInstructions(m_asm_buffer, load_operands);
+                     emitEdgeCounter(site, false);
+                     dumpInstructions(m_asm_buffer, p_branch, p_label);
+                 });
+    };
+
+    auto schedule_body = [&]()
+    {
+        schedule([this, site]
+                 { emitEdgeCounter(site, true); });
+        schedule(p_for.getBody());
+
+        schedule([this, loop_var_loc]
+                 {
+                     const char *const add_1_to_loop_var =
+                         "    addi t0, s0, %d\n"
+                         "    addi sp, sp, -4\n"
+                         "    sw t0, 0(sp)\n"
+                         "    lw t0, %d(s0)\n"
+                         "    addi sp, sp, -4\n"
+                         "    sw t0, 0(sp)\n"
+                         "    li t0, 1\n"
+                         "    addi sp, sp, -4\n"
+                         "    sw t0, 0(sp)\n"
+                         "    lw t0, 0(sp)\n"
+                         "    addi sp, sp, 4\n"
+                         "    lw t1, 0(sp)\n"
+                         "    addi sp, sp, 4\n"
+                         "    add t0, t1, t0\n"
+                         "    addi sp, sp, -4\n"
+                         "    sw t0, 0(sp)\n"
+                         "    lw t0, 0(sp)\n"
+                         "    addi sp, sp, 4\n"
+                         "    lw t1, 0(sp)\n"
+                         "    addi sp, sp, 4\n"
+                         "    sw t0, 0(t1)\n";
+
+                     dumpInstructions(m_asm_buffer, add_1_to_loop_var, loop_var_loc, loop_var_loc);
+                 });
+    };
+
+    if (profile && profile->taken > 0)
+    {
+        // rotated loop: the back edge is the only branch taken per iteration
+        int body_label = label_num;
+        label_num++;
+        int condition_label = label_num;
+        label_num++;
+        schedule([this, profile, body_label, condition_label]
+                 {
+                     dumpInstructions(m_asm_buffer, "    j L%d\n", condition_label);
+                     emitLoopAlignment(*profile);
+                     dumpInstructions(m_asm_buffer, "L%d:\n", body_label);
+                 });
 
-    dumpInstructions(m_output_file.get(), load_operands);
+        schedule_body();
 
-    constexpr const char *const branch_statement =
-        "    bge t1, t0, L%d\n";
+        schedule([this, condition_label]
+                 { dumpInstructions(m_asm_buffer, "L%d:\n", condition_label); });
 
-    int second_label = label_num;
-    label_num++;
+        schedule_condition("    blt t1, t0, L%d\n", body_label);
+    }
+    else
+    {
+        int first_label = label_num;
+        label_num++;
+        schedule([this, first_label]
+                 { dumpInstructions(m_asm_buffer, "L%d:\n", first_label); });
 
-    dumpInstructions(m_output_file.get(), branch_statement, second_label);
+        if (profile) // the body never ran
+        {
+            int cold_label = label_num;
+            label_num++;
+            schedule_condition("    blt t1, t0, L%d\n", cold_label);
+
+            schedule([this, cold_label]
+                     { beginColdBlock(cold_label); });
+            schedule_body();
+            schedule([this, first_label]
+                     {
+                         dumpInstructions(m_asm_buffer, "    j L%d\n", first_label);
+                         endColdBlock();
+                     });
+        }
+        else
+        {
+            constexpr const char *const branch_statement =
+                "    bge t1, t0, L%d\n";
 
-    p_for.visitBodyNode(*this);
+            int second_label = label_num;
+            label_num++;
 
-    const char *const add_1_to_loop_var =
-        "    addi t0, s0, %d\n"
-        "    addi sp, sp, -4\n"
-        "    sw t0, 0(sp)\n"
-        "    lw t0, %d(s0)\n"
-        "    addi sp, sp, -4\n"
-        "    sw t0, 0(sp)\n"
-        "    li t0, 1\n"
-        "    addi sp, sp, -4\n"
-        "    sw t0, 0(sp)\n"
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    lw t1, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    add t0, t1, t0\n"
-        "    addi sp, sp, -4\n"
-        "    sw t0, 0(sp)\n"
-        "    lw t0, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    lw t1, 0(sp)\n"
-        "    addi sp, sp, 4\n"
-        "    sw t0, 0(t1)\n";
+            schedule_condition(branch_statement, second_label);
 
-    dumpInstructions(m_output_file.get(), add_1_to_loop_var, loop_var_loc, loop_var_loc);
+            schedule_body();
 
-    dumpInstructions(m_output_file.get(), "    j L%d\n", first_label);
+            schedule([this, first_label, second_label]
+                     {
+                         dumpInstructions(m_asm_buffer, "    j L%d\n", first_label);
 
-    dumpInstructions(m_output_file.get(), "L%d:\n", second_label);
+                         dumpInstructions(m_asm_buffer, "L%d:\n", second_label);
+                     });
+        }
+    }
 
-    // Remove the entries in the hash table
-    m_symbol_manager_ptr->removeSymbolsFromHashTable(p_for.getSymbolTable());
+    schedule([this, &p_for, scev, has_reductions]
+             {
+                 if (has_reductions)
+                 {
+                     emitReductions(p_for, *scev);
+                 }
+
+                 // Remove the entries in the hash table
+                 m_symbol_manager_ptr->removeSymbolsFromHashTable(p_for.getSymbolTable());
+             });
+    return false;
 }
 
-void CodeGenerator::visit(ReturnNode &p_return)
+void CodeGenerator::leave(ReturnNode &)
 {
-    p_return.visitChildNodes(*this);
-
     const char *const load_return_value =
         "    lw t0, 0(sp)\n"
         "    addi sp, sp, 4\n"
         "    mv a0, t0\n";
 
-    dumpInstructions(m_output_file.get(), load_return_value);
+    dumpInstructions(m_asm_buffer, load_return_value);
+
+    if (m_return_label < 0)
+    {
+        m_return_label = label_num;
+        label_num++;
+    }
+    dumpInstructions(m_asm_buffer, "    j L%d\n", m_return_label);
+    m_return_jumps++;
+    m_return_jump_end = m_asm_buffer.size();
 }
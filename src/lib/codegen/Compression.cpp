@@ -0,0 +1,292 @@
+#include "codegen/MachinePasses.hpp"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// The scratch registers t0 ~ t3 are renamed to x8 ~ x15, which the 3-bit
+// register fields of RVC can encode. The stack machine templates only keep
+// t0 ~ t3 alive inside a single template and the argument registers between
+// loading the arguments and the call, so the two never overlap today. That
+// is checked rather than assumed: a scratch register is only renamed in the
+// functions where it is never alive while its replacement holds a value.
+static const char *const kCompressibleScratch[][2] = {
+    {"t0", "a5"}, {"t1", "a4"}, {"t2", "a3"}, {"t3", "a2"}};
+constexpr uint32_t kNumPairs = 4;
+
+// liveness of the registers in kCompressibleScratch: bit 2k is the scratch
+// register of pair k, bit 2k + 1 its replacement
+using RegMask = uint32_t;
+constexpr RegMask kAllTracked = (1u << (2 * kNumPairs)) - 1;
+constexpr RegMask kReplacements = kAllTracked & 0xaaaaaaaa;
+
+static RegMask maskOf(const std::string &p_reg)
+{
+    for (uint32_t k = 0; k < kNumPairs; ++k)
+    {
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            if (p_reg == kCompressibleScratch[k][i])
+                return 1u << (2 * k + i);
+        }
+    }
+    return 0;
+}
+
+// the register of an operand, or of the base of `off(base)`
+static RegMask operandMask(const std::string &p_operand)
+{
+    const auto lparen = p_operand.find('(');
+    if (lparen == std::string::npos)
+        return maskOf(p_operand);
+    return maskOf(p_operand.substr(lparen + 1, p_operand.size() - lparen - 2));
+}
+
+static bool isCall(const MachineInstr &p_instr)
+{
+    const auto &op = p_instr.opcode;
+    return op == "call" ||
+           (op == "jal" &&
+            (p_instr.operands.size() == 1 || p_instr.operands[0] == "ra"));
+}
+
+static bool endsBlock(const MachineInstr &p_instr)
+{
+    const auto &op = p_instr.opcode;
+    return op[0] == 'b' || op == "j" || op == "jr" || op == "ret" ||
+           op == "tail";
+}
+
+// registers written by `p_instr`; calls clobber all of them
+static RegMask getDefs(const MachineInstr &p_instr)
+{
+    const auto &op = p_instr.opcode;
+    if (isCall(p_instr))
+        return kAllTracked;
+    if (p_instr.operands.empty() || endsBlock(p_instr) || op == "sw" ||
+        op == "sh" || op == "sb")
+        return 0;
+    return operandMask(p_instr.operands[0]);
+}
+
+// registers read by `p_instr`, calls aside
+static RegMask getUses(const MachineInstr &p_instr)
+{
+    const auto &op = p_instr.opcode;
+    if (op == "jr" && !p_instr.operands.empty() &&
+        p_instr.operands[0] != "ra")
+        return kAllTracked; // may jump anywhere
+    const bool reads_first =
+        endsBlock(p_instr) || op == "sw" || op == "sh" || op == "sb";
+    RegMask uses = 0;
+    for (uint32_t i = reads_first ? 0 : 1; i < p_instr.operands.size(); ++i)
+        uses |= operandMask(p_instr.operands[i]);
+    return uses;
+}
+
+namespace
+{
+
+struct Block
+{
+    uint32_t begin, end; // [begin, end) in the instruction list
+    std::vector<uint32_t> succs, preds;
+    RegMask live_in = 0, live_out = 0;
+};
+
+} // namespace
+
+// Returns a bit per pair of kCompressibleScratch whose registers are alive
+// at the same time somewhere in `p_instrs`, i.e. one is written while the
+// other holds a value. Calls read the argument registers written since the
+// block or the previous call began: the templates load the arguments right
+// before the call.
+static uint32_t findInterferingPairs(const MachineFunction &p_function)
+{
+    const auto &instrs = p_function.getInstrs();
+
+    std::vector<Block> blocks;
+    std::map<std::string, uint32_t> label_blocks;
+    for (uint32_t i = 0; i < instrs.size(); ++i)
+    {
+        if (blocks.empty() || instrs[i].isLabel() ||
+            (i > 0 && instrs[i - 1].isInstruction() &&
+             endsBlock(instrs[i - 1])))
+        {
+            if (!blocks.empty())
+                blocks.back().end = i;
+            blocks.push_back({i, i, {}, {}});
+        }
+        if (instrs[i].isLabel())
+            label_blocks[instrs[i].opcode] = blocks.size() - 1;
+    }
+    if (blocks.empty())
+        return 0;
+    blocks.back().end = instrs.size();
+
+    // successors; the exits of unknown jumps count as reading everything
+    std::vector<RegMask> exit_uses(blocks.size(), 0);
+    std::vector<RegMask> call_uses(instrs.size(), 0);
+    for (uint32_t b = 0; b < blocks.size(); ++b)
+    {
+        auto &block = blocks[b];
+        RegMask arguments = 0;
+        bool falls_through = true;
+        for (uint32_t i = block.begin; i < block.end; ++i)
+        {
+            const auto &instr = instrs[i];
+            if (!instr.isInstruction())
+                continue;
+            if (isCall(instr))
+            {
+                call_uses[i] = arguments;
+                arguments = 0;
+                continue;
+            }
+            arguments |= getDefs(instr) & kReplacements;
+            if (!endsBlock(instr))
+                continue;
+            const auto &op = instr.opcode;
+            if (op == "jr" || op == "ret" || op == "tail")
+            {
+                falls_through = false;
+                continue;
+            }
+            auto found = label_blocks.find(instr.operands.back());
+            if (found == label_blocks.end())
+                exit_uses[b] = kAllTracked;
+            else
+                block.succs.push_back(found->second);
+            falls_through = op != "j";
+        }
+        if (falls_through && b + 1 < blocks.size())
+            block.succs.push_back(b + 1);
+        for (const uint32_t succ : block.succs)
+            blocks[succ].preds.push_back(b);
+    }
+
+    auto transfer = [&](const uint32_t p_pos, const RegMask p_live) {
+        const auto &instr = instrs[p_pos];
+        if (!instr.isInstruction())
+            return p_live;
+        return (p_live & ~getDefs(instr)) | getUses(instr) | call_uses[p_pos];
+    };
+
+    // the masks only grow, so each block is revisited a bounded number of
+    // times
+    std::vector<uint32_t> worklist;
+    std::vector<bool> queued(blocks.size(), true);
+    for (uint32_t b = blocks.size(); b-- > 0;)
+        worklist.push_back(b);
+    while (!worklist.empty())
+    {
+        const uint32_t b = worklist.back();
+        worklist.pop_back();
+        queued[b] = false;
+
+        auto &block = blocks[b];
+        RegMask live = exit_uses[b];
+        for (const uint32_t succ : block.succs)
+            live |= blocks[succ].live_in;
+        block.live_out = live;
+        for (uint32_t i = block.end; i-- > block.begin;)
+            live = transfer(i, live);
+        if (live == block.live_in)
+            continue;
+        block.live_in = live;
+        for (const uint32_t pred : block.preds)
+        {
+            if (!queued[pred])
+            {
+                queued[pred] = true;
+                worklist.push_back(pred);
+            }
+        }
+    }
+
+    // the caller writes the parameters right before the entry
+    RegMask params = 0;
+    for (uint32_t p = 0; p < p_function.getNumParams() && p < 8; ++p)
+        params |= maskOf("a" + std::to_string(p));
+
+    uint32_t interfering = 0;
+    auto check = [&](const RegMask p_defs, const RegMask p_live) {
+        for (uint32_t k = 0; k < kNumPairs; ++k)
+        {
+            const RegMask scratch = 1u << (2 * k), replacement = scratch << 1;
+            if (((p_defs & scratch) && (p_live & replacement)) ||
+                ((p_defs & replacement) && (p_live & scratch)))
+                interfering |= 1u << k;
+        }
+    };
+    check(params, blocks[0].live_in);
+    for (const auto &block : blocks)
+    {
+        RegMask live = block.live_out;
+        for (uint32_t i = block.end; i-- > block.begin;)
+        {
+            if (instrs[i].isInstruction())
+                check(getDefs(instrs[i]), live);
+            live = transfer(i, live);
+        }
+    }
+    return interfering;
+}
+
+static void renameRegister(std::string &p_operand, const uint32_t p_pairs)
+{
+    const auto lparen = p_operand.find('(');
+    if (lparen != std::string::npos)
+    {
+        // memory operand: `off(base)`
+        std::string base =
+            p_operand.substr(lparen + 1, p_operand.size() - lparen - 2);
+        renameRegister(base, p_pairs);
+        p_operand = p_operand.substr(0, lparen + 1) + base + ")";
+        return;
+    }
+
+    for (uint32_t k = 0; k < kNumPairs; ++k)
+    {
+        if ((p_pairs & (1u << k)) && p_operand == kCompressibleScratch[k][0])
+        {
+            p_operand = kCompressibleScratch[k][1];
+            return;
+        }
+    }
+}
+
+static bool isCommutative(const std::string &p_opcode)
+{
+    return p_opcode == "add" || p_opcode == "and" || p_opcode == "or" ||
+           p_opcode == "xor" || p_opcode == "mul";
+}
+
+void compressFunction(MachineFunction &p_function,
+                      const CodeGenOptions &p_options)
+{
+    if (!p_options.compressed)
+        return;
+
+    const uint32_t renamed =
+        ~findInterferingPairs(p_function) & ((1u << kNumPairs) - 1);
+    for (auto &instr : p_function.getInstrs())
+    {
+        if (!instr.isInstruction())
+            continue;
+
+        auto &operands = instr.operands;
+        for (auto &operand : operands)
+        {
+            renameRegister(operand, renamed);
+        }
+
+        // c.add/c.and/... are two-address forms: rd must equal rs1
+        if (isCommutative(instr.opcode) && operands.size() == 3 &&
+            operands[0] == operands[2] && operands[0] != operands[1])
+        {
+            std::swap(operands[1], operands[2]);
+        }
+    }
+}
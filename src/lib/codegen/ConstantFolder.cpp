@@ -0,0 +1,190 @@
+#include "codegen/ConstantFolder.hpp"
+#include "codegen/PureCallEvaluator.hpp"
+#include "sema/SymbolTable.hpp"
+#include "visitor/AstNodeInclude.hpp"
+
+#include <cstring>
+#include <limits>
+#include <vector>
+
+bool ConstantFolder::evaluate(const ExpressionNode &p_expr, int32_t &p_value)
+{
+    m_known = true;
+    m_values.clear();
+    walk(p_expr);
+    if (m_known)
+        p_value = m_values.back();
+    return m_known;
+}
+
+void ConstantFolder::giveUp()
+{
+    m_known = false;
+    stop();
+}
+
+int32_t ConstantFolder::pop()
+{
+    const int32_t value = m_values.back();
+    m_values.pop_back();
+    return value;
+}
+
+bool ConstantFolder::enter(ConstantValueNode &p_constant_value)
+{
+    const PType *type = p_constant_value.getTypePtr();
+    if (type->isInteger())
+    {
+        // `li` keeps the low 32 bits
+        m_values.push_back(static_cast<int32_t>(
+            static_cast<uint32_t>(p_constant_value.getConstantPtr()->integer())));
+    }
+    else if (type->isBool())
+    {
+        m_values.push_back(
+            strcmp(p_constant_value.getConstantValueCString(), "true") == 0);
+    }
+    else
+    {
+        giveUp();
+    }
+    return false;
+}
+
+bool ConstantFolder::enter(VariableReferenceNode &p_variable_ref)
+{
+    if (!p_variable_ref.getIndices().empty())
+    {
+        giveUp();
+        return false;
+    }
+
+    const SymbolEntry *entry = m_symbol_manager_ptr->lookup(p_variable_ref.getName());
+    auto found = m_bindings.find(entry);
+    if (found != m_bindings.end())
+    {
+        m_values.push_back(found->second);
+        return false;
+    }
+
+    const Constant *constant = entry->getKind() == SymbolEntry::KindEnum::kConstantKind
+                                   ? entry->getAttribute().constant()
+                                   : nullptr;
+    if (constant && constant->getTypePtr()->isInteger())
+    {
+        m_values.push_back(static_cast<int32_t>(static_cast<uint32_t>(constant->integer())));
+    }
+    else if (constant && constant->getTypePtr()->isBool())
+    {
+        m_values.push_back(strcmp(constant->getConstantValueCString(), "true") == 0);
+    }
+    else
+    {
+        giveUp();
+    }
+    return false;
+}
+
+bool ConstantFolder::enter(FunctionInvocationNode &)
+{
+    if (!m_calls)
+    {
+        giveUp();
+        return false;
+    }
+    return true;
+}
+
+void ConstantFolder::leave(FunctionInvocationNode &p_func_invocation)
+{
+    const auto num_args = p_func_invocation.getArguments().size();
+    const std::vector<int32_t> args(m_values.end() - num_args, m_values.end());
+    m_values.resize(m_values.size() - num_args);
+
+    int32_t value;
+    if (!m_calls->call(p_func_invocation, args, value))
+    {
+        giveUp();
+        return;
+    }
+    m_values.push_back(value);
+}
+
+void ConstantFolder::leave(UnaryOperatorNode &p_un_op)
+{
+    const int32_t operand = pop();
+
+    switch (p_un_op.getOp())
+    {
+    case Operator::kNegOp:
+        m_values.push_back(static_cast<int32_t>(0u - static_cast<uint32_t>(operand)));
+        break;
+    case Operator::kNotOp:
+        m_values.push_back(operand ^ 1);
+        break;
+    default:
+        giveUp();
+    }
+}
+
+void ConstantFolder::leave(BinaryOperatorNode &p_bin_op)
+{
+    const int32_t right = pop();
+    const int32_t left = pop();
+
+    // wrap around like the 32-bit instructions do
+    const uint32_t ul = left, ur = right;
+    int32_t value;
+    switch (p_bin_op.getOp())
+    {
+    case Operator::kMultiplyOp:
+        value = static_cast<int32_t>(ul * ur);
+        break;
+    case Operator::kDivideOp:
+    case Operator::kModOp:
+        // leave the corner cases to the hardware
+        if (right == 0 ||
+            (left == std::numeric_limits<int32_t>::min() && right == -1))
+        {
+            giveUp();
+            return;
+        }
+        value = p_bin_op.getOp() == Operator::kDivideOp ? left / right
+                                                        : left % right;
+        break;
+    case Operator::kPlusOp:
+        value = static_cast<int32_t>(ul + ur);
+        break;
+    case Operator::kMinusOp:
+        value = static_cast<int32_t>(ul - ur);
+        break;
+    case Operator::kLessOp:
+        value = left < right;
+        break;
+    case Operator::kLessOrEqualOp:
+        value = left <= right;
+        break;
+    case Operator::kGreaterOp:
+        value = left > right;
+        break;
+    case Operator::kGreaterOrEqualOp:
+        value = left >= right;
+        break;
+    case Operator::kEqualOp:
+        value = left == right;
+        break;
+    case Operator::kNotEqualOp:
+        value = left != right;
+        break;
+    case Operator::kAndOp:
+        value = left & right;
+        break;
+    case Operator::kOrOp:
+        value = left | right;
+        break;
+    default:
+        giveUp();
+        return;
+    }
+    m_values.push_back(value);
+}
@@ -0,0 +1,149 @@
+#include "codegen/FrameLayout.hpp"
+#include "sema/SymbolTable.hpp"
+#include "visitor/AstNodeInclude.hpp"
+
+#include <algorithm>
+
+// ra and s0 are saved at -4(s0) and -8(s0)
+static constexpr int kFirstSlotOffset = -12;
+static constexpr int kSlotSize = 4;
+// the ninth argument onwards is passed on the caller's stack, at 0(s0) up
+static constexpr uint32_t kNumRegisterParams = 8;
+
+void FrameLayout::run(AstNode &p_root)
+{
+    walk(p_root);
+    assignSlots();
+}
+
+int FrameLayout::getEndOffset() const
+{
+    return kFirstSlotOffset - kSlotSize * (int)m_num_slots;
+}
+
+void FrameLayout::reference(const SymbolEntry *p_entry)
+{
+    ++m_position;
+    auto inserted = m_ranges.emplace(p_entry, LiveRange{m_position, m_position});
+    if (inserted.second)
+        m_locals.emplace_back(p_entry);
+    else
+        inserted.first->second.end = m_position;
+}
+
+void FrameLayout::extendOverLoop(const uint32_t p_begin)
+{
+    for (auto &entry_range : m_ranges)
+    {
+        auto &range = entry_range.second;
+        if (range.end > p_begin)
+        {
+            range.begin = std::min(range.begin, p_begin + 1);
+            range.end = std::max(range.end, m_position);
+        }
+    }
+}
+
+void FrameLayout::assignSlots()
+{
+    std::stable_sort(m_locals.begin(), m_locals.end(),
+                     [&](const SymbolEntry *p_a, const SymbolEntry *p_b) {
+                         return m_ranges[p_a].begin < m_ranges[p_b].begin;
+                     });
+
+    const uint32_t first_slot = std::min(m_num_params, kNumRegisterParams);
+    // end of the live range last assigned to each slot
+    std::vector<uint32_t> slot_ends;
+    for (const SymbolEntry *local : m_locals)
+    {
+        const auto &range = m_ranges[local];
+        uint32_t slot = 0;
+        while (slot < slot_ends.size() && slot_ends[slot] >= range.begin)
+            ++slot;
+        if (slot == slot_ends.size())
+            slot_ends.emplace_back(0);
+        slot_ends[slot] = range.end;
+
+        local->setFrameOffset(kFirstSlotOffset -
+                              kSlotSize * (int)(first_slot + slot));
+    }
+    m_num_slots = first_slot + slot_ends.size();
+}
+
+bool FrameLayout::enter(VariableNode &p_variable)
+{
+    const SymbolEntry *entry = m_symbol_manager_ptr->lookup(p_variable.getName());
+
+    if (entry->getKind() == SymbolEntry::KindEnum::kParameterKind)
+    {
+        const uint32_t index = m_num_params++;
+        entry->setFrameOffset(index < kNumRegisterParams
+                                  ? kFirstSlotOffset - kSlotSize * (int)index
+                                  : kSlotSize * (int)(index - kNumRegisterParams));
+        return false;
+    }
+
+    // a constant is stored to its slot where it is declared
+    if (p_variable.getConstantPtr())
+        reference(entry);
+    return false;
+}
+
+bool FrameLayout::enter(FunctionNode &p_function)
+{
+    m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(p_function.getSymbolTable());
+    return true;
+}
+
+void FrameLayout::leave(FunctionNode &p_function)
+{
+    m_symbol_manager_ptr->removeSymbolsFromHashTable(p_function.getSymbolTable());
+}
+
+bool FrameLayout::enter(CompoundStatementNode &p_compound_statement)
+{
+    m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+        p_compound_statement.getSymbolTable());
+    return true;
+}
+
+void FrameLayout::leave(CompoundStatementNode &p_compound_statement)
+{
+    m_symbol_manager_ptr->removeSymbolsFromHashTable(
+        p_compound_statement.getSymbolTable());
+}
+
+void FrameLayout::leave(VariableReferenceNode &p_variable_ref)
+{
+    const SymbolEntry *entry = m_symbol_manager_ptr->lookup(p_variable_ref.getName());
+    if (entry->getLevel() != 0 &&
+        entry->getKind() != SymbolEntry::KindEnum::kParameterKind)
+        reference(entry);
+}
+
+bool FrameLayout::enter(WhileNode &)
+{
+    m_loop_begins.push_back(m_position);
+    return true;
+}
+
+void FrameLayout::leave(WhileNode &)
+{
+    extendOverLoop(m_loop_begins.back());
+    m_loop_begins.pop_back();
+}
+
+bool FrameLayout::enter(ForNode &p_for)
+{
+    m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(p_for.getSymbolTable());
+    m_loop_begins.push_back(m_position);
+    return true;
+}
+
+void FrameLayout::leave(ForNode &p_for)
+{
+    extendOverLoop(m_loop_begins.back());
+    m_loop_begins.pop_back();
+
+    m_symbol_manager_ptr->removeSymbolsFromHashTable(p_for.getSymbolTable());
+}
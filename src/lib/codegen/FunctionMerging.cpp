@@ -0,0 +1,102 @@
+#include "codegen/MachinePasses.hpp"
+
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Identical function merging: functions whose lowered bodies are the same up
+// to their own name and the numbering of their local labels are folded into
+// the first one, and the others become aliases of it.
+
+// Renders the body of `p_function` without anything that depends on its
+// name, so that two functions compare equal iff they behave the same.
+static std::string canonicalize(const MachineFunction &p_function)
+{
+    const auto &name = p_function.getName();
+    std::set<std::string> local_labels;
+    for (const auto &instr : p_function.getInstrs())
+    {
+        if (instr.isLabel() && instr.opcode != name)
+            local_labels.insert(instr.opcode);
+    }
+
+    std::map<std::string, std::string> label_map;
+    auto canonical_label = [&](const std::string &p_label) {
+        auto inserted = label_map.emplace(
+            p_label, ".L" + std::to_string(label_map.size()));
+        return inserted.first->second;
+    };
+
+    std::string text;
+    for (const auto &instr : p_function.getInstrs())
+    {
+        if (instr.isDirective())
+        {
+            // .globl/.type/.size carry the name
+            if (instr.opcode.find(name) == std::string::npos)
+                text += instr.opcode + "\n";
+            continue;
+        }
+        if (instr.isLabel())
+        {
+            if (instr.opcode != name)
+                text += canonical_label(instr.opcode) + ":\n";
+            continue;
+        }
+
+        text += instr.opcode;
+        for (const auto &operand : instr.operands)
+        {
+            if (operand == name)
+                text += " <self>";
+            else if (local_labels.count(operand))
+                text += " " + canonical_label(operand);
+            else
+                text += " " + operand;
+        }
+        text += "\n";
+    }
+    return text;
+}
+
+void mergeIdenticalFunctions(MachineModule &p_module,
+                             const CodeGenOptions &p_options)
+{
+    if (!p_options.merge_functions)
+        return;
+
+    // hash -> (canonical body, function that keeps it)
+    std::unordered_multimap<size_t, std::pair<std::string, MachineFunction *>>
+        bodies;
+
+    for (auto &function : p_module.getFunctions())
+    {
+        if (function->getName() == "main")
+            continue;
+
+        std::string body = canonicalize(*function);
+        const size_t hash = std::hash<std::string>{}(body);
+
+        MachineFunction *target = nullptr;
+        auto range = bodies.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second.first == body)
+            {
+                target = it->second.second;
+                break;
+            }
+        }
+
+        if (!target)
+        {
+            bodies.emplace(hash, std::make_pair(std::move(body), function.get()));
+            continue;
+        }
+
+        function->makeAliasOf(target->getName());
+    }
+}
@@ -0,0 +1,119 @@
+#include "codegen/IfConversion.hpp"
+#include "sema/SymbolTable.hpp"
+#include "visitor/AstNodeInclude.hpp"
+
+#include <cstring>
+
+// operators and operands each arm may have; both are always computed
+static constexpr uint32_t kMaxArmNodes = 5;
+
+const AssignmentNode *
+IfConversion::getOnlyAssignment(const CompoundStatementNode *p_arm)
+{
+    if (!p_arm || !p_arm->getDeclNodes().empty() || p_arm->getStmtNodes().size() != 1)
+        return nullptr;
+    return dynamic_cast<const AssignmentNode *>(p_arm->getStmtNodes()[0]);
+}
+
+bool IfConversion::isSpeculatable(const ExpressionNode &p_expr) const
+{
+    // the operands of an expression follow it up to the end of its subtree
+    const FlatAst::Index root = m_flat_ast.indexOf(p_expr);
+    const FlatAst::Index end = m_flat_ast.getSubtreeEnd(root);
+    if (end - root > kMaxArmNodes)
+        return false;
+
+    for (FlatAst::Index node = root; node < end; ++node)
+    {
+        switch (m_flat_ast.getKind(node))
+        {
+        case FlatAst::Kind::kFunctionInvocation:
+            return false;
+        case FlatAst::Kind::kVariableReference:
+            if (m_flat_ast.getNumOperands(node) != 0)
+                return false;
+            break;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+bool IfConversion::isSameValue(const ExpressionNode &p_a,
+                               const ExpressionNode &p_b) const
+{
+    const auto *ref_a = dynamic_cast<const VariableReferenceNode *>(&p_a);
+    const auto *ref_b = dynamic_cast<const VariableReferenceNode *>(&p_b);
+    if (ref_a && ref_b)
+    {
+        return ref_a->getIndices().empty() && ref_b->getIndices().empty() &&
+               m_symbol_manager_ptr->lookup(ref_a->getName()) ==
+                   m_symbol_manager_ptr->lookup(ref_b->getName());
+    }
+
+    const auto *constant_a = dynamic_cast<const ConstantValueNode *>(&p_a);
+    const auto *constant_b = dynamic_cast<const ConstantValueNode *>(&p_b);
+    return constant_a && constant_b &&
+           strcmp(constant_a->getConstantValueCString(),
+                  constant_b->getConstantValueCString()) == 0;
+}
+
+bool IfConversion::analyze(const IfNode &p_if)
+{
+    // the arms have no declarations, so their names resolve in the scope
+    // of the if statement
+    const AssignmentNode *then_arm = getOnlyAssignment(&p_if.getBody());
+    const AssignmentNode *else_arm = getOnlyAssignment(p_if.getElseBody());
+    if (!then_arm || !else_arm)
+        return false;
+
+    const VariableReferenceNode &target = then_arm->getLvalue();
+    if (!target.getIndices().empty() || !else_arm->getLvalue().getIndices().empty())
+        return false;
+    const SymbolEntry *entry = m_symbol_manager_ptr->lookup(target.getName());
+    if (entry != m_symbol_manager_ptr->lookup(else_arm->getLvalue().getName()) ||
+        !(entry->getTypePtr()->isInteger() || entry->getTypePtr()->isBool()))
+        return false;
+
+    if (!isSpeculatable(then_arm->getExpr()) || !isSpeculatable(else_arm->getExpr()))
+        return false;
+
+    m_target = &target;
+    m_then_value = &then_arm->getExpr();
+    m_else_value = &else_arm->getExpr();
+    m_kind = Kind::kSelect;
+
+    // `if a > b then x := a else x := b` and the like
+    const auto *compare = dynamic_cast<const BinaryOperatorNode *>(&p_if.getCondition());
+    if (!compare || !entry->getTypePtr()->isInteger())
+        return true;
+
+    bool picks_greater;
+    switch (compare->getOp())
+    {
+    case Operator::kGreaterOp:
+    case Operator::kGreaterOrEqualOp:
+        picks_greater = true;
+        break;
+    case Operator::kLessOp:
+    case Operator::kLessOrEqualOp:
+        picks_greater = false;
+        break;
+    default:
+        return true;
+    }
+
+    // on a tie both arms assign the same value
+    if (isSameValue(compare->getLeftOperand(), *m_then_value) &&
+        isSameValue(compare->getRightOperand(), *m_else_value))
+    {
+        m_kind = picks_greater ? Kind::kMax : Kind::kMin;
+    }
+    else if (isSameValue(compare->getLeftOperand(), *m_else_value) &&
+             isSameValue(compare->getRightOperand(), *m_then_value))
+    {
+        m_kind = picks_greater ? Kind::kMin : Kind::kMax;
+    }
+    return true;
+}
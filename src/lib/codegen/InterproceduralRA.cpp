@@ -0,0 +1,521 @@
+#include "codegen/MachinePasses.hpp"
+
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Interprocedural register allocation.
+//
+// Under the standard convention every call clobbers all caller-saved
+// registers, and the arguments arrive in a0 ~ a7 whatever the callee does
+// with them. With -fipra the functions defined in the program are private to
+// it, so the call graph is complete: each function records the registers it
+// and its callees actually write, its arguments move to registers outside
+// that set, and stored values are forwarded to later loads across every call
+// that leaves their register alone.
+
+namespace
+{
+
+using RegMask = uint32_t;
+
+const char *const kRegisterNames[] = {
+    "zero", "ra", "sp", "gp", "tp",  "t0",  "t1", "t2", "s0", "s1", "a0",
+    "a1",   "a2", "a3", "a4", "a5",  "a6",  "a7", "s2", "s3", "s4", "s5",
+    "s6",   "s7", "s8", "s9", "s10", "s11", "t3", "t4", "t5", "t6"};
+
+// -1 if `p_name` isn't a register
+int findRegister(const std::string &p_name)
+{
+    if (p_name == "fp")
+        return 8;
+    for (int i = 0; i < 32; ++i)
+    {
+        if (p_name == kRegisterNames[i])
+            return i;
+    }
+    return -1;
+}
+
+RegMask maskOf(const std::string &p_name)
+{
+    const int reg = findRegister(p_name);
+    return (reg < 0) ? 0 : (1u << reg);
+}
+
+RegMask maskOf(const std::vector<const char *> &p_names)
+{
+    RegMask mask = 0;
+    for (const char *name : p_names)
+        mask |= maskOf(name);
+    return mask;
+}
+
+const RegMask kCallerSaved =
+    maskOf({"ra", "t0", "t1", "t2", "t3", "t4", "t5", "t6", "a0", "a1", "a2",
+            "a3", "a4", "a5", "a6", "a7"});
+// restored by the epilogue
+const RegMask kPreserved = maskOf({"zero", "sp", "s0"});
+
+// Registers arguments may be passed in, in order of preference. t0 is left
+// out since the outliner links through it.
+const char *const kArgumentPool[] = {"a0", "a1", "a2", "a3", "a4",
+                                     "a5", "a6", "a7", "t1", "t2",
+                                     "t3", "t4", "t5", "t6"};
+
+// Functions with more parameters take the rest on the stack as the psABI
+// says, and keep the standard convention.
+constexpr uint32_t kMaxRegisterParams = 8;
+
+// the register the code generator passes argument `p_idx` in
+std::string standardArgument(const uint32_t p_idx)
+{
+    return "a" + std::to_string(p_idx);
+}
+
+bool isStore(const std::string &p_opcode)
+{
+    return p_opcode == "sw" || p_opcode == "sh" || p_opcode == "sb";
+}
+
+// `jal ra, f`, `jal f` and `call f`
+bool getCallee(const MachineInstr &p_instr, std::string &p_callee)
+{
+    if (!p_instr.isInstruction() || p_instr.operands.empty())
+        return false;
+    const auto &op = p_instr.opcode;
+    if (op == "call" ||
+        (op == "jal" &&
+         (p_instr.operands.size() == 1 || p_instr.operands[0] == "ra")))
+    {
+        p_callee = p_instr.operands.back();
+        return true;
+    }
+    return false;
+}
+
+// registers written by `p_instr` itself, i.e. not by the callee of a call
+RegMask getDefs(const MachineInstr &p_instr)
+{
+    if (!p_instr.isInstruction() || p_instr.operands.empty())
+        return 0;
+    const auto &op = p_instr.opcode;
+    if (isStore(op) || op[0] == 'b' || op == "j" || op == "jr" ||
+        op == "tail")
+        return 0;
+    if (op == "call" || (op == "jal" && p_instr.operands.size() == 1))
+        return maskOf("ra");
+    return maskOf(p_instr.operands[0]);
+}
+
+// splits `off(base)`
+bool parseMemoryOperand(const std::string &p_str, long &p_offset,
+                        std::string &p_base)
+{
+    const auto lparen = p_str.find('(');
+    if (lparen == std::string::npos)
+        return false;
+    p_base = p_str.substr(lparen + 1, p_str.size() - lparen - 2);
+    p_offset = lparen ? std::strtol(p_str.substr(0, lparen).c_str(), nullptr, 0)
+                      : 0;
+    return true;
+}
+
+struct FunctionInfo
+{
+    MachineFunction *function;
+    bool is_private;
+    RegMask clobbers = 0;
+    std::vector<std::string> callees;
+};
+
+using FunctionInfos = std::map<std::string, FunctionInfo>;
+
+RegMask getCallClobbers(const FunctionInfos &p_infos,
+                        const std::string &p_callee)
+{
+    auto found = p_infos.find(p_callee);
+    if (found == p_infos.end() || !found->second.is_private)
+        return kCallerSaved;
+    return found->second.clobbers | maskOf("ra");
+}
+
+// Clobber sets only grow, so iterating to a fixed point handles recursion.
+void computeClobbers(FunctionInfos &p_infos)
+{
+    for (auto &entry : p_infos)
+    {
+        auto &info = entry.second;
+        info.clobbers = 0;
+        info.callees.clear();
+        for (const auto &instr : info.function->getInstrs())
+        {
+            std::string callee;
+            if (getCallee(instr, callee))
+                info.callees.emplace_back(callee);
+            info.clobbers |= getDefs(instr);
+        }
+        info.clobbers &= ~kPreserved;
+    }
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (auto &entry : p_infos)
+        {
+            auto &info = entry.second;
+            RegMask clobbers = info.clobbers;
+            for (const auto &callee : info.callees)
+                clobbers |= getCallClobbers(p_infos, callee);
+            clobbers &= ~kPreserved;
+            if (clobbers != info.clobbers)
+            {
+                info.clobbers = clobbers;
+                changed = true;
+            }
+        }
+    }
+}
+
+// ===========================================
+// > Calling convention
+// ===========================================
+
+// index of the `sw` that stores the first argument to the frame
+int findParameterStores(const MachineFunction &p_function)
+{
+    const auto &instrs = p_function.getInstrs();
+    for (uint32_t i = 0; i < instrs.size(); ++i)
+    {
+        const auto &instr = instrs[i];
+        if (instr.isInstruction() && instr.opcode == "addi" &&
+            findRegister(instr.operands[0]) == 8 && instr.operands[1] == "sp")
+        {
+            const uint32_t first = i + 1;
+            for (uint32_t p = 0; p < p_function.getNumParams(); ++p)
+            {
+                if (first + p >= instrs.size())
+                    return -1;
+                const auto &store = instrs[first + p];
+                if (!store.isInstruction() || store.opcode != "sw" ||
+                    store.operands[0] != standardArgument(p))
+                    return -1;
+            }
+            return first;
+        }
+    }
+    return -1;
+}
+
+// Call sites pop the arguments right before the call, the last one first:
+// `lw <reg>, 0(sp)` and `addi sp, sp, 4` for each of them.
+bool isArgumentSequence(const MachineFunction::Instrs &p_instrs,
+                        const uint32_t p_call, const uint32_t p_num_params)
+{
+    if (p_call < 2 * p_num_params)
+        return false;
+    uint32_t pos = p_call - 2 * p_num_params;
+    for (uint32_t p = p_num_params; p-- > 0;)
+    {
+        const auto &load = p_instrs[pos];
+        const auto &pop = p_instrs[pos + 1];
+        if (!load.isInstruction() || load.opcode != "lw" ||
+            load.operands[0] != standardArgument(p) ||
+            load.operands[1] != "0(sp)")
+            return false;
+        if (!pop.isInstruction() || pop.opcode != "addi" ||
+            pop.operands[0] != "sp" || pop.operands[1] != "sp" ||
+            pop.operands[2] != "4")
+            return false;
+        pos += 2;
+    }
+    return true;
+}
+
+// Prefers the standard register of each argument, then registers that the
+// callee doesn't clobber, so that its own loads of the arguments can be
+// forwarded across the calls it makes.
+std::vector<std::string> assignArguments(const uint32_t p_num_params,
+                                         const RegMask p_clobbers)
+{
+    std::vector<std::string> assigned(p_num_params);
+    RegMask taken = 0;
+    for (uint32_t p = 0; p < p_num_params; ++p)
+    {
+        if (!(p_clobbers & maskOf(standardArgument(p))))
+        {
+            assigned[p] = standardArgument(p);
+            taken |= maskOf(assigned[p]);
+        }
+    }
+
+    for (const bool allow_clobbered : {false, true})
+    {
+        for (uint32_t p = 0; p < p_num_params; ++p)
+        {
+            if (!assigned[p].empty())
+                continue;
+            // a clobbered standard register is still as good as any other
+            if (allow_clobbered && !(taken & maskOf(standardArgument(p))))
+            {
+                assigned[p] = standardArgument(p);
+                taken |= maskOf(assigned[p]);
+                continue;
+            }
+            for (const char *reg : kArgumentPool)
+            {
+                const RegMask mask = maskOf(reg);
+                if ((taken & mask) || (!allow_clobbered && (p_clobbers & mask)))
+                    continue;
+                assigned[p] = reg;
+                taken |= mask;
+                break;
+            }
+        }
+    }
+    return assigned;
+}
+
+void assignCallingConventions(MachineModule &p_module, FunctionInfos &p_infos)
+{
+    for (auto &entry : p_infos)
+    {
+        auto &info = entry.second;
+        auto &callee = *info.function;
+        const uint32_t num_params = callee.getNumParams();
+        if (!info.is_private || num_params == 0 ||
+            num_params > kMaxRegisterParams)
+            continue;
+
+        const int first_store = findParameterStores(callee);
+        if (first_store < 0)
+            continue;
+
+        // every call site must be rewritten, or none
+        std::vector<std::pair<MachineFunction *, uint32_t>> sites;
+        bool rewritable = true;
+        for (auto &caller : p_module.getFunctions())
+        {
+            auto &instrs = caller->getInstrs();
+            for (uint32_t i = 0; i < instrs.size(); ++i)
+            {
+                std::string target;
+                if (!getCallee(instrs[i], target) ||
+                    target != callee.getName())
+                    continue;
+                if (!isArgumentSequence(instrs, i, num_params))
+                    rewritable = false;
+                sites.emplace_back(caller.get(), i);
+            }
+        }
+        if (!rewritable)
+            continue;
+
+        const auto assigned = assignArguments(num_params, info.clobbers);
+
+        auto &stores = callee.getInstrs();
+        for (uint32_t p = 0; p < num_params; ++p)
+            stores[first_store + p].operands[0] = assigned[p];
+
+        for (const auto &site : sites)
+        {
+            auto &instrs = site.first->getInstrs();
+            uint32_t pos = site.second - 2 * num_params;
+            for (uint32_t p = num_params; p-- > 0;)
+            {
+                instrs[pos].operands[0] = assigned[p];
+                pos += 2;
+            }
+        }
+    }
+}
+
+// callers outside the program would expect the standard convention
+void makeLocal(MachineFunction &p_function)
+{
+    const std::string globl = ".globl " + p_function.getName();
+    auto &instrs = p_function.getInstrs();
+    for (auto it = instrs.begin(); it != instrs.end(); ++it)
+    {
+        const auto &text = it->opcode;
+        const auto pos = text.find(globl);
+        if (it->isDirective() && pos != std::string::npos &&
+            pos + globl.size() == text.size())
+        {
+            instrs.erase(it);
+            return;
+        }
+    }
+}
+
+// ===========================================
+// > Store-to-load forwarding
+// ===========================================
+
+// The frame below s0 and the stack below sp belong to this function only:
+// the program takes no addresses other than those of its variables, and
+// only the assignment templates store through them. So the values tracked
+// in the frame survive every call, and only the registers holding them may
+// not. The slots on top of the stack may hold arguments, which the callee
+// owns until it returns.
+void forwardStores(MachineFunction &p_function, const FunctionInfos &p_infos)
+{
+    // (s0 or sp, offset) -> register holding the value stored there; sp
+    // offsets are relative to sp at the start of the block
+    std::map<std::pair<int, long>, int> values;
+    long sp_displacement = 0;
+    const int kSp = findRegister("sp"), kFp = findRegister("s0");
+
+    auto kill_registers = [&](const RegMask p_mask) {
+        for (auto it = values.begin(); it != values.end();)
+        {
+            if (p_mask & (1u << it->second))
+                it = values.erase(it);
+            else
+                ++it;
+        }
+    };
+    auto kill_base = [&](const int p_base) {
+        for (auto it = values.begin(); it != values.end();)
+        {
+            if (it->first.first == p_base)
+                it = values.erase(it);
+            else
+                ++it;
+        }
+    };
+
+    MachineFunction::Instrs rewritten;
+    for (auto &instr : p_function.getInstrs())
+    {
+        if (!instr.isInstruction())
+        {
+            // anything may jump to a label
+            values.clear();
+            sp_displacement = 0;
+            rewritten.emplace_back(std::move(instr));
+            continue;
+        }
+
+        const auto &op = instr.opcode;
+        std::string callee;
+        if (getCallee(instr, callee))
+        {
+            kill_registers(getCallClobbers(p_infos, callee));
+            for (auto it = values.begin(); it != values.end();)
+            {
+                if (it->first.first == kSp && it->first.second >= sp_displacement)
+                    it = values.erase(it);
+                else
+                    ++it;
+            }
+            rewritten.emplace_back(std::move(instr));
+            continue;
+        }
+
+        long offset = 0;
+        std::string base_name;
+        const bool is_memory = instr.operands.size() == 2 &&
+                               parseMemoryOperand(instr.operands[1], offset,
+                                                  base_name);
+        const int base = is_memory ? findRegister(base_name) : -1;
+        const bool tracked = base == kSp || base == kFp;
+        const auto key =
+            std::make_pair(base, base == kSp ? offset + sp_displacement : offset);
+
+        if (op == "sw" && tracked)
+        {
+            values[key] = findRegister(instr.operands[0]);
+            rewritten.emplace_back(std::move(instr));
+            continue;
+        }
+        if (isStore(op))
+        {
+            // may write any variable whose address was taken
+            kill_base(tracked ? base : kFp);
+            rewritten.emplace_back(std::move(instr));
+            continue;
+        }
+
+        const int dest = findRegister(instr.operands.empty() ? ""
+                                                             : instr.operands[0]);
+        if (op == "lw" && tracked && dest != kSp && dest != kFp)
+        {
+            auto found = values.find(key);
+            if (found != values.end())
+            {
+                if (found->second != dest)
+                {
+                    kill_registers(1u << dest);
+                    rewritten.emplace_back(
+                        "mv", std::vector<std::string>{instr.operands[0],
+                                                       kRegisterNames[found->second]});
+                }
+                // a load into the register that already holds the value
+                // is dropped
+                continue;
+            }
+            kill_registers(1u << dest);
+            values[key] = dest;
+            rewritten.emplace_back(std::move(instr));
+            continue;
+        }
+
+        if (op == "addi" && dest == kSp && instr.operands[1] == "sp")
+        {
+            sp_displacement += std::strtol(instr.operands[2].c_str(), nullptr, 0);
+        }
+        else
+        {
+            const RegMask defs = getDefs(instr);
+            kill_registers(defs);
+            if (defs & (1u << kSp))
+                kill_base(kSp);
+            if (defs & (1u << kFp))
+                kill_base(kFp);
+        }
+
+        const bool ends_block = op == "j" || op == "jr" || op == "ret" ||
+                                op == "tail" || op == "ecall";
+        rewritten.emplace_back(std::move(instr));
+        if (ends_block)
+        {
+            values.clear();
+            sp_displacement = 0;
+        }
+    }
+    p_function.getInstrs() = std::move(rewritten);
+}
+
+} // namespace
+
+void allocateInterprocedural(MachineModule &p_module,
+                             const CodeGenOptions &p_options)
+{
+    if (!p_options.ipra)
+        return;
+
+    FunctionInfos infos;
+    for (auto &function : p_module.getFunctions())
+    {
+        FunctionInfo info;
+        info.function = function.get();
+        info.is_private = !function->isExported() && function->getName() != "main";
+        infos.emplace(function->getName(), info);
+    }
+
+    computeClobbers(infos);
+    assignCallingConventions(p_module, infos);
+    // callers now write the registers their callees take arguments in
+    computeClobbers(infos);
+
+    for (auto &entry : infos)
+    {
+        if (entry.second.is_private)
+            makeLocal(*entry.second.function);
+        forwardStores(*entry.second.function, infos);
+    }
+}
@@ -0,0 +1,254 @@
+#include "codegen/MachineFunction.hpp"
+
+#include <cstdlib>
+#include <sstream>
+
+static std::string trim(const std::string &p_str)
+{
+    const auto first = p_str.find_first_not_of(" \t");
+    if (first == std::string::npos)
+        return "";
+    const auto last = p_str.find_last_not_of(" \t");
+    return p_str.substr(first, last - first + 1);
+}
+
+MachineInstr MachineInstr::parse(const std::string &p_line)
+{
+    const std::string text = trim(p_line);
+
+    if (text.empty() || text[0] == '.')
+    {
+        // keep directives verbatim to preserve their indentation
+        return MachineInstr(KindEnum::kDirective, p_line);
+    }
+
+    if (text.back() == ':')
+    {
+        return MachineInstr(KindEnum::kLabel, text.substr(0, text.size() - 1));
+    }
+
+    const auto space_pos = text.find(' ');
+    if (space_pos == std::string::npos)
+    {
+        return MachineInstr(text, {});
+    }
+
+    std::vector<std::string> operands;
+    std::stringstream operand_stream(text.substr(space_pos + 1));
+    std::string operand;
+    while (std::getline(operand_stream, operand, ','))
+    {
+        operands.emplace_back(trim(operand));
+    }
+
+    return MachineInstr(text.substr(0, space_pos), operands);
+}
+
+std::string MachineInstr::toString() const
+{
+    switch (kind)
+    {
+    case KindEnum::kLabel:
+        return opcode + ":";
+    case KindEnum::kDirective:
+        return opcode;
+    case KindEnum::kInstruction:
+    default:
+        break;
+    }
+
+    std::string line = "    " + opcode;
+    for (std::size_t i = 0; i < operands.size(); ++i)
+    {
+        line += (i == 0) ? " " : ", ";
+        line += operands[i];
+    }
+    return line;
+}
+
+// ===========================================
+// > Encoded size
+// ===========================================
+
+// x8 ~ x15, the registers reachable from the 3-bit fields of RVC
+static bool isCompressibleRegister(const std::string &p_reg)
+{
+    static const char *const kRvcRegisters[] = {"s0", "fp", "s1", "a0", "a1",
+                                                "a2", "a3", "a4", "a5"};
+    for (const char *reg : kRvcRegisters)
+    {
+        if (p_reg == reg)
+            return true;
+    }
+    return false;
+}
+
+static bool parseImmediate(const std::string &p_str, long &p_value)
+{
+    if (p_str.empty())
+        return false;
+    char *end = nullptr;
+    p_value = std::strtol(p_str.c_str(), &end, 0);
+    return *end == '\0';
+}
+
+// splits `off(base)`
+static bool parseMemoryOperand(const std::string &p_str, long &p_offset,
+                               std::string &p_base)
+{
+    const auto lparen = p_str.find('(');
+    if (lparen == std::string::npos || p_str.back() != ')')
+        return false;
+    p_base = p_str.substr(lparen + 1, p_str.size() - lparen - 2);
+    if (lparen == 0)
+    {
+        p_offset = 0;
+        return true;
+    }
+    return parseImmediate(p_str.substr(0, lparen), p_offset);
+}
+
+static bool fitsSigned(const long p_value, const int p_bits)
+{
+    return p_value >= -(1L << (p_bits - 1)) && p_value < (1L << (p_bits - 1));
+}
+
+static bool isCompressedForm(const MachineInstr &p_instr)
+{
+    const auto &op = p_instr.opcode;
+    const auto &ops = p_instr.operands;
+    long imm = 0;
+    std::string base;
+
+    if (op == "lw" || op == "sw")
+    {
+        if (ops.size() != 2 || !parseMemoryOperand(ops[1], imm, base))
+            return false;
+        if (imm % 4 != 0 || imm < 0)
+            return false;
+        if (base == "sp")
+            return imm <= 252 && (op == "sw" || ops[0] != "zero");
+        return imm <= 124 && isCompressibleRegister(base) &&
+               isCompressibleRegister(ops[0]);
+    }
+    if (op == "li")
+        return ops[0] != "zero" && parseImmediate(ops[1], imm) &&
+               fitsSigned(imm, 6);
+    if (op == "mv")
+        return ops[0] != "zero" && ops[1] != "zero";
+    if (op == "addi")
+    {
+        if (!parseImmediate(ops[2], imm) || imm == 0)
+            return false;
+        if (ops[0] == "sp" && ops[1] == "sp" && imm % 16 == 0 &&
+            imm >= -512 && imm <= 496)
+            return true; // c.addi16sp
+        if (ops[1] == "sp" && isCompressibleRegister(ops[0]) && imm > 0 &&
+            imm <= 1020 && imm % 4 == 0)
+            return true; // c.addi4spn
+        return ops[0] == ops[1] && ops[0] != "zero" && fitsSigned(imm, 6);
+    }
+    if (op == "andi")
+        return ops[0] == ops[1] && isCompressibleRegister(ops[0]) &&
+               parseImmediate(ops[2], imm) && fitsSigned(imm, 6);
+    if (op == "slli")
+        return ops[0] == ops[1] && ops[0] != "zero";
+    if (op == "srli" || op == "srai")
+        return ops[0] == ops[1] && isCompressibleRegister(ops[0]);
+    if (op == "add")
+        return ops[0] == ops[1] && ops[0] != "zero" && ops[2] != "zero";
+    if (op == "sub" || op == "and" || op == "or" || op == "xor")
+        return ops[0] == ops[1] && isCompressibleRegister(ops[0]) &&
+               isCompressibleRegister(ops[2]);
+    if (op == "beq" || op == "bne")
+        return ops[1] == "zero" && isCompressibleRegister(ops[0]);
+    if (op == "beqz" || op == "bnez")
+        return isCompressibleRegister(ops[0]);
+    if (op == "j" || op == "jr" || op == "ret")
+        return true;
+    if (op == "jalr")
+        return ops.size() == 1;
+    // calls to other functions are resolved by the linker, so the assembler
+    // keeps the 4-byte `jal`
+    return false;
+}
+
+uint32_t MachineInstr::getEncodedSize(const bool p_compressed) const
+{
+    if (kind != KindEnum::kInstruction)
+        return 0;
+
+    long imm = 0;
+    if (opcode == "la" || opcode == "call" || opcode == "tail")
+        return 8;
+    if (opcode == "li" && parseImmediate(operands[1], imm) &&
+        !fitsSigned(imm, 12))
+        return ((imm & 0xfff) == 0) ? 4 : 8;
+
+    if (p_compressed && isCompressedForm(*this))
+        return 2;
+    return 4;
+}
+
+// ===========================================
+// > MachineFunction
+// ===========================================
+static void parseLines(const std::string &p_text,
+                       MachineFunction::Instrs &p_instrs)
+{
+    std::stringstream text_stream(p_text);
+    std::string line;
+    while (std::getline(text_stream, line))
+    {
+        p_instrs.emplace_back(MachineInstr::parse(line));
+    }
+}
+
+MachineFunction::MachineFunction(const std::string &p_name,
+                                 const std::string &p_text)
+    : m_name(p_name)
+{
+    parseLines(p_text, m_instrs);
+}
+
+uint32_t MachineFunction::getCodeSize(const bool p_compressed) const
+{
+    uint32_t size = 0;
+    for (const auto &instr : m_instrs)
+    {
+        size += instr.getEncodedSize(p_compressed);
+    }
+    return size;
+}
+
+void MachineFunction::makeAliasOf(const std::string &p_target)
+{
+    m_alias_of = p_target;
+
+    const std::string text = "    .globl " + m_name + "\n"
+                             "    .type " + m_name + ", @function\n"
+                             "    .set " + m_name + ", " + p_target + "\n";
+    m_instrs.clear();
+    parseLines(text, m_instrs);
+}
+
+void MachineFunction::print(FILE *p_out_file) const
+{
+    for (const auto &instr : m_instrs)
+    {
+        fprintf(p_out_file, "%s\n", instr.toString().c_str());
+    }
+}
+
+// ===========================================
+// > MachineModule
+// ===========================================
+void MachineModule::print(FILE *p_out_file) const
+{
+    fputs(m_header.c_str(), p_out_file);
+    for (const auto &function : m_functions)
+    {
+        function->print(p_out_file);
+    }
+    fputs(m_trailer.c_str(), p_out_file);
+}
@@ -0,0 +1,438 @@
+#include "codegen/MachinePasses.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+// Machine outliner: finds instruction sequences repeated anywhere in the
+// module and hoists the profitable ones into millicode routines that are
+// called with `jal t0, routine` and return with `jr t0`, leaving ra alone.
+//
+// Repeated sequences are the internal nodes of the suffix tree over the
+// module's instruction stream. They are enumerated as the lcp-intervals of
+// the suffix array, which yields the same nodes without building the tree.
+// The tree is cut at kMaxLength instructions: longer repeats are outlined in
+// pieces, and an occurrence is in kMaxLength intervals at most, so
+// repetitive code (e.g. a deeply nested expression) doesn't make the
+// enumeration quadratic.
+
+namespace
+{
+
+constexpr const char *kLinkRegister = "t0";
+constexpr uint32_t kCallSize = 4; // `jal t0, x` has no compressed form
+constexpr uint32_t kMaxLength = 1024;
+
+struct Candidate
+{
+    uint32_t length;
+    std::vector<uint32_t> starts;
+    int benefit;
+};
+
+struct InstrLocation
+{
+    uint32_t function_idx;
+    uint32_t instr_idx;
+};
+
+bool mentionsRegister(const MachineInstr &p_instr, const std::string &p_reg)
+{
+    for (const auto &operand : p_instr.operands)
+    {
+        if (operand == p_reg ||
+            operand.find("(" + p_reg + ")") != std::string::npos)
+            return true;
+    }
+    return false;
+}
+
+bool isControlFlow(const MachineInstr &p_instr)
+{
+    static const char *const kControlFlow[] = {
+        "j",    "jal",  "jalr", "jr",   "ret",  "call", "tail", "beq",
+        "bne",  "blt",  "bge",  "bltu", "bgeu", "bgt",  "ble",  "beqz",
+        "bnez", "bltz", "bgez", "blez", "bgtz"};
+    for (const char *opcode : kControlFlow)
+    {
+        if (p_instr.opcode == opcode)
+            return true;
+    }
+    return false;
+}
+
+// Control flow can't be moved into a routine, neither can calls (they would
+// clobber the link register). The call itself clobbers the link register, so
+// it must not be alive across the sequence either.
+std::vector<bool> findOutlinable(const MachineFunction::Instrs &p_instrs)
+{
+    std::vector<bool> outlinable(p_instrs.size(), false);
+
+    // backward liveness of the link register; unknown successors count as
+    // using it, calls to other functions as clobbering it
+    bool mentioned_anywhere = false;
+    for (const auto &instr : p_instrs)
+    {
+        if (instr.isInstruction() && mentionsRegister(instr, kLinkRegister))
+            mentioned_anywhere = true;
+    }
+
+    bool live = false;
+    for (uint32_t i = p_instrs.size(); i-- > 0;)
+    {
+        const auto &instr = p_instrs[i];
+        if (!instr.isInstruction())
+        {
+            live = mentioned_anywhere;
+            continue;
+        }
+
+        const bool mentioned = mentionsRegister(instr, kLinkRegister);
+        outlinable[i] = !isControlFlow(instr) && !mentioned && !live;
+
+        if (isControlFlow(instr))
+            live = mentioned_anywhere && instr.opcode != "jal" &&
+                   instr.opcode != "call";
+        if (mentioned)
+        {
+            // alive before unless the instruction only writes it
+            const bool is_store = instr.opcode == "sw" ||
+                                  instr.opcode == "sh" || instr.opcode == "sb";
+            bool used = is_store || isControlFlow(instr);
+            for (uint32_t k = 1; k < instr.operands.size(); ++k)
+            {
+                const auto &operand = instr.operands[k];
+                if (operand == kLinkRegister ||
+                    operand.find(std::string("(") + kLinkRegister + ")") !=
+                        std::string::npos)
+                    used = true;
+            }
+            live = used || instr.operands[0] != kLinkRegister;
+        }
+    }
+    return outlinable;
+}
+
+// prefix doubling, with each round a two-pass radix sort on the ranks
+std::vector<uint32_t> buildSuffixArray(const std::vector<uint32_t> &p_str)
+{
+    const uint32_t n = p_str.size();
+    std::vector<uint32_t> sa(n), rank(n), tmp(n), count;
+
+    // rank by the first symbol; 0 stands for past the end
+    std::vector<uint32_t> symbols(p_str);
+    std::sort(symbols.begin(), symbols.end());
+    symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+    for (uint32_t i = 0; i < n; ++i)
+        rank[i] = std::lower_bound(symbols.begin(), symbols.end(), p_str[i]) -
+                  symbols.begin() + 1;
+    uint32_t num_ranks = symbols.size() + 1;
+
+    for (uint32_t k = 1;; k <<= 1)
+    {
+        auto second = [&](const uint32_t i) { return i + k < n ? rank[i + k] : 0; };
+
+        // by the rank k symbols on, then stably by the rank of the first k
+        count.assign(num_ranks, 0);
+        for (uint32_t i = 0; i < n; ++i)
+            ++count[second(i)];
+        for (uint32_t r = 1; r < num_ranks; ++r)
+            count[r] += count[r - 1];
+        for (uint32_t i = n; i-- > 0;)
+            tmp[--count[second(i)]] = i;
+
+        count.assign(num_ranks, 0);
+        for (uint32_t i = 0; i < n; ++i)
+            ++count[rank[i]];
+        for (uint32_t r = 1; r < num_ranks; ++r)
+            count[r] += count[r - 1];
+        for (uint32_t j = n; j-- > 0;)
+            sa[--count[rank[tmp[j]]]] = tmp[j];
+
+        tmp[sa[0]] = 1;
+        for (uint32_t j = 1; j < n; ++j)
+        {
+            const bool differs = rank[sa[j - 1]] != rank[sa[j]] ||
+                                 second(sa[j - 1]) != second(sa[j]);
+            tmp[sa[j]] = tmp[sa[j - 1]] + (differs ? 1 : 0);
+        }
+        num_ranks = tmp[sa[n - 1]] + 1;
+        rank.swap(tmp);
+
+        if (num_ranks == n + 1)
+            break;
+    }
+    return sa;
+}
+
+// Kasai et al.; lcp[i] is the common prefix length of sa[i - 1] and sa[i]
+std::vector<uint32_t> buildLcpArray(const std::vector<uint32_t> &p_str,
+                                    const std::vector<uint32_t> &p_sa)
+{
+    const uint32_t n = p_str.size();
+    std::vector<uint32_t> rank(n), lcp(n, 0);
+    for (uint32_t i = 0; i < n; ++i)
+        rank[p_sa[i]] = i;
+
+    uint32_t h = 0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (rank[i] > 0)
+        {
+            const uint32_t j = p_sa[rank[i] - 1];
+            while (i + h < n && j + h < n && p_str[i + h] == p_str[j + h])
+                ++h;
+            lcp[rank[i]] = h;
+            if (h > 0)
+                --h;
+        }
+        else
+        {
+            h = 0;
+        }
+    }
+    return lcp;
+}
+
+} // namespace
+
+void outlineModule(MachineModule &p_module, const CodeGenOptions &p_options)
+{
+    if (!p_options.outline)
+        return;
+
+    auto &functions = p_module.getFunctions();
+
+    // Map the module onto one string of integers. Instructions that can't be
+    // outlined and function boundaries get unique symbols so that no
+    // repeated substring spans them.
+    std::map<std::string, uint32_t> instr_ids;
+    std::vector<uint32_t> str;
+    std::vector<InstrLocation> locations;
+    std::vector<uint32_t> sizes;
+    uint32_t unique_id = 0x80000000u;
+
+    for (uint32_t f = 0; f < functions.size(); ++f)
+    {
+        const auto &instrs = functions[f]->getInstrs();
+        const auto outlinable = findOutlinable(instrs);
+        for (uint32_t i = 0; i < instrs.size(); ++i)
+        {
+            if (outlinable[i])
+            {
+                auto inserted =
+                    instr_ids.emplace(instrs[i].toString(), instr_ids.size());
+                str.emplace_back(inserted.first->second);
+            }
+            else
+            {
+                str.emplace_back(unique_id++);
+            }
+            locations.push_back({f, i});
+            sizes.emplace_back(instrs[i].getEncodedSize(p_options.compressed));
+        }
+        str.emplace_back(unique_id++);
+        locations.push_back({f, (uint32_t)instrs.size()});
+        sizes.emplace_back(0);
+    }
+
+    if (str.empty())
+        return;
+
+    const auto sa = buildSuffixArray(str);
+    const auto lcp = buildLcpArray(str, sa);
+
+    // sizes of the first i instructions
+    std::vector<uint32_t> size_sums(sizes.size() + 1, 0);
+    for (uint32_t i = 0; i < sizes.size(); ++i)
+        size_sums[i + 1] = size_sums[i] + sizes[i];
+
+    const uint32_t return_size = p_options.compressed ? 2 : 4;
+    auto compute_benefit = [&](const uint32_t p_length,
+                               const uint32_t p_occurrences,
+                               const uint32_t p_start) {
+        const int seq_size =
+            (int)(size_sums[p_start + p_length] - size_sums[p_start]);
+        return (int)p_occurrences * seq_size -
+               ((int)p_occurrences * (int)kCallSize + seq_size +
+                (int)return_size);
+    };
+
+    // drops overlapping occurrences, keeping the leftmost ones
+    auto non_overlapping = [](const std::vector<uint32_t> &p_starts,
+                              const uint32_t p_length) {
+        std::vector<uint32_t> kept;
+        for (auto start : p_starts)
+        {
+            if (kept.empty() || kept.back() + p_length <= start)
+                kept.emplace_back(start);
+        }
+        return kept;
+    };
+
+    // Enumerate the lcp-intervals, i.e. the internal nodes of the suffix
+    // tree, bottom-up. The starts of an interval are those of its children,
+    // each sorted already, and are merged once the interval is complete.
+    // Intervals shorter than two instructions aren't candidates and don't
+    // collect theirs.
+    struct Interval
+    {
+        uint32_t lcp;
+        std::vector<uint32_t> starts;
+        // where the starts of each child begin
+        std::vector<uint32_t> runs;
+    };
+    auto add_child = [](Interval &p_parent, const std::vector<uint32_t> &p_child) {
+        if (p_parent.lcp < 2)
+            return;
+        p_parent.runs.emplace_back(p_parent.starts.size());
+        p_parent.starts.insert(p_parent.starts.end(), p_child.begin(),
+                               p_child.end());
+    };
+    auto merge_runs = [](Interval &p_interval) {
+        auto &starts = p_interval.starts;
+        auto &runs = p_interval.runs;
+        runs.emplace_back(starts.size());
+        for (uint32_t width = 1; width + 1 < runs.size(); width *= 2)
+        {
+            for (uint32_t r = 0; r + width + 1 < runs.size(); r += 2 * width)
+            {
+                const uint32_t end = std::min<uint32_t>(r + 2 * width, runs.size() - 1);
+                std::inplace_merge(starts.begin() + runs[r],
+                                   starts.begin() + runs[r + width],
+                                   starts.begin() + runs[end]);
+            }
+        }
+    };
+
+    std::vector<Candidate> candidates;
+    std::vector<Interval> stack(1);
+    for (uint32_t i = 1; i <= str.size(); ++i)
+    {
+        const uint32_t cur =
+            (i < str.size()) ? std::min(lcp[i], kMaxLength) : 0;
+        std::vector<uint32_t> child{sa[i - 1]};
+        while (cur < stack.back().lcp)
+        {
+            Interval interval = std::move(stack.back());
+            stack.pop_back();
+            add_child(interval, child);
+
+            if (interval.lcp >= 2)
+            {
+                merge_runs(interval);
+
+                Candidate candidate;
+                candidate.length = interval.lcp;
+                candidate.starts =
+                    non_overlapping(interval.starts, candidate.length);
+                candidate.benefit =
+                    compute_benefit(candidate.length, candidate.starts.size(),
+                                    candidate.starts.front());
+                if (candidate.starts.size() >= 2 && candidate.benefit > 0)
+                    candidates.emplace_back(std::move(candidate));
+            }
+            child = std::move(interval.starts);
+        }
+        if (cur > stack.back().lcp)
+            stack.push_back({cur, {}, {}});
+        add_child(stack.back(), child);
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const Candidate &a, const Candidate &b) {
+                         if (a.benefit != b.benefit)
+                             return a.benefit > b.benefit;
+                         return a.length > b.length;
+                     });
+
+    // greedily take the most profitable candidates whose occurrences are
+    // still untouched
+    std::vector<bool> taken(str.size(), false);
+    // per function: (first instruction of the occurrence, routine index)
+    std::map<uint32_t, std::vector<std::pair<uint32_t, uint32_t>>> replacements;
+    std::vector<std::pair<std::string, uint32_t>> routines; // text, length
+    std::vector<std::string> routine_names;
+
+    for (const auto &candidate : candidates)
+    {
+        std::vector<uint32_t> starts;
+        for (auto start : candidate.starts)
+        {
+            bool free = true;
+            for (uint32_t i = 0; i < candidate.length && free; ++i)
+                free = !taken[start + i];
+            if (free)
+                starts.emplace_back(start);
+        }
+
+        if (starts.size() < 2 ||
+            compute_benefit(candidate.length, starts.size(), starts.front()) <=
+                0)
+            continue;
+
+        const uint32_t routine_idx = routine_names.size();
+        char name[32];
+        snprintf(name, sizeof(name), "OUTLINED_FUNCTION_%u", routine_idx);
+        routine_names.emplace_back(name);
+
+        // the body is copied from the first occurrence
+        std::string text = ".section    .text\n"
+                           "    .align " +
+                           std::string(p_options.compressed ? "1" : "2") +
+                           "\n"
+                           "    .type " +
+                           routine_names.back() + ", @function\n" +
+                           routine_names.back() + ":\n";
+        const auto &first = locations[starts.front()];
+        const auto &source = functions[first.function_idx]->getInstrs();
+        for (uint32_t i = 0; i < candidate.length; ++i)
+            text += source[first.instr_idx + i].toString() + "\n";
+        text += std::string("    jr ") + kLinkRegister + "\n";
+        text += "    .size " + routine_names.back() + ", .-" +
+                routine_names.back() + "\n";
+        routines.emplace_back(text, candidate.length);
+
+        for (auto start : starts)
+        {
+            for (uint32_t i = 0; i < candidate.length; ++i)
+                taken[start + i] = true;
+            replacements[locations[start].function_idx].emplace_back(
+                locations[start].instr_idx, routine_idx);
+        }
+    }
+
+    for (auto &replacement : replacements)
+    {
+        auto &instrs = functions[replacement.first]->getInstrs();
+        auto &sites = replacement.second;
+        std::sort(sites.begin(), sites.end());
+
+        MachineFunction::Instrs rewritten;
+        uint32_t next_site = 0;
+        for (uint32_t i = 0; i < instrs.size();)
+        {
+            if (next_site < sites.size() && sites[next_site].first == i)
+            {
+                const uint32_t routine_idx = sites[next_site].second;
+                rewritten.emplace_back(
+                    "jal", std::vector<std::string>{kLinkRegister,
+                                                    routine_names[routine_idx]});
+                i += routines[routine_idx].second;
+                ++next_site;
+                continue;
+            }
+            rewritten.emplace_back(std::move(instrs[i]));
+            ++i;
+        }
+        instrs = std::move(rewritten);
+    }
+
+    for (uint32_t i = 0; i < routines.size(); ++i)
+    {
+        p_module.addFunction(
+            new MachineFunction(routine_names[i], routines[i].first));
+    }
+}
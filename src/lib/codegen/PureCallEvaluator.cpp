@@ -0,0 +1,435 @@
+#include "codegen/PureCallEvaluator.hpp"
+#include "sema/SymbolTable.hpp"
+#include "visitor/AstNodeInclude.hpp"
+
+#include <vector>
+
+// bounds the work spent on one call written in the program
+static constexpr uint32_t kMaxCallSteps = 100000;
+// bounds the work spent on all of them
+static constexpr uint32_t kMaxSteps = 1000000;
+// bounds the native stack used by the interpreter
+static constexpr uint32_t kMaxDepth = 200;
+
+namespace
+{
+
+bool isEvaluableType(const PType *p_type)
+{
+    return p_type && (p_type->isInteger() || p_type->isBool());
+}
+
+// Finds what keeps a function from being pure on its own, and the functions
+// it calls.
+class PurityScanner final : public AstWalker<PurityScanner>
+{
+    friend class AstWalker<PurityScanner>;
+
+public:
+    const SymbolManager *m_symbol_manager_ptr;
+    bool m_impure = false;
+    bool m_reads_globals = false;
+    std::set<InternedString> m_callees;
+
+    explicit PurityScanner(const SymbolManager *p_symbol_manager)
+        : m_symbol_manager_ptr(p_symbol_manager) {}
+
+private:
+    using AstWalker<PurityScanner>::enter;
+    using AstWalker<PurityScanner>::leave;
+
+    bool enter(PrintNode &p_print)
+    {
+        m_impure = true;
+        return false;
+    }
+    bool enter(ReadNode &p_read)
+    {
+        m_impure = true;
+        return false;
+    }
+
+    bool enter(FunctionNode &p_function)
+    {
+        m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(p_function.getSymbolTable());
+        return true;
+    }
+    void leave(FunctionNode &p_function)
+    {
+        m_symbol_manager_ptr->removeSymbolsFromHashTable(p_function.getSymbolTable());
+    }
+
+    bool enter(CompoundStatementNode &p_compound_statement)
+    {
+        m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+            p_compound_statement.getSymbolTable());
+        return true;
+    }
+    void leave(CompoundStatementNode &p_compound_statement)
+    {
+        m_symbol_manager_ptr->removeSymbolsFromHashTable(
+            p_compound_statement.getSymbolTable());
+    }
+
+    bool enter(ForNode &p_for)
+    {
+        m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(p_for.getSymbolTable());
+        return true;
+    }
+    void leave(ForNode &p_for)
+    {
+        m_symbol_manager_ptr->removeSymbolsFromHashTable(p_for.getSymbolTable());
+    }
+
+    bool enter(FunctionInvocationNode &p_func_invocation)
+    {
+        m_callees.insert(p_func_invocation.getName());
+        return true;
+    }
+
+    bool enter(VariableReferenceNode &p_variable_ref)
+    {
+        // the interpreter has no memory to keep arrays in
+        if (!p_variable_ref.getIndices().empty())
+            m_impure = true;
+
+        const SymbolEntry *entry =
+            m_symbol_manager_ptr->lookup(p_variable_ref.getName());
+        if (entry->getLevel() == 0 &&
+            entry->getKind() != SymbolEntry::KindEnum::kConstantKind)
+            m_reads_globals = true;
+        return false;
+    }
+
+    bool enter(AssignmentNode &p_assignment)
+    {
+        const SymbolEntry *entry =
+            m_symbol_manager_ptr->lookup(p_assignment.getLvalue().getName());
+        if (entry->getLevel() == 0)
+            m_impure = true;
+        return true;
+    }
+};
+
+} // namespace
+
+void PureCallEvaluator::analyze(ProgramNode &p_program)
+{
+    m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(p_program.getSymbolTable());
+
+    for (const auto &function : p_program.getFuncNodes())
+    {
+        bool evaluable = function->hasBody() && isEvaluableType(function->getTypePtr());
+        for (const auto &entry : function->getSymbolTable()->getEntries())
+        {
+            if (entry->getKind() == SymbolEntry::KindEnum::kParameterKind &&
+                !isEvaluableType(entry->getTypePtr()))
+                evaluable = false;
+        }
+        if (!evaluable)
+            continue;
+
+        PurityScanner scanner(m_symbol_manager_ptr);
+        scanner.walk(*function);
+        if (scanner.m_impure)
+            continue;
+
+        m_pure_functions.emplace(function->getName(), function);
+        m_callees.emplace(function->getName(), std::move(scanner.m_callees));
+        if (scanner.m_reads_globals)
+            m_global_readers.insert(function->getName());
+    }
+
+    m_symbol_manager_ptr->removeSymbolsFromHashTable(p_program.getSymbolTable());
+
+    // a function calling one that isn't pure isn't either
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (auto it = m_pure_functions.begin(); it != m_pure_functions.end();)
+        {
+            bool pure = true;
+            for (const auto &callee : m_callees[it->first])
+            {
+                if (!m_pure_functions.count(callee))
+                    pure = false;
+            }
+            if (pure)
+            {
+                ++it;
+                continue;
+            }
+            it = m_pure_functions.erase(it);
+            changed = true;
+        }
+    }
+}
+
+bool PureCallEvaluator::isRecursive(const InternedString p_name) const
+{
+    if (!isPure(p_name))
+        return false;
+
+    // pure functions call pure functions only, so m_callees covers the
+    // whole call graph below `p_name`
+    std::set<InternedString> visited;
+    std::vector<InternedString> worklist{p_name};
+    while (!worklist.empty())
+    {
+        const InternedString caller = worklist.back();
+        worklist.pop_back();
+        for (const auto &callee : m_callees.at(caller))
+        {
+            if (callee == p_name)
+                return true;
+            if (visited.insert(callee).second)
+                worklist.push_back(callee);
+        }
+    }
+    return false;
+}
+
+bool PureCallEvaluator::readsGlobals(const InternedString p_name) const
+{
+    if (!isPure(p_name))
+        return false;
+
+    std::set<InternedString> visited{p_name};
+    std::vector<InternedString> worklist{p_name};
+    while (!worklist.empty())
+    {
+        const InternedString caller = worklist.back();
+        worklist.pop_back();
+        if (m_global_readers.count(caller))
+            return true;
+        for (const auto &callee : m_callees.at(caller))
+        {
+            if (visited.insert(callee).second)
+                worklist.push_back(callee);
+        }
+    }
+    return false;
+}
+
+bool PureCallEvaluator::call(const FunctionInvocationNode &p_call,
+                             const std::vector<int32_t> &p_args,
+                             int32_t &p_result)
+{
+    auto function = m_pure_functions.find(p_call.getName());
+    if (function == m_pure_functions.end() || m_depth >= kMaxDepth)
+        return false;
+
+    auto key = std::make_pair(p_call.getName(), p_args);
+    auto cached = m_results.find(key);
+    if (cached != m_results.end())
+    {
+        p_result = cached->second;
+        return true;
+    }
+    if (m_unknown.count(key) || m_steps >= kMaxSteps)
+        return false;
+
+    Frame frame;
+    uint32_t param = 0;
+    for (const auto &entry : function->second->getSymbolTable()->getEntries())
+    {
+        if (entry->getKind() != SymbolEntry::KindEnum::kParameterKind)
+            continue;
+        if (param >= p_args.size())
+            return false;
+        frame.values[entry.get()] = p_args[param++];
+    }
+
+    if (m_depth == 0)
+    {
+        m_call_start = m_steps;
+        m_failed = false;
+    }
+    Frame *caller = m_frame;
+    m_frame = &frame;
+    ++m_depth;
+
+    walk(*function->second);
+
+    --m_depth;
+    m_frame = caller;
+
+    // falling off the end returns nothing in particular
+    if (m_failed || !frame.returned)
+    {
+        m_failed = true;
+        m_unknown.insert(std::move(key));
+        return false;
+    }
+    m_results.emplace(std::move(key), frame.return_value);
+    p_result = frame.return_value;
+    return true;
+}
+
+void PureCallEvaluator::step()
+{
+    if (++m_steps > kMaxSteps || m_steps - m_call_start > kMaxCallSteps)
+        m_failed = true;
+}
+
+bool PureCallEvaluator::evaluate(const ExpressionNode &p_expr, int32_t &p_value)
+{
+    step();
+    if (m_failed)
+        return false;
+    if (!ConstantFolder(m_symbol_manager_ptr, m_frame->values, this)
+             .evaluate(p_expr, p_value))
+        m_failed = true;
+    return !m_failed;
+}
+
+void PureCallEvaluator::assign(const VariableReferenceNode &p_target,
+                               const int32_t p_value)
+{
+    const SymbolEntry *entry = m_symbol_manager_ptr->lookup(p_target.getName());
+    m_frame->values[entry] = p_value;
+}
+
+bool PureCallEvaluator::enter(DeclNode &p_decl)
+{
+    // constants are read from their symbol entries
+    return false;
+}
+
+bool PureCallEvaluator::enter(FunctionNode &p_function)
+{
+    m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(p_function.getSymbolTable());
+    return true;
+}
+
+void PureCallEvaluator::leave(FunctionNode &p_function)
+{
+    m_symbol_manager_ptr->removeSymbolsFromHashTable(p_function.getSymbolTable());
+}
+
+bool PureCallEvaluator::enter(CompoundStatementNode &p_compound_statement)
+{
+    m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+        p_compound_statement.getSymbolTable());
+    return true;
+}
+
+void PureCallEvaluator::leave(CompoundStatementNode &p_compound_statement)
+{
+    m_symbol_manager_ptr->removeSymbolsFromHashTable(
+        p_compound_statement.getSymbolTable());
+}
+
+bool PureCallEvaluator::enter(PrintNode &p_print)
+{
+    m_failed = true;
+    return false;
+}
+
+bool PureCallEvaluator::enter(ReadNode &p_read)
+{
+    m_failed = true;
+    return false;
+}
+
+bool PureCallEvaluator::enter(FunctionInvocationNode &p_func_invocation)
+{
+    // a call statement; the result is dropped
+    int32_t value;
+    if (!isDone())
+        evaluate(p_func_invocation, value);
+    return false;
+}
+
+bool PureCallEvaluator::enter(AssignmentNode &p_assignment)
+{
+    int32_t value;
+    if (!isDone() && evaluate(p_assignment.getExpr(), value))
+        assign(p_assignment.getLvalue(), value);
+    return false;
+}
+
+bool PureCallEvaluator::enter(IfNode &p_if)
+{
+    int32_t condition;
+    if (isDone() || !evaluate(p_if.getCondition(), condition))
+        return false;
+    if (condition)
+        schedule(p_if.getBody());
+    else if (p_if.getElseBody())
+        schedule(*p_if.getElseBody());
+    return false;
+}
+
+bool PureCallEvaluator::enter(WhileNode &p_while)
+{
+    iterate(p_while);
+    return false;
+}
+
+void PureCallEvaluator::iterate(const WhileNode &p_while)
+{
+    int32_t condition;
+    if (isDone() || !evaluate(p_while.getCondition(), condition) || !condition)
+        return;
+    schedule(p_while.getBody());
+    schedule([this, &p_while] { iterate(p_while); });
+}
+
+bool PureCallEvaluator::enter(ForNode &p_for)
+{
+    if (isDone())
+        return false;
+
+    m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(p_for.getSymbolTable());
+
+    schedule(p_for.getLoopVarDecl());
+    schedule(p_for.getInitStatement());
+    schedule([this, &p_for]
+             {
+                 // the loop runs while the variable is below the upper bound,
+                 // as lowered
+                 const SymbolEntry *loop_var =
+                     m_symbol_manager_ptr->lookup(p_for.getLoopVarName());
+                 int32_t upper_bound;
+                 if (evaluate(p_for.getUpperBound(), upper_bound))
+                     iterate(p_for, loop_var, upper_bound);
+             });
+    schedule([this, &p_for]
+             {
+                 m_symbol_manager_ptr->removeSymbolsFromHashTable(
+                     p_for.getSymbolTable());
+             });
+    return false;
+}
+
+void PureCallEvaluator::iterate(const ForNode &p_for, const SymbolEntry *p_loop_var,
+                                const int32_t p_upper_bound)
+{
+    if (isDone())
+        return;
+    step();
+    if (m_failed || m_frame->values[p_loop_var] >= p_upper_bound)
+        return;
+
+    schedule(p_for.getBody());
+    schedule([this, &p_for, p_loop_var, p_upper_bound]
+             {
+                 if (isDone())
+                     return;
+                 m_frame->values[p_loop_var] = static_cast<int32_t>(
+                     static_cast<uint32_t>(m_frame->values[p_loop_var]) + 1);
+                 iterate(p_for, p_loop_var, p_upper_bound);
+             });
+}
+
+bool PureCallEvaluator::enter(ReturnNode &p_return)
+{
+    int32_t value;
+    if (isDone() || !evaluate(p_return.getReturnValue(), value))
+        return false;
+    m_frame->returned = true;
+    m_frame->return_value = value;
+    return false;
+}
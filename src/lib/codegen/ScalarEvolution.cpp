@@ -0,0 +1,380 @@
+#include "codegen/ScalarEvolution.hpp"
+#include "sema/SymbolTable.hpp"
+#include "visitor/AstNodeInclude.hpp"
+#include "visitor/AstWalker.hpp"
+
+#include <algorithm>
+
+// e(L), ..., e(L+3) are evaluated in place of the loop
+static constexpr int kMaxDegree = 3;
+
+namespace
+{
+
+// The variables a statement reads and writes, and whether it may have other
+// effects on them.
+class AccessScanner final : public AstWalker<AccessScanner>
+{
+    friend class AstWalker<AccessScanner>;
+
+public:
+    const SymbolManager *m_symbol_manager_ptr;
+    std::set<const SymbolEntry *> m_reads;
+    std::set<const SymbolEntry *> m_writes;
+    bool m_has_call = false;
+    bool m_has_return = false;
+
+    explicit AccessScanner(const SymbolManager *p_symbol_manager)
+        : m_symbol_manager_ptr(p_symbol_manager) {}
+
+private:
+    using AstWalker<AccessScanner>::enter;
+    using AstWalker<AccessScanner>::leave;
+
+    bool enter(DeclNode &p_decl) { return false; }
+
+    bool enter(CompoundStatementNode &p_compound_statement)
+    {
+        m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(
+            p_compound_statement.getSymbolTable());
+        return true;
+    }
+    void leave(CompoundStatementNode &p_compound_statement)
+    {
+        m_symbol_manager_ptr->removeSymbolsFromHashTable(
+            p_compound_statement.getSymbolTable());
+    }
+
+    bool enter(ForNode &p_for)
+    {
+        m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(p_for.getSymbolTable());
+        return true;
+    }
+    void leave(ForNode &p_for)
+    {
+        m_symbol_manager_ptr->removeSymbolsFromHashTable(p_for.getSymbolTable());
+    }
+
+    bool enter(FunctionInvocationNode &p_func_invocation)
+    {
+        m_has_call = true;
+        return true;
+    }
+
+    bool enter(VariableReferenceNode &p_variable_ref)
+    {
+        m_reads.insert(m_symbol_manager_ptr->lookup(p_variable_ref.getName()));
+        return true;
+    }
+
+    bool enter(AssignmentNode &p_assignment)
+    {
+        m_writes.insert(m_symbol_manager_ptr->lookup(p_assignment.getLvalue().getName()));
+        return true;
+    }
+
+    bool enter(ReadNode &p_read)
+    {
+        m_writes.insert(m_symbol_manager_ptr->lookup(p_read.getTarget().getName()));
+        return true;
+    }
+
+    bool enter(ReturnNode &p_return)
+    {
+        m_has_return = true;
+        return true;
+    }
+};
+
+// The degree of an expression as a polynomial in the loop variable, or -1
+// if it isn't one. Subexpressions that don't depend on the loop variable may
+// use any operator. The accumulator counts as a constant, but must be added
+// exactly once: through additions, subtractions and negations that leave its
+// sign positive.
+class DegreeVisitor final : public AstWalker<DegreeVisitor>
+{
+    friend class AstWalker<DegreeVisitor>;
+
+public:
+    const SymbolManager *m_symbol_manager_ptr;
+    const SymbolEntry *m_loop_var;
+    const SymbolEntry *m_accumulator;
+    std::set<const SymbolEntry *> m_operands;
+    int m_degree = -1;
+    // occurrences of the accumulator, and its sign if it is added
+    uint32_t m_num_accumulators = 0;
+    int m_sign = 0;
+
+    DegreeVisitor(const SymbolManager *p_symbol_manager,
+                  const SymbolEntry *p_loop_var,
+                  const SymbolEntry *p_accumulator)
+        : m_symbol_manager_ptr(p_symbol_manager), m_loop_var(p_loop_var),
+          m_accumulator(p_accumulator) {}
+
+    bool addsAccumulatorOnce() const
+    {
+        return m_num_accumulators == 1 && m_sign == 1;
+    }
+
+    int degreeOf(const ExpressionNode &p_expr)
+    {
+        m_terms.clear();
+        walk(p_expr);
+        m_degree = m_terms.back().degree;
+        m_sign = m_terms.back().sign;
+        return m_degree;
+    }
+
+private:
+    // of each operand evaluated so far; the sign is the one the accumulator
+    // reaches the operand with, if it is added in there
+    struct Term
+    {
+        int degree;
+        int sign;
+    };
+    std::vector<Term> m_terms;
+
+    using AstWalker<DegreeVisitor>::leave;
+
+    Term pop()
+    {
+        const Term term = m_terms.back();
+        m_terms.pop_back();
+        return term;
+    }
+
+    // calls aren't polynomials
+    template <typename Node> bool enter(Node &)
+    {
+        m_terms.push_back({-1, 0});
+        return false;
+    }
+
+    bool enter(ConstantValueNode &p_constant_value)
+    {
+        m_terms.push_back({0, 0});
+        return false;
+    }
+
+    bool enter(VariableReferenceNode &p_variable_ref)
+    {
+        if (!p_variable_ref.getIndices().empty())
+        {
+            m_terms.push_back({-1, 0});
+            return false;
+        }
+        const SymbolEntry *entry = m_symbol_manager_ptr->lookup(p_variable_ref.getName());
+        if (entry == m_loop_var)
+        {
+            m_terms.push_back({1, 0});
+            return false;
+        }
+        if (entry == m_accumulator)
+        {
+            ++m_num_accumulators;
+            m_terms.push_back({0, 1});
+        }
+        else
+        {
+            m_operands.insert(entry);
+            m_terms.push_back({0, 0});
+        }
+        return false;
+    }
+
+    bool enter(UnaryOperatorNode &p_un_op) { return true; }
+    void leave(UnaryOperatorNode &p_un_op)
+    {
+        const Term operand = pop();
+        const bool negates = p_un_op.getOp() == Operator::kNegOp;
+        m_terms.push_back({(operand.degree == 0 || negates) ? operand.degree : -1,
+                           negates ? -operand.sign : 0});
+    }
+
+    bool enter(BinaryOperatorNode &p_bin_op) { return true; }
+    void leave(BinaryOperatorNode &p_bin_op)
+    {
+        const Term right = pop();
+        const Term left = pop();
+        if (left.degree < 0 || right.degree < 0)
+        {
+            m_terms.push_back({-1, 0});
+            return;
+        }
+
+        switch (p_bin_op.getOp())
+        {
+        case Operator::kPlusOp:
+            m_terms.push_back({std::max(left.degree, right.degree),
+                               left.sign + right.sign});
+            break;
+        case Operator::kMinusOp:
+            m_terms.push_back({std::max(left.degree, right.degree),
+                               left.sign - right.sign});
+            break;
+        case Operator::kMultiplyOp:
+            m_terms.push_back({left.degree + right.degree, 0});
+            break;
+        default:
+            m_terms.push_back({(left.degree == 0 && right.degree == 0) ? 0 : -1, 0});
+        }
+    }
+};
+
+struct Candidate
+{
+    size_t statement;
+    const SymbolEntry *accumulator;
+    ScalarEvolution::Reduction reduction;
+    int degree;
+    std::set<const SymbolEntry *> operands;
+};
+
+// C(n, k) modulo 2^32
+uint32_t binomial(const uint64_t p_n, const uint32_t p_k)
+{
+    if (p_n < p_k)
+        return 0;
+
+    std::vector<uint64_t> terms;
+    for (uint32_t j = 0; j < p_k; ++j)
+        terms.push_back(p_n - j);
+
+    // k consecutive integers hold every prime factor of k!, so each can be
+    // divided out of one of them before the product wraps
+    for (uint32_t f = 2; f <= p_k; ++f)
+    {
+        uint32_t rest = f;
+        for (uint32_t p = 2; rest > 1; ++p)
+        {
+            while (rest % p == 0)
+            {
+                rest /= p;
+                for (auto &term : terms)
+                {
+                    if (term % p == 0)
+                    {
+                        term /= p;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    uint32_t result = 1;
+    for (const auto term : terms)
+        result *= static_cast<uint32_t>(term);
+    return result;
+}
+
+} // namespace
+
+std::vector<uint32_t> ScalarEvolution::computeWeights(const uint64_t p_trip_count,
+                                                      const uint32_t p_degree)
+{
+    // the coefficient of D^j e(L) is C(N, j+1), and D^j e(L) is the sum of
+    // (-1)^(j-k) C(j, k) e(L+k)
+    std::vector<uint32_t> weights(p_degree + 1, 0);
+    for (uint32_t j = 0; j <= p_degree; ++j)
+    {
+        const uint32_t coefficient = binomial(p_trip_count, j + 1);
+        for (uint32_t k = 0; k <= j; ++k)
+        {
+            const uint32_t term = coefficient * binomial(j, k);
+            weights[k] += ((j - k) % 2 == 0) ? term : 0u - term;
+        }
+    }
+    return weights;
+}
+
+bool ScalarEvolution::analyze(const ForNode &p_for)
+{
+    m_reductions.clear();
+    m_folded.clear();
+    m_loop_dead = false;
+
+    const CompoundStatementNode &body = p_for.getBody();
+    if (!body.getDeclNodes().empty())
+        return false;
+
+    const SymbolEntry *loop_var = m_symbol_manager_ptr->lookup(p_for.getLoopVarName());
+    const auto &statements = body.getStmtNodes();
+
+    m_symbol_manager_ptr->reconstructHashTableFromSymbolTable(body.getSymbolTable());
+
+    std::vector<AccessScanner> accesses;
+    std::vector<Candidate> candidates;
+    bool has_return = false, has_call = false;
+    for (size_t i = 0; i < statements.size(); ++i)
+    {
+        accesses.emplace_back(m_symbol_manager_ptr);
+        accesses.back().walk(*statements[i]);
+        has_return |= accesses.back().m_has_return;
+        has_call |= accesses.back().m_has_call;
+
+        const auto *assignment = dynamic_cast<const AssignmentNode *>(statements[i]);
+        if (!assignment || !assignment->getLvalue().getIndices().empty())
+            continue;
+        const SymbolEntry *target =
+            m_symbol_manager_ptr->lookup(assignment->getLvalue().getName());
+        if (!target->getTypePtr()->isInteger() ||
+            (target->getKind() != SymbolEntry::KindEnum::kVariableKind &&
+             target->getKind() != SymbolEntry::KindEnum::kParameterKind))
+            continue;
+
+        DegreeVisitor degree(m_symbol_manager_ptr, loop_var, target);
+        const int degree_of_step = degree.degreeOf(assignment->getExpr());
+        if (degree_of_step < 0 || degree_of_step > kMaxDegree ||
+            !degree.addsAccumulatorOnce())
+            continue;
+
+        candidates.push_back(Candidate{i, target, {assignment, target, {}},
+                                       degree_of_step,
+                                       std::move(degree.m_operands)});
+    }
+
+    m_symbol_manager_ptr->removeSymbolsFromHashTable(body.getSymbolTable());
+
+    // an early return skips the rest of the iterations
+    if (has_return)
+        return false;
+
+    const int64_t lower = p_for.getLowerBound().getConstantPtr()->integer();
+    const int64_t upper = p_for.getUpperBound().getConstantPtr()->integer();
+    const uint64_t trip_count = upper > lower ? upper - lower : 0;
+
+    for (auto &candidate : candidates)
+    {
+        bool folds = true;
+        // the functions called in the loop may write its global variables
+        auto is_private = [&](const SymbolEntry *p_entry) {
+            return !has_call || p_entry->getLevel() != 0 ||
+                   p_entry->getKind() == SymbolEntry::KindEnum::kConstantKind;
+        };
+        if (!is_private(candidate.accumulator))
+            folds = false;
+        for (size_t i = 0; i < accesses.size() && folds; ++i)
+        {
+            if (i != candidate.statement &&
+                (accesses[i].m_reads.count(candidate.accumulator) ||
+                 accesses[i].m_writes.count(candidate.accumulator)))
+                folds = false;
+            for (const SymbolEntry *operand : candidate.operands)
+            {
+                if (accesses[i].m_writes.count(operand) || !is_private(operand))
+                    folds = false;
+            }
+        }
+        if (!folds)
+            continue;
+
+        candidate.reduction.weights = computeWeights(trip_count, candidate.degree);
+        m_folded.insert(statements[candidate.statement]);
+        m_reductions.push_back(std::move(candidate.reduction));
+    }
+
+    m_loop_dead = m_folded.size() == statements.size();
+    return !m_reductions.empty();
+}
@@ -0,0 +1,412 @@
+#include "codegen/MachinePasses.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Basic-block list scheduler for single-issue in-order pipelines.
+//
+// The stack machine templates always consume a value right after producing
+// it, e.g. the second pop of a binary operator is followed by the operation
+// itself. To give the scheduler some freedom, sp-relative accesses are not
+// tied to the `addi sp, sp, k` adjustments around them: each one is keyed by
+// the stack slot it touches, and its offset is rebased when it moves across
+// an adjustment. An access is never moved to a point where its slot lies
+// below sp, since anything there may be clobbered by an interrupt handler.
+//
+// Building the dependency graph and picking from the ready list are both
+// quadratic in the instructions scheduled at once, and a block of
+// straight-line statements can have tens of thousands. Longer blocks are
+// scheduled in windows of kMaxWindow instructions, which is far more than
+// the stalls it hides span.
+static constexpr uint32_t kMaxWindow = 128;
+
+// Latencies are approximate; they only need to rank the stalls correctly.
+static const SchedModel kSchedModels[] = {
+    // name, load, mul, div
+    {"generic", 2, 3, 20},
+    // 5-stage in-order pipeline, as in spike's and Rocket's timing models
+    {"rocket", 3, 4, 33},
+    // Nuclei Bumblebee N200 of the GD32VF103: 2-stage pipeline with an
+    // iterative multiplier/divider
+    {"bumblebee", 2, 17, 33},
+};
+
+const SchedModel *findSchedModel(const char *p_name)
+{
+    for (const auto &model : kSchedModels)
+    {
+        if (strcmp(model.name, p_name) == 0)
+            return &model;
+    }
+    return nullptr;
+}
+
+namespace
+{
+
+bool isRegister(const std::string &p_str)
+{
+    static const std::set<std::string> kRegisters = {
+        "zero", "ra", "sp", "gp", "tp", "t0", "t1", "t2", "s0", "fp", "s1",
+        "a0",   "a1", "a2", "a3", "a4", "a5", "a6", "a7", "s2", "s3", "s4",
+        "s5",   "s6", "s7", "s8", "s9", "s10", "s11", "t3", "t4", "t5", "t6"};
+    return kRegisters.count(p_str) != 0;
+}
+
+bool isLoad(const std::string &p_opcode)
+{
+    return p_opcode == "lw" || p_opcode == "lh" || p_opcode == "lhu" ||
+           p_opcode == "lb" || p_opcode == "lbu";
+}
+
+bool isStore(const std::string &p_opcode)
+{
+    return p_opcode == "sw" || p_opcode == "sh" || p_opcode == "sb";
+}
+
+// anything that transfers control ends a block
+bool isBarrier(const MachineInstr &p_instr)
+{
+    if (!p_instr.isInstruction())
+        return true;
+    const auto &op = p_instr.opcode;
+    return op[0] == 'b' || op[0] == 'j' || op == "call" || op == "tail" ||
+           op == "ret" || op == "ecall" || op == "ebreak";
+}
+
+struct Node
+{
+    MachineInstr instr;
+    std::vector<std::string> defs, uses;
+    uint32_t latency = 1;
+
+    // memory access
+    bool is_mem = false, is_store = false;
+    std::string base;
+    long offset = 0;
+    // definitions of `base` in the block before this node, and up to and
+    // including it
+    uint32_t base_defs_before = 0, base_defs_through = 0;
+    // sp-relative accesses: slot relative to sp at block entry, and the
+    // range of adjustment counts at which the access stays above sp
+    bool rebased = false;
+    long slot = 0;
+    uint32_t min_adjusts = 0, max_adjusts = 0;
+
+    // `addi sp, sp, k`
+    bool is_sp_adjust = false;
+    long sp_delta = 0;
+
+    std::vector<std::pair<uint32_t, uint32_t>> succs; // (node, latency)
+    uint32_t num_preds = 0;
+    uint32_t priority = 0;
+
+    explicit Node(const MachineInstr &p_instr) : instr(p_instr) {}
+};
+
+void analyze(Node &p_node, const SchedModel &p_model)
+{
+    const auto &op = p_node.instr.opcode;
+    auto &operands = p_node.instr.operands;
+
+    for (uint32_t i = 0; i < operands.size(); ++i)
+    {
+        const auto &operand = operands[i];
+        const auto lparen = operand.find('(');
+        if (lparen != std::string::npos)
+        {
+            p_node.is_mem = true;
+            p_node.base =
+                operand.substr(lparen + 1, operand.size() - lparen - 2);
+            p_node.offset =
+                lparen ? std::strtol(operand.substr(0, lparen).c_str(),
+                                     nullptr, 0)
+                       : 0;
+            p_node.uses.emplace_back(p_node.base);
+        }
+        else if (isRegister(operand))
+        {
+            if (i == 0 && !isStore(op))
+                p_node.defs.emplace_back(operand);
+            else
+                p_node.uses.emplace_back(operand);
+        }
+    }
+    p_node.is_store = isStore(op);
+
+    if (isLoad(op))
+        p_node.latency = p_model.load_latency;
+    else if (op == "mul" || op == "mulh" || op == "mulhu" || op == "mulhsu")
+        p_node.latency = p_model.mul_latency;
+    else if (op == "div" || op == "divu" || op == "rem" || op == "remu")
+        p_node.latency = p_model.div_latency;
+
+    if (op == "addi" && operands[0] == "sp" && operands[1] == "sp")
+    {
+        p_node.is_sp_adjust = true;
+        p_node.sp_delta = std::strtol(operands[2].c_str(), nullptr, 0);
+    }
+}
+
+void addEdge(std::vector<Node> &p_nodes, const uint32_t p_from,
+             const uint32_t p_to, const uint32_t p_latency)
+{
+    p_nodes[p_from].succs.emplace_back(p_to, p_latency);
+    ++p_nodes[p_to].num_preds;
+}
+
+bool mayAlias(const Node &p_a, const Node &p_b)
+{
+    if (p_a.rebased && p_b.rebased)
+        return p_a.slot == p_b.slot;
+    // same base that isn't redefined in between is checked by the caller
+    return true;
+}
+
+void scheduleBlock(MachineFunction::Instrs &p_instrs, const uint32_t p_begin,
+                   const uint32_t p_end, const SchedModel &p_model)
+{
+    if (p_end - p_begin < 3)
+        return;
+
+    std::vector<Node> nodes;
+    for (uint32_t i = p_begin; i < p_end; ++i)
+    {
+        nodes.emplace_back(p_instrs[i]);
+        analyze(nodes.back(), p_model);
+    }
+    const uint32_t n = nodes.size();
+
+    std::map<std::string, uint32_t> num_defs;
+    for (auto &node : nodes)
+    {
+        if (node.is_mem)
+            node.base_defs_before = num_defs[node.base];
+        for (const auto &def : node.defs)
+            ++num_defs[def];
+        if (node.is_mem)
+            node.base_defs_through = num_defs[node.base];
+    }
+
+    // sp-relative accesses are rebased only if sp is changed by nothing but
+    // `addi sp, sp, k` in this block
+    bool can_rebase = true;
+    for (const auto &node : nodes)
+    {
+        if (!node.is_sp_adjust &&
+            std::find(node.defs.begin(), node.defs.end(), "sp") !=
+                node.defs.end())
+            can_rebase = false;
+    }
+
+    std::vector<uint32_t> adjusts;
+    std::vector<long> cumulative{0}; // sp displacement after k adjustments
+    if (can_rebase)
+    {
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            auto &node = nodes[i];
+            if (node.is_sp_adjust)
+            {
+                adjusts.emplace_back(i);
+                cumulative.emplace_back(cumulative.back() + node.sp_delta);
+            }
+            else if (node.is_mem && node.base == "sp")
+            {
+                node.rebased = true;
+                node.slot = node.offset + cumulative.back();
+
+                const uint32_t original = adjusts.size();
+                uint32_t lo = original, hi = original;
+                while (lo > 0 && cumulative[lo - 1] <= node.slot)
+                    --lo;
+                // adjustments after this node aren't known yet; clamp later
+                node.min_adjusts = lo;
+                node.max_adjusts = hi;
+            }
+        }
+        for (auto &node : nodes)
+        {
+            if (!node.rebased)
+                continue;
+            while (node.max_adjusts + 1 < cumulative.size() &&
+                   cumulative[node.max_adjusts + 1] <= node.slot)
+                ++node.max_adjusts;
+        }
+    }
+
+    // dependencies
+    for (uint32_t j = 0; j < n; ++j)
+    {
+        const auto &later = nodes[j];
+        for (uint32_t i = 0; i < j; ++i)
+        {
+            const auto &earlier = nodes[i];
+            uint32_t latency = 0;
+            bool dependent = false;
+
+            auto overlaps = [](const std::vector<std::string> &p_a,
+                               const std::vector<std::string> &p_b,
+                               const bool p_skip_sp) {
+                for (const auto &a : p_a)
+                {
+                    if (a == "zero" || (p_skip_sp && a == "sp"))
+                        continue;
+                    if (std::find(p_b.begin(), p_b.end(), a) != p_b.end())
+                        return true;
+                }
+                return false;
+            };
+            // sp dependencies between adjustments and rebased accesses are
+            // expressed by the slot ranges below
+            const bool skip_sp = (earlier.rebased && later.is_sp_adjust) ||
+                                 (earlier.is_sp_adjust && later.rebased);
+
+            if (overlaps(earlier.defs, later.uses, skip_sp))
+            {
+                dependent = true;
+                latency = std::max(latency, earlier.latency);
+            }
+            if (overlaps(earlier.uses, later.defs, skip_sp) ||
+                overlaps(earlier.defs, later.defs, skip_sp))
+            {
+                dependent = true;
+                latency = std::max(latency, 1u);
+            }
+
+            if (earlier.is_mem && later.is_mem &&
+                (earlier.is_store || later.is_store))
+            {
+                bool alias = mayAlias(earlier, later);
+                if (!earlier.rebased && !later.rebased &&
+                    earlier.base == later.base)
+                {
+                    // distinct offsets from the same, unchanged base never
+                    // overlap since all accesses are words
+                    const bool base_redefined =
+                        later.base_defs_before != earlier.base_defs_through;
+                    if (!base_redefined && earlier.offset != later.offset)
+                        alias = false;
+                }
+                if (alias)
+                    dependent = true;
+            }
+
+            if (dependent)
+                addEdge(nodes, i, j, std::max(latency, 1u));
+        }
+    }
+
+    // keep rebased accesses between the adjustments that keep them above sp
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        const auto &node = nodes[i];
+        if (!node.rebased)
+            continue;
+        if (node.min_adjusts > 0)
+            addEdge(nodes, adjusts[node.min_adjusts - 1], i, 1);
+        if (node.max_adjusts < adjusts.size())
+            addEdge(nodes, i, adjusts[node.max_adjusts], 1);
+    }
+
+    // priority: latency-weighted height
+    for (uint32_t i = n; i-- > 0;)
+    {
+        uint32_t height = 0;
+        for (const auto &succ : nodes[i].succs)
+            height = std::max(height, succ.second + nodes[succ.first].priority);
+        nodes[i].priority = height + 1;
+    }
+
+    // cycle-driven list scheduling
+    std::vector<uint32_t> earliest(n, 0), preds_left(n);
+    std::vector<bool> done(n, false);
+    for (uint32_t i = 0; i < n; ++i)
+        preds_left[i] = nodes[i].num_preds;
+
+    std::vector<uint32_t> order;
+    uint32_t cycle = 0;
+    long displacement = 0;
+    while (order.size() < n)
+    {
+        int best = -1;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            if (done[i] || preds_left[i] != 0)
+                continue;
+            if (best < 0)
+            {
+                best = i;
+                continue;
+            }
+            const bool ready = earliest[i] <= cycle;
+            const bool best_ready = earliest[best] <= cycle;
+            if (ready != best_ready)
+            {
+                if (ready)
+                    best = i;
+                continue;
+            }
+            if (!ready && earliest[i] != earliest[best])
+            {
+                if (earliest[i] < earliest[best])
+                    best = i;
+                continue;
+            }
+            if (nodes[i].priority > nodes[best].priority)
+                best = i;
+        }
+
+        auto &node = nodes[best];
+        cycle = std::max(cycle, earliest[best]);
+        done[best] = true;
+        order.emplace_back(best);
+
+        if (node.rebased)
+        {
+            node.instr.operands.back() =
+                std::to_string(node.slot - displacement) + "(sp)";
+        }
+        if (node.is_sp_adjust)
+            displacement += node.sp_delta;
+
+        for (const auto &succ : node.succs)
+        {
+            earliest[succ.first] =
+                std::max(earliest[succ.first], cycle + succ.second);
+            --preds_left[succ.first];
+        }
+        ++cycle;
+    }
+
+    for (uint32_t i = 0; i < n; ++i)
+        p_instrs[p_begin + i] = std::move(nodes[order[i]].instr);
+}
+
+} // namespace
+
+void scheduleFunction(MachineFunction &p_function,
+                      const CodeGenOptions &p_options)
+{
+    const SchedModel *model = p_options.sched_model;
+    if (!model)
+        return;
+
+    auto &instrs = p_function.getInstrs();
+    uint32_t begin = 0;
+    for (uint32_t i = 0; i <= instrs.size(); ++i)
+    {
+        if (i == instrs.size() || isBarrier(instrs[i]))
+        {
+            for (; i - begin > kMaxWindow; begin += kMaxWindow)
+                scheduleBlock(instrs, begin, begin + kMaxWindow, *model);
+            scheduleBlock(instrs, begin, i, *model);
+            begin = i + 1;
+        }
+    }
+}
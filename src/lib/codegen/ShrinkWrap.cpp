@@ -0,0 +1,583 @@
+#include "codegen/MachinePasses.hpp"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Shrink-wrapping: every function is emitted with the same frame, saving ra
+// and s0 on entry and restoring them in the single epilogue all returns
+// branch to. This pass drops the saves nothing needs and moves the save of ra
+// down to the block that dominates every call, so that paths without calls,
+// e.g. the base case of a recursion, return without touching it:
+//
+//   - no calls: ra is never saved;
+//   - nothing but the frame setup uses s0: s0 is never saved;
+//   - neither is saved: the frame isn't allocated at all.
+//
+// When ra is saved in a later block, the epilogue is split in two: the paths
+// through that block enter it at the restore of ra, the others skip it. The
+// templates keep the expression stack balanced at every block boundary, so
+// the frame is always at the same offset from sp wherever the save lands.
+
+namespace
+{
+
+const char *const kPrologue[] = {
+    "    addi sp, sp, -128",
+    "    sw ra, 124(sp)",
+    "    sw s0, 120(sp)",
+    "    addi s0, sp, 128",
+};
+const char *const kEpilogue[] = {
+    "    lw ra, 124(sp)",
+    "    lw s0, 120(sp)",
+    "    addi sp, sp, 128",
+    "    jr ra",
+};
+constexpr uint32_t kFrameLength = 4;
+
+bool matchesAt(const MachineFunction::Instrs &p_instrs, const uint32_t p_pos,
+               const char *const (&p_lines)[kFrameLength])
+{
+    if (p_pos + kFrameLength > p_instrs.size())
+        return false;
+    for (uint32_t i = 0; i < kFrameLength; ++i)
+    {
+        if (p_instrs[p_pos + i].toString() != p_lines[i])
+            return false;
+    }
+    return true;
+}
+
+bool isCall(const MachineInstr &p_instr)
+{
+    const auto &op = p_instr.opcode;
+    const auto &ops = p_instr.operands;
+    if (op == "call" || op == "tail")
+        return true;
+    if (op == "jal" || op == "jalr")
+        return ops.size() == 1 || ops[0] == "ra";
+    return false;
+}
+
+bool isConditionalBranch(const MachineInstr &p_instr)
+{
+    return p_instr.isInstruction() && p_instr.opcode[0] == 'b';
+}
+
+bool isJump(const MachineInstr &p_instr)
+{
+    return p_instr.isInstruction() && p_instr.opcode == "j";
+}
+
+bool isReturn(const MachineInstr &p_instr)
+{
+    return p_instr.isInstruction() &&
+           (p_instr.opcode == "jr" || p_instr.opcode == "ret");
+}
+
+bool mentionsFramePointer(const MachineInstr &p_instr)
+{
+    for (const auto &operand : p_instr.operands)
+    {
+        if (operand == "s0" || operand == "fp" ||
+            operand.find("(s0)") != std::string::npos ||
+            operand.find("(fp)") != std::string::npos)
+            return true;
+    }
+    return false;
+}
+
+struct Block
+{
+    uint32_t begin, end; // [begin, end) in the instruction list
+    std::vector<uint32_t> succs, preds;
+    bool has_call = false;
+};
+
+class ControlFlowGraph
+{
+public:
+    std::vector<Block> blocks;
+    std::vector<uint32_t> idom;
+
+    ControlFlowGraph(const MachineFunction::Instrs &p_instrs,
+                     const std::vector<uint32_t> &p_extra_leaders,
+                     const uint32_t p_entry_pos);
+
+    uint32_t blockOf(const uint32_t p_pos) const;
+    bool isReachable(const uint32_t p_block) const { return m_pre[p_block] >= 0; }
+    bool dominates(const uint32_t p_a, const uint32_t p_b) const;
+    uint32_t commonDominator(uint32_t p_a, const uint32_t p_b) const;
+    // whether `p_block` can reach itself, i.e. is part of a loop
+    bool isInCycle(const uint32_t p_block) const { return m_in_cycle[p_block]; }
+    // blocks reachable from the successors of `p_from`
+    std::vector<bool> reachableFrom(const uint32_t p_from) const;
+
+    uint32_t entry = 0;
+
+private:
+    // the reachable blocks in depth-first preorder and postorder, and the
+    // parent of each in that search
+    std::vector<uint32_t> m_dfs_order, m_dfs_postorder;
+    std::vector<uint32_t> m_dfs_parent;
+    // preorder and postorder numbers in the dominator tree, -1 if unreachable
+    std::vector<int> m_pre, m_post;
+    std::vector<bool> m_in_cycle;
+
+    void searchDepthFirst();
+    void computeDominators();
+    void numberDominatorTree();
+    void findCycles();
+};
+
+ControlFlowGraph::ControlFlowGraph(const MachineFunction::Instrs &p_instrs,
+                                   const std::vector<uint32_t> &p_extra_leaders,
+                                   const uint32_t p_entry_pos)
+{
+    const uint32_t n = p_instrs.size();
+    std::vector<bool> leader(n + 1, false);
+    leader[0] = leader[n] = true;
+    for (const uint32_t pos : p_extra_leaders)
+        leader[pos] = true;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        const auto &instr = p_instrs[i];
+        // a run of labels names one block
+        if (instr.isLabel() && (i == 0 || !p_instrs[i - 1].isLabel()))
+            leader[i] = true;
+        if (isConditionalBranch(instr) || isJump(instr) || isReturn(instr))
+            leader[i + 1] = true;
+    }
+    // the labels in front of a leader belong to its block
+    for (uint32_t i = n; i-- > 1;)
+    {
+        if (leader[i] && p_instrs[i - 1].isLabel())
+        {
+            leader[i] = false;
+            leader[i - 1] = true;
+        }
+    }
+
+    std::map<std::string, uint32_t> labels;
+    for (uint32_t i = 0; i < n;)
+    {
+        uint32_t j = i + 1;
+        while (!leader[j])
+            ++j;
+        blocks.push_back(Block{i, j, {}, {}, false});
+        i = j;
+    }
+    for (uint32_t b = 0; b < blocks.size(); ++b)
+    {
+        for (uint32_t i = blocks[b].begin; i < blocks[b].end; ++i)
+        {
+            if (p_instrs[i].isLabel())
+                labels.emplace(p_instrs[i].opcode, b);
+            if (isCall(p_instrs[i]))
+                blocks[b].has_call = true;
+        }
+    }
+
+    for (uint32_t b = 0; b < blocks.size(); ++b)
+    {
+        auto &block = blocks[b];
+        const MachineInstr *last = nullptr;
+        for (uint32_t i = block.begin; i < block.end; ++i)
+        {
+            if (p_instrs[i].isInstruction())
+                last = &p_instrs[i];
+        }
+
+        bool falls_through = true;
+        if (last && (isJump(*last) || isConditionalBranch(*last)))
+        {
+            auto target = labels.find(last->operands.back());
+            if (target != labels.end())
+                block.succs.push_back(target->second);
+            falls_through = !isJump(*last);
+        }
+        else if (last && isReturn(*last))
+        {
+            falls_through = false;
+        }
+        if (falls_through && b + 1 < blocks.size())
+            block.succs.push_back(b + 1);
+    }
+    for (uint32_t b = 0; b < blocks.size(); ++b)
+    {
+        for (const uint32_t succ : blocks[b].succs)
+            blocks[succ].preds.push_back(b);
+    }
+
+    entry = blockOf(p_entry_pos);
+    searchDepthFirst();
+    computeDominators();
+    numberDominatorTree();
+    findCycles();
+}
+
+uint32_t ControlFlowGraph::blockOf(const uint32_t p_pos) const
+{
+    for (uint32_t b = 0; b < blocks.size(); ++b)
+    {
+        if (blocks[b].begin <= p_pos && p_pos < blocks[b].end)
+            return b;
+    }
+    return blocks.size();
+}
+
+void ControlFlowGraph::searchDepthFirst()
+{
+    const uint32_t n = blocks.size();
+    m_dfs_parent.assign(n, n);
+    std::vector<bool> visited(n, false);
+    // (block, next successor to visit)
+    std::vector<std::pair<uint32_t, uint32_t>> stack{{entry, 0}};
+    visited[entry] = true;
+    m_dfs_order.push_back(entry);
+    while (!stack.empty())
+    {
+        auto &top = stack.back();
+        if (top.second == blocks[top.first].succs.size())
+        {
+            m_dfs_postorder.push_back(top.first);
+            stack.pop_back();
+            continue;
+        }
+        const uint32_t succ = blocks[top.first].succs[top.second++];
+        if (!visited[succ])
+        {
+            visited[succ] = true;
+            m_dfs_order.push_back(succ);
+            m_dfs_parent[succ] = top.first;
+            stack.emplace_back(succ, 0);
+        }
+    }
+}
+
+// Lengauer and Tarjan, "A Fast Algorithm for Finding Dominators in a
+// Flowgraph", with path compression but without balancing. Deeply nested
+// statements give long chains of dominators, which an iterative algorithm
+// would walk again for every join.
+void ControlFlowGraph::computeDominators()
+{
+    const uint32_t n = blocks.size();
+    idom.assign(n, n);
+
+    // depth-first numbers; semi[] holds them too
+    std::vector<uint32_t> number(n, n);
+    for (uint32_t i = 0; i < m_dfs_order.size(); ++i)
+        number[m_dfs_order[i]] = i;
+    std::vector<uint32_t> semi(number);
+    std::vector<uint32_t> ancestor(n, n);
+    std::vector<uint32_t> label(n);
+    for (uint32_t b = 0; b < n; ++b)
+        label[b] = b;
+    std::vector<std::vector<uint32_t>> bucket(n);
+
+    // the block with the smallest semidominator on the path from `p_block`
+    // up to the root of its tree in the forest, compressing the path
+    std::vector<uint32_t> path;
+    auto eval = [&](const uint32_t p_block) {
+        if (ancestor[p_block] == n)
+            return p_block;
+        path.clear();
+        for (uint32_t b = p_block; ancestor[ancestor[b]] != n; b = ancestor[b])
+            path.push_back(b);
+        for (auto it = path.rbegin(); it != path.rend(); ++it)
+        {
+            const uint32_t b = *it, a = ancestor[b];
+            if (semi[label[a]] < semi[label[b]])
+                label[b] = label[a];
+            ancestor[b] = ancestor[a];
+        }
+        return label[p_block];
+    };
+
+    for (uint32_t i = m_dfs_order.size(); i-- > 1;)
+    {
+        const uint32_t w = m_dfs_order[i];
+        for (const uint32_t pred : blocks[w].preds)
+        {
+            if (number[pred] == n)
+                continue;
+            semi[w] = std::min(semi[w], semi[eval(pred)]);
+        }
+        bucket[m_dfs_order[semi[w]]].push_back(w);
+
+        const uint32_t parent = m_dfs_parent[w];
+        ancestor[w] = parent;
+        for (const uint32_t v : bucket[parent])
+        {
+            const uint32_t u = eval(v);
+            idom[v] = semi[u] < semi[v] ? u : parent;
+        }
+        bucket[parent].clear();
+    }
+    for (uint32_t i = 1; i < m_dfs_order.size(); ++i)
+    {
+        const uint32_t w = m_dfs_order[i];
+        if (idom[w] != m_dfs_order[semi[w]])
+            idom[w] = idom[idom[w]];
+    }
+    idom[entry] = entry;
+}
+
+void ControlFlowGraph::numberDominatorTree()
+{
+    const uint32_t n = blocks.size();
+    m_pre.assign(n, -1);
+    m_post.assign(n, -1);
+
+    std::vector<std::vector<uint32_t>> children(n);
+    for (const uint32_t b : m_dfs_order)
+    {
+        if (b != entry)
+            children[idom[b]].push_back(b);
+    }
+    int pre = 0, post = 0;
+    // (block, next child to visit)
+    std::vector<std::pair<uint32_t, uint32_t>> stack{{entry, 0}};
+    m_pre[entry] = pre++;
+    while (!stack.empty())
+    {
+        auto &top = stack.back();
+        if (top.second == children[top.first].size())
+        {
+            m_post[top.first] = post++;
+            stack.pop_back();
+            continue;
+        }
+        const uint32_t child = children[top.first][top.second++];
+        m_pre[child] = pre++;
+        stack.emplace_back(child, 0);
+    }
+}
+
+// Kosaraju: taking the blocks in reverse postorder, the blocks not yet
+// assigned that reach one backwards form its strongly connected component
+void ControlFlowGraph::findCycles()
+{
+    const uint32_t n = blocks.size();
+    m_in_cycle.assign(n, false);
+
+    std::vector<bool> assigned(n, false);
+    std::vector<uint32_t> members;
+    for (auto it = m_dfs_postorder.rbegin(); it != m_dfs_postorder.rend(); ++it)
+    {
+        if (assigned[*it])
+            continue;
+        members.assign(1, *it);
+        assigned[*it] = true;
+        for (uint32_t i = 0; i < members.size(); ++i)
+        {
+            for (const uint32_t pred : blocks[members[i]].preds)
+            {
+                if (isReachable(pred) && !assigned[pred])
+                {
+                    assigned[pred] = true;
+                    members.push_back(pred);
+                }
+            }
+        }
+        for (const uint32_t b : members)
+            m_in_cycle[b] = members.size() > 1;
+    }
+    for (const uint32_t b : m_dfs_order)
+    {
+        for (const uint32_t succ : blocks[b].succs)
+        {
+            if (succ == b)
+                m_in_cycle[b] = true;
+        }
+    }
+}
+
+bool ControlFlowGraph::dominates(const uint32_t p_a, const uint32_t p_b) const
+{
+    return m_pre[p_a] <= m_pre[p_b] && m_post[p_b] <= m_post[p_a];
+}
+
+// raising only `p_a`, so that folding a set of blocks into it walks each
+// dominator at most once
+uint32_t ControlFlowGraph::commonDominator(uint32_t p_a, const uint32_t p_b) const
+{
+    while (!dominates(p_a, p_b))
+        p_a = idom[p_a];
+    return p_a;
+}
+
+std::vector<bool> ControlFlowGraph::reachableFrom(const uint32_t p_from) const
+{
+    std::vector<bool> reached(blocks.size(), false);
+    std::vector<uint32_t> worklist(blocks[p_from].succs);
+    while (!worklist.empty())
+    {
+        const uint32_t b = worklist.back();
+        worklist.pop_back();
+        if (reached[b])
+            continue;
+        reached[b] = true;
+        worklist.insert(worklist.end(), blocks[b].succs.begin(),
+                        blocks[b].succs.end());
+    }
+    return reached;
+}
+
+// Returns the block to save ra in: the nearest common dominator of the
+// blocks with calls, raised out of any loop so that the save runs before
+// the first call overwrites ra, and only if the paths to the epilogue are
+// split cleanly by it.
+uint32_t findSaveBlock(const ControlFlowGraph &p_cfg, const uint32_t p_exit)
+{
+    const auto &blocks = p_cfg.blocks;
+    const uint32_t none = blocks.size();
+
+    uint32_t save = none;
+    for (uint32_t b = 0; b < blocks.size(); ++b)
+    {
+        if (!blocks[b].has_call || !p_cfg.isReachable(b))
+            continue;
+        save = save == none ? b : p_cfg.commonDominator(save, b);
+    }
+    if (save == none)
+        return p_cfg.entry;
+
+    while (save != p_cfg.entry && p_cfg.isInCycle(save))
+        save = p_cfg.idom[save];
+    if (save == p_cfg.entry)
+        return save;
+
+    // a return that may or may not have passed the save can't tell whether
+    // ra is on the stack
+    const auto after_save = p_cfg.reachableFrom(save);
+    for (const uint32_t pred : blocks[p_exit].preds)
+    {
+        if (after_save[pred] && !p_cfg.dominates(save, pred))
+            return p_cfg.entry;
+    }
+    return save;
+}
+
+} // namespace
+
+void shrinkWrapFunction(MachineFunction &p_function,
+                        const CodeGenOptions &p_options)
+{
+    if (!p_options.shrink_wrap)
+        return;
+
+    auto &instrs = p_function.getInstrs();
+    const uint32_t n = instrs.size();
+
+    uint32_t prologue = n, epilogue = n;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (prologue == n && matchesAt(instrs, i, kPrologue))
+            prologue = i;
+        else if (matchesAt(instrs, i, kEpilogue))
+            epilogue = i;
+    }
+    if (prologue == n || epilogue == n || epilogue < prologue)
+        return;
+
+    bool uses_s0 = false;
+    bool has_call = false;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        const bool in_frame =
+            (i >= prologue && i < prologue + kFrameLength) ||
+            (i >= epilogue && i < epilogue + kFrameLength);
+        if (!in_frame && mentionsFramePointer(instrs[i]))
+            uses_s0 = true;
+        if (isCall(instrs[i]))
+            has_call = true;
+    }
+
+    const ControlFlowGraph cfg(instrs, {prologue, epilogue}, prologue);
+    const uint32_t exit = cfg.blockOf(epilogue);
+    const uint32_t save = has_call ? findSaveBlock(cfg, exit) : cfg.entry;
+    const bool move_ra = has_call && save != cfg.entry;
+    // without s0, nothing but ra lives in the frame
+    const bool move_frame = move_ra && !uses_s0;
+    const bool keep_frame = has_call || uses_s0;
+
+    std::set<uint32_t> dropped;
+    std::map<uint32_t, std::vector<MachineInstr>> inserted_before;
+    auto insert_before = [&](const uint32_t p_pos, const std::string &p_line) {
+        inserted_before[p_pos].push_back(MachineInstr::parse(p_line));
+    };
+
+    if (!uses_s0)
+    {
+        dropped.insert({prologue + 2, prologue + 3, epilogue + 1});
+    }
+    if (!has_call || move_ra)
+    {
+        dropped.insert({prologue + 1, epilogue});
+    }
+    if (!keep_frame || move_frame)
+    {
+        dropped.insert({prologue, epilogue + 2});
+    }
+
+    if (move_ra)
+    {
+        const auto &block = cfg.blocks[save];
+        uint32_t pos = block.begin;
+        while (pos < block.end && instrs[pos].isLabel())
+            ++pos;
+        if (move_frame)
+            insert_before(pos, kPrologue[0]);
+        insert_before(pos, kPrologue[1]);
+
+        // the paths through the save enter the epilogue at the restore of
+        // ra, the others right after it
+        const std::string skip_label = p_function.getName() + ".return";
+        std::set<std::string> exit_labels;
+        for (uint32_t i = cfg.blocks[exit].begin; i < epilogue; ++i)
+            exit_labels.insert(instrs[i].opcode);
+
+        for (const uint32_t pred : cfg.blocks[exit].preds)
+        {
+            if (!cfg.isReachable(pred) || cfg.dominates(save, pred))
+                continue;
+            const auto &block = cfg.blocks[pred];
+            bool jumps = false;
+            for (uint32_t i = block.begin; i < block.end; ++i)
+            {
+                auto &instr = instrs[i];
+                if ((isJump(instr) || isConditionalBranch(instr)) &&
+                    exit_labels.count(instr.operands.back()))
+                {
+                    instr.operands.back() = skip_label;
+                    jumps = isJump(instr);
+                }
+            }
+            if (!jumps && pred + 1 == exit)
+                insert_before(block.end, "    j " + skip_label);
+        }
+
+        insert_before(epilogue, kEpilogue[0]);
+        if (move_frame)
+            insert_before(epilogue, kEpilogue[2]);
+        insert_before(epilogue, skip_label + ":");
+    }
+
+    MachineFunction::Instrs rewritten;
+    for (uint32_t i = 0; i <= n; ++i)
+    {
+        auto found = inserted_before.find(i);
+        if (found != inserted_before.end())
+        {
+            for (auto &instr : found->second)
+                rewritten.emplace_back(std::move(instr));
+        }
+        if (i < n && !dropped.count(i))
+            rewritten.emplace_back(std::move(instrs[i]));
+    }
+    instrs = std::move(rewritten);
+}
@@ -8,7 +8,7 @@
 static constexpr const char *kRedeclaredSymbolErrorMessage =
     "symbol '%s' is redeclared";
 
-void SemanticAnalyzer::visit(ProgramNode &p_program) {
+bool SemanticAnalyzer::enter(ProgramNode &p_program) {
     m_symbol_manager.pushGlobalScope();
     m_context_stack.push(SemanticContext::kGlobal);
     m_returned_type_stack.push(p_program.getTypePtr());
@@ -22,8 +22,10 @@ void SemanticAnalyzer::visit(ProgramNode &p_program) {
         m_has_error = true;
     }
 
-    p_program.visitChildNodes(*this);
+    return true;
+}
 
+void SemanticAnalyzer::leave(ProgramNode &p_program) {
     p_program.setSymbolTable(m_symbol_manager.getCurrentTable());
 
     m_returned_type_stack.pop();
@@ -31,10 +33,6 @@ void SemanticAnalyzer::visit(ProgramNode &p_program) {
     m_symbol_manager.popGlobalScope();
 }
 
-void SemanticAnalyzer::visit(DeclNode &p_decl) {
-    p_decl.visitChildNodes(*this);
-}
-
 SymbolEntry::KindEnum
 SemanticAnalyzer::determineVarKind(const VariableNode &p_variable) {
     if (isInForLoop()) {
@@ -86,23 +84,22 @@ static bool validateDimensions(const VariableNode &p_variable) {
     return !has_error;
 }
 
-void SemanticAnalyzer::visit(VariableNode &p_variable) {
+// the constant the variable may have is typed on its own, after this
+bool SemanticAnalyzer::enter(VariableNode &p_variable) {
     auto *entry = addSymbol(p_variable);
 
-    p_variable.visitChildNodes(*this);
-
     if (entry && !validateDimensions(p_variable)) {
         m_error_entry_set.insert(entry);
         m_has_error = true;
     }
+    return true;
 }
 
-void SemanticAnalyzer::visit(ConstantValueNode &p_constant_value) {
-    p_constant_value.setInferredType(
-        p_constant_value.getTypePtr()->getStructElementType(0));
+void SemanticAnalyzer::leave(ConstantValueNode &p_constant_value) {
+    p_constant_value.setInferredType(p_constant_value.getTypePtr());
 }
 
-void SemanticAnalyzer::visit(FunctionNode &p_function) {
+bool SemanticAnalyzer::enter(FunctionNode &p_function) {
     auto success = m_symbol_manager.addSymbol(
         p_function.getName(), SymbolEntry::KindEnum::kFunctionKind,
         p_function.getTypePtr(), &p_function.getParameters());
@@ -117,15 +114,21 @@ void SemanticAnalyzer::visit(FunctionNode &p_function) {
     m_context_stack.push(SemanticContext::kFunction);
     m_returned_type_stack.push(p_function.getTypePtr());
 
-    auto visit_ast_node = [this](auto &ast_node) { ast_node->accept(*this); };
-    for_each(p_function.getParameters().begin(),
-             p_function.getParameters().end(), visit_ast_node);
+    for (auto *const parameter : p_function.getParameters()) {
+        schedule(*parameter);
+    }
 
     // directly visit the body to prevent pushing duplicate scope
-    m_context_stack.push(SemanticContext::kLocal);
-    p_function.visitBodyChildNodes(*this);
-    m_context_stack.pop();
+    if (p_function.hasBody()) {
+        schedule([this] { m_context_stack.push(SemanticContext::kLocal); });
+        scheduleChildNodes(*p_function.getBody());
+        schedule([this] { m_context_stack.pop(); });
+    }
+    scheduleLeave(p_function);
+    return false;
+}
 
+void SemanticAnalyzer::leave(FunctionNode &p_function) {
     p_function.setSymbolTable(m_symbol_manager.getCurrentTable());
 
     m_returned_type_stack.pop();
@@ -133,12 +136,13 @@ void SemanticAnalyzer::visit(FunctionNode &p_function) {
     m_symbol_manager.popScope();
 }
 
-void SemanticAnalyzer::visit(CompoundStatementNode &p_compound_statement) {
+bool SemanticAnalyzer::enter(CompoundStatementNode &p_compound_statement) {
     m_symbol_manager.pushScope();
     m_context_stack.push(SemanticContext::kLocal);
+    return true;
+}
 
-    p_compound_statement.visitChildNodes(*this);
-
+void SemanticAnalyzer::leave(CompoundStatementNode &p_compound_statement) {
     p_compound_statement.setSymbolTable(m_symbol_manager.getCurrentTable());
 
     m_context_stack.pop();
@@ -160,9 +164,7 @@ static bool validatePrintTarget(const PrintNode &p_print) {
     return true;
 }
 
-void SemanticAnalyzer::visit(PrintNode &p_print) {
-    p_print.visitChildNodes(*this);
-
+void SemanticAnalyzer::leave(PrintNode &p_print) {
     if (!validatePrintTarget(p_print)) {
         m_has_error = true;
     }
@@ -250,7 +252,8 @@ static bool validateBinaryOperands(BinaryOperatorNode &p_bin_op) {
     return false;
 }
 
-static void setBinaryOpInferredType(BinaryOperatorNode &p_bin_op) {
+static void setBinaryOpInferredType(TypeContext &p_types,
+                                    BinaryOperatorNode &p_bin_op) {
     switch (p_bin_op.getOp()) {
     case Operator::kPlusOp:
     case Operator::kMinusOp:
@@ -258,24 +261,24 @@ static void setBinaryOpInferredType(BinaryOperatorNode &p_bin_op) {
     case Operator::kDivideOp:
         if (p_bin_op.getLeftOperand().getInferredType()->isString()) {
             p_bin_op.setInferredType(
-                new PType(PType::PrimitiveTypeEnum::kStringType));
+                p_types.getType(PType::PrimitiveTypeEnum::kStringType));
             return;
         }
 
         if (p_bin_op.getLeftOperand().getInferredType()->isReal() ||
             p_bin_op.getRightOperand().getInferredType()->isReal()) {
             p_bin_op.setInferredType(
-                new PType(PType::PrimitiveTypeEnum::kRealType));
+                p_types.getType(PType::PrimitiveTypeEnum::kRealType));
             return;
         }
     case Operator::kModOp:
         p_bin_op.setInferredType(
-            new PType(PType::PrimitiveTypeEnum::kIntegerType));
+            p_types.getType(PType::PrimitiveTypeEnum::kIntegerType));
         return;
     case Operator::kAndOp:
     case Operator::kOrOp:
         p_bin_op.setInferredType(
-            new PType(PType::PrimitiveTypeEnum::kBoolType));
+            p_types.getType(PType::PrimitiveTypeEnum::kBoolType));
         return;
     case Operator::kLessOp:
     case Operator::kLessOrEqualOp:
@@ -284,22 +287,20 @@ static void setBinaryOpInferredType(BinaryOperatorNode &p_bin_op) {
     case Operator::kGreaterOrEqualOp:
     case Operator::kNotEqualOp:
         p_bin_op.setInferredType(
-            new PType(PType::PrimitiveTypeEnum::kBoolType));
+            p_types.getType(PType::PrimitiveTypeEnum::kBoolType));
         return;
     default:
         assert(false && "unknown binary op or unary op");
     }
 }
 
-void SemanticAnalyzer::visit(BinaryOperatorNode &p_bin_op) {
-    p_bin_op.visitChildNodes(*this);
-
+void SemanticAnalyzer::leave(BinaryOperatorNode &p_bin_op) {
     if (!validateBinaryOperands(p_bin_op)) {
         m_has_error = true;
         return;
     }
 
-    setBinaryOpInferredType(p_bin_op);
+    setBinaryOpInferredType(m_context.getTypes(), p_bin_op);
 }
 
 static bool validateUnaryOperand(const UnaryOperatorNode &p_un_op) {
@@ -329,34 +330,34 @@ static bool validateUnaryOperand(const UnaryOperatorNode &p_un_op) {
     return false;
 }
 
-static void setUnaryOpInferredType(UnaryOperatorNode &p_un_op) {
+static void setUnaryOpInferredType(TypeContext &p_types,
+                                   UnaryOperatorNode &p_un_op) {
     switch (p_un_op.getOp()) {
     case Operator::kNegOp:
-        p_un_op.setInferredType(new PType(
+        p_un_op.setInferredType(p_types.getType(
             p_un_op.getOperand().getInferredType()->getPrimitiveType()));
         return;
     case Operator::kNotOp:
-        p_un_op.setInferredType(new PType(PType::PrimitiveTypeEnum::kBoolType));
+        p_un_op.setInferredType(
+            p_types.getType(PType::PrimitiveTypeEnum::kBoolType));
         return;
     default:
         assert(false && "unknown binary op or unary op");
     }
 }
 
-void SemanticAnalyzer::visit(UnaryOperatorNode &p_un_op) {
-    p_un_op.visitChildNodes(*this);
-
+void SemanticAnalyzer::leave(UnaryOperatorNode &p_un_op) {
     if (!validateUnaryOperand(p_un_op)) {
         m_has_error = true;
         return;
     }
 
-    setUnaryOpInferredType(p_un_op);
+    setUnaryOpInferredType(m_context.getTypes(), p_un_op);
 }
 
 static const SymbolEntry *
 checkSymbolExistence(const SymbolManager &p_symbol_manager,
-                     const std::string &p_name, const Location &p_location) {
+                     const InternedString p_name, const Location p_location) {
     const auto *entry = p_symbol_manager.lookup(p_name);
 
     if (entry == nullptr) {
@@ -419,15 +420,14 @@ static bool validateArguments(const SymbolEntry *const p_entry,
 }
 
 static void
-setFuncInvocationInferredType(FunctionInvocationNode &p_func_invocation,
+setFuncInvocationInferredType(TypeContext &p_types,
+                              FunctionInvocationNode &p_func_invocation,
                               const SymbolEntry *p_entry) {
     p_func_invocation.setInferredType(
-        new PType(p_entry->getTypePtr()->getPrimitiveType()));
+        p_types.getType(p_entry->getTypePtr()->getPrimitiveType()));
 }
 
-void SemanticAnalyzer::visit(FunctionInvocationNode &p_func_invocation) {
-    p_func_invocation.visitChildNodes(*this);
-
+void SemanticAnalyzer::leave(FunctionInvocationNode &p_func_invocation) {
     const SymbolEntry *entry = nullptr;
     if ((entry = checkSymbolExistence(
              m_symbol_manager, p_func_invocation.getName(),
@@ -446,7 +446,8 @@ void SemanticAnalyzer::visit(FunctionInvocationNode &p_func_invocation) {
         return;
     }
 
-    setFuncInvocationInferredType(p_func_invocation, entry);
+    setFuncInvocationInferredType(m_context.getTypes(), p_func_invocation,
+                                  entry);
 }
 
 static bool validateVariableKind(const SymbolEntry::KindEnum kind,
@@ -493,9 +494,7 @@ validateArraySubscriptNum(const PType *p_var_type,
     return true;
 }
 
-void SemanticAnalyzer::visit(VariableReferenceNode &p_variable_ref) {
-    p_variable_ref.visitChildNodes(*this);
-
+void SemanticAnalyzer::leave(VariableReferenceNode &p_variable_ref) {
     const SymbolEntry *entry = nullptr;
     if ((entry =
              checkSymbolExistence(m_symbol_manager, p_variable_ref.getName(),
@@ -520,8 +519,8 @@ void SemanticAnalyzer::visit(VariableReferenceNode &p_variable_ref) {
         return;
     }
 
-    p_variable_ref.setInferredType(entry->getTypePtr()->getStructElementType(
-        p_variable_ref.getIndices().size()));
+    p_variable_ref.setInferredType(m_context.getTypes().getElementType(
+        entry->getTypePtr(), p_variable_ref.getIndices().size()));
 }
 
 static bool validateAssignmentLvalue(const AssignmentNode &p_assignment,
@@ -584,9 +583,7 @@ static bool validateAssignmentExpr(const AssignmentNode &p_assignment) {
     return true;
 }
 
-void SemanticAnalyzer::visit(AssignmentNode &p_assignment) {
-    p_assignment.visitChildNodes(*this);
-
+void SemanticAnalyzer::leave(AssignmentNode &p_assignment) {
     if (!validateAssignmentLvalue(p_assignment, m_symbol_manager,
                                   isInForLoop())) {
         m_has_error = true;
@@ -629,9 +626,7 @@ static bool validateReadTarget(const ReadNode &p_read,
     return true;
 }
 
-void SemanticAnalyzer::visit(ReadNode &p_read) {
-    p_read.visitChildNodes(*this);
-
+void SemanticAnalyzer::leave(ReadNode &p_read) {
     if (!validateReadTarget(p_read, m_symbol_manager)) {
         m_has_error = true;
     }
@@ -652,17 +647,13 @@ static bool validateConditionExpr(const ExpressionNode &p_condition) {
     return true;
 }
 
-void SemanticAnalyzer::visit(IfNode &p_if) {
-    p_if.visitChildNodes(*this);
-
+void SemanticAnalyzer::leave(IfNode &p_if) {
     if (!validateConditionExpr(p_if.getCondition())) {
         m_has_error = true;
     }
 }
 
-void SemanticAnalyzer::visit(WhileNode &p_while) {
-    p_while.visitChildNodes(*this);
-
+void SemanticAnalyzer::leave(WhileNode &p_while) {
     if (!validateConditionExpr(p_while.getCondition())) {
         m_has_error = true;
     }
@@ -682,12 +673,13 @@ static bool validateForLoopBound(const ForNode &p_for) {
     return true;
 }
 
-void SemanticAnalyzer::visit(ForNode &p_for) {
+bool SemanticAnalyzer::enter(ForNode &p_for) {
     m_symbol_manager.pushScope();
     m_context_stack.push(SemanticContext::kForLoop);
+    return true;
+}
 
-    p_for.visitChildNodes(*this);
-
+void SemanticAnalyzer::leave(ForNode &p_for) {
     if (!validateForLoopBound(p_for)) {
         m_has_error = true;
     }
@@ -716,9 +708,7 @@ static bool validateReturnValueType(const ExpressionNode &p_retval,
     return true;
 }
 
-void SemanticAnalyzer::visit(ReturnNode &p_return) {
-    p_return.visitChildNodes(*this);
-
+void SemanticAnalyzer::leave(ReturnNode &p_return) {
     const auto *const expected_return_type_ptr = m_returned_type_stack.top();
     if (expected_return_type_ptr->isVoid()) {
         logSemanticError(p_return.getLocation(),
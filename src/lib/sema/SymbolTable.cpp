@@ -28,7 +28,7 @@ const FunctionNode::DeclNodes *Attribute::parameters() const {
 // ===========================================
 // > SymbolTable
 // ===========================================
-SymbolEntry *SymbolTable::addSymbol(const std::string &p_name,
+SymbolEntry *SymbolTable::addSymbol(const InternedString p_name,
                                     const SymbolEntry::KindEnum kind,
                                     const size_t level,
                                     const PType *const p_type,
@@ -39,7 +39,7 @@ SymbolEntry *SymbolTable::addSymbol(const std::string &p_name,
 }
 
 SymbolEntry *
-SymbolTable::addSymbol(const std::string &p_name,
+SymbolTable::addSymbol(const InternedString p_name,
                        const SymbolEntry::KindEnum kind, const size_t level,
                        const PType *const p_type,
                        const FunctionNode::DeclNodes *const p_parameters) {
@@ -205,7 +205,7 @@ void SymbolManager::popScope() {
 }
 
 std::pair<bool, SymbolEntry *>
-SymbolManager::checkExistence(const std::string &p_name,
+SymbolManager::checkExistence(const InternedString p_name,
                               const size_t current_level) const {
     auto search_result = m_hash_entries.find(p_name);
 
@@ -225,7 +225,7 @@ SymbolManager::checkExistence(const std::string &p_name,
 
 template <typename AttributeType>
 SymbolEntry *
-genericAddSymbol(SymbolManager &p_manager, const std::string &p_name,
+genericAddSymbol(SymbolManager &p_manager, const InternedString p_name,
                  const SymbolEntry::KindEnum kind, const PType *const p_type,
                  const AttributeType *const p_attribute) {
     auto existence_pair =
@@ -253,7 +253,7 @@ genericAddSymbol(SymbolManager &p_manager, const std::string &p_name,
     return new_entry;
 }
 
-SymbolEntry *SymbolManager::addSymbol(const std::string &p_name,
+SymbolEntry *SymbolManager::addSymbol(const InternedString p_name,
                                       const SymbolEntry::KindEnum kind,
                                       const PType *const p_type,
                                       const Constant *const p_constant) {
@@ -261,7 +261,7 @@ SymbolEntry *SymbolManager::addSymbol(const std::string &p_name,
 }
 
 SymbolEntry *
-SymbolManager::addSymbol(const std::string &p_name,
+SymbolManager::addSymbol(const InternedString p_name,
                          const SymbolEntry::KindEnum kind,
                          const PType *const p_type,
                          const FunctionNode::DeclNodes *const p_parameters) {
@@ -269,7 +269,7 @@ SymbolManager::addSymbol(const std::string &p_name,
                                                      p_type, p_parameters);
 }
 
-const SymbolEntry *SymbolManager::lookup(const std::string &p_name) const {
+const SymbolEntry *SymbolManager::lookup(const InternedString p_name) const {
     auto search_result = m_hash_entries.find(p_name);
 
     if (search_result != m_hash_entries.end()) {
@@ -1,14 +1,13 @@
 #include "AST/ast.hpp"
+#include "util/SourceFile.hpp"
 
 #include <cstdarg>
 #include <cstdio>
 
-extern FILE *yyin;
-extern long line_positions[];
-
-void logSemanticError(const Location &p_location, const char *format, ...) {
+void logSemanticError(const Location p_location, const char *format, ...) {
+    const auto position = p_location.decode();
     std::fprintf(stderr, "<Error> Found in line %u, column %u: ",
-                 p_location.line, p_location.col);
+                 position.line, position.col);
 
     va_list args;
     va_start(args, format);
@@ -17,12 +16,12 @@ void logSemanticError(const Location &p_location, const char *format, ...) {
 
     // print notation
     constexpr uint32_t kIndentionWidth = 4;
-    if (std::fseek(yyin, line_positions[p_location.line], SEEK_SET) == 0) {
-        char buffer[512];
-        std::fgets(buffer, sizeof(buffer), yyin);
-        std::fprintf(stderr, "\n%*s%s", kIndentionWidth, "", buffer);
-        std::fprintf(stderr, "%*s\n", kIndentionWidth + p_location.col, "^");
-    } else {
-        std::fprintf(stderr, "Fail to reposition the yyin file stream.\n");
+    size_t length = 0;
+    const char *line = "";
+    if (const SourceFile *const file = SourceFile::getFileOf(p_location)) {
+        line = file->getLine(position.line, length);
     }
+    std::fprintf(stderr, "\n%*s%.*s\n", kIndentionWidth, "",
+                 static_cast<int>(length), line);
+    std::fprintf(stderr, "%*s\n", kIndentionWidth + position.col, "^");
 }
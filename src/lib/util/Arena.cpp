@@ -0,0 +1,66 @@
+#include "util/Arena.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+constexpr size_t Arena::kMinBlockSize;
+constexpr size_t Arena::kMaxBlockSize;
+
+void *Arena::allocateInNewBlock(const size_t p_size, const size_t p_align) {
+    // the header is kept at the front of the block, so the first object
+    // only needs padding when it wants more than max_align_t
+    const size_t header_size =
+        (sizeof(Block) + alignof(std::max_align_t) - 1) &
+        ~(alignof(std::max_align_t) - 1);
+    const size_t needed = header_size + p_size + p_align;
+
+    // A request larger than the next block gets a block of its own, so that
+    // the rest of the current block isn't thrown away for it.
+    const bool oversized = needed > m_next_block_size;
+    const size_t block_size = oversized ? needed : m_next_block_size;
+    auto *const block = static_cast<Block *>(std::malloc(block_size));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+
+    char *const begin = reinterpret_cast<char *>(block) + header_size;
+    const uintptr_t aligned =
+        (reinterpret_cast<uintptr_t>(begin) + p_align - 1) & ~(p_align - 1);
+    m_bytes_allocated += p_size;
+
+    if (oversized && m_last_block) {
+        // keep bumping in the current block; put this one behind it
+        block->prev = m_last_block->prev;
+        m_last_block->prev = block;
+        return reinterpret_cast<void *>(aligned);
+    }
+
+    block->prev = m_last_block;
+    m_last_block = block;
+    m_cur = reinterpret_cast<char *>(aligned + p_size);
+    m_end = reinterpret_cast<char *>(block) + block_size;
+    m_next_block_size = std::min(m_next_block_size * 2, kMaxBlockSize);
+    return reinterpret_cast<void *>(aligned);
+}
+
+char *Arena::copyString(const char *p_text, const size_t p_length) {
+    auto *const copy = static_cast<char *>(allocate(p_length + 1, 1));
+    std::memcpy(copy, p_text, p_length);
+    copy[p_length] = '\0';
+    return copy;
+}
+
+void Arena::release() {
+    for (Block *block = m_last_block; block;) {
+        Block *const prev = block->prev;
+        std::free(block);
+        block = prev;
+    }
+    m_cur = m_end = nullptr;
+    m_last_block = nullptr;
+    m_next_block_size = kMinBlockSize;
+    m_bytes_allocated = 0;
+}
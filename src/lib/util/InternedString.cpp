@@ -0,0 +1,90 @@
+#include "util/InternedString.hpp"
+
+#include <cstring>
+#include <deque>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kEmptySlot = UINT32_MAX;
+
+// Open addressing with linear probing over the IDs, kept at most half full.
+// The deque never moves its strings, so str() references stay valid.
+class StringTable {
+  private:
+    std::deque<std::string> m_strings;
+    std::vector<uint32_t> m_hashes;
+    std::vector<uint32_t> m_slots;
+
+    // FNV-1a
+    static uint32_t hash(const char *p_text, const size_t p_length) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < p_length; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(p_text[i])) * 16777619u;
+        }
+        return hash;
+    }
+
+    void grow() {
+        m_slots.assign(m_slots.size() * 2, kEmptySlot);
+        const size_t mask = m_slots.size() - 1;
+        for (uint32_t id = 0; id < m_strings.size(); ++id) {
+            size_t slot = m_hashes[id] & mask;
+            while (m_slots[slot] != kEmptySlot) {
+                slot = (slot + 1) & mask;
+            }
+            m_slots[slot] = id;
+        }
+    }
+
+  public:
+    StringTable() : m_slots(256, kEmptySlot) { intern("", 0); }
+
+    uint32_t intern(const char *p_text, const size_t p_length) {
+        const uint32_t text_hash = hash(p_text, p_length);
+        const size_t mask = m_slots.size() - 1;
+        size_t slot = text_hash & mask;
+        for (; m_slots[slot] != kEmptySlot; slot = (slot + 1) & mask) {
+            const uint32_t id = m_slots[slot];
+            const std::string &string = m_strings[id];
+            if (m_hashes[id] == text_hash && string.size() == p_length &&
+                std::memcmp(string.data(), p_text, p_length) == 0) {
+                return id;
+            }
+        }
+
+        const uint32_t id = static_cast<uint32_t>(m_strings.size());
+        m_strings.emplace_back(p_text, p_length);
+        m_hashes.push_back(text_hash);
+        m_slots[slot] = id;
+        if (m_strings.size() * 2 > m_slots.size()) {
+            grow();
+        }
+        return id;
+    }
+
+    const std::string &get(const uint32_t p_id) const {
+        return m_strings[p_id];
+    }
+
+    size_t size() const { return m_strings.size(); }
+};
+
+// constructed on first use, since names may be interned during static
+// initialization
+StringTable &getTable() {
+    static StringTable table;
+    return table;
+}
+
+} // namespace
+
+InternedString::InternedString(const char *p_text, const size_t p_length)
+    : m_id(getTable().intern(p_text, p_length)) {}
+
+InternedString::InternedString(const char *p_text)
+    : InternedString(p_text, std::strlen(p_text)) {}
+
+const std::string &InternedString::str() const { return getTable().get(m_id); }
+
+size_t InternedString::getNumInterned() { return getTable().size(); }
@@ -0,0 +1,147 @@
+#include "util/SourceFile.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// the open files, by their base; bases only grow, so they stay in order. It
+// is never destroyed, as files may still be closed after it would be.
+static std::vector<const SourceFile *> &getOpenFiles() {
+    static auto *const files = new std::vector<const SourceFile *>();
+    return *files;
+}
+
+// the base of the next file opened
+static uint32_t next_base = 1;
+
+SourceFile::~SourceFile() {
+    if (m_data) {
+        munmap(m_data, m_mapped_size);
+        auto &files = getOpenFiles();
+        files.erase(std::find(files.begin(), files.end(), this));
+    }
+}
+
+bool SourceFile::open(const char *p_path) {
+    const int fd = ::open(p_path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    auto fail = [fd](const int p_error) {
+        close(fd);
+        errno = p_error;
+        return false;
+    };
+
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        return fail(errno);
+    }
+    // pipes and terminals can't be mapped
+    if (!S_ISREG(status.st_mode)) {
+        return fail(ENODEV);
+    }
+
+    // Reserve room for the text and the NUL bytes, then map the file over
+    // the front of it. The bytes between the end of the file and the end of
+    // its last page read as zero, and so do the anonymous pages after it.
+    const size_t size = status.st_size;
+    if (size >= std::numeric_limits<uint32_t>::max() - next_base) {
+        return fail(EFBIG);
+    }
+    const size_t mapped_size = size + kPadding;
+    void *const base = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        return fail(errno);
+    }
+    if (size != 0 && mmap(base, size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        const int error = errno;
+        munmap(base, mapped_size);
+        return fail(error);
+    }
+    close(fd);
+
+    m_data = static_cast<char *>(base);
+    m_size = size;
+    m_mapped_size = mapped_size;
+    m_base = next_base;
+    next_base += size + 1;
+    getOpenFiles().push_back(this);
+    return true;
+}
+
+void SourceFile::buildLineIndex() const {
+    // open() keeps files within the 32-bit location space
+    m_line_begins.push_back(0);
+    const char *const end = m_data + m_size;
+    for (const char *newline = m_data;
+         (newline = static_cast<const char *>(
+              std::memchr(newline, '\n', end - newline)));) {
+        ++newline;
+        m_line_begins.push_back(static_cast<uint32_t>(newline - m_data));
+    }
+}
+
+uint32_t SourceFile::getNumLines() const {
+    if (m_line_begins.empty()) {
+        buildLineIndex();
+    }
+    return m_line_begins.size();
+}
+
+const char *SourceFile::getLine(const uint32_t p_line, size_t &p_length) const {
+    const uint32_t num_lines = getNumLines();
+    if (p_line == 0 || p_line > num_lines) {
+        p_length = 0;
+        return m_data + m_size;
+    }
+
+    const size_t begin = m_line_begins[p_line - 1];
+    // the last line may lack a newline
+    const size_t end = p_line < num_lines ? m_line_begins[p_line] - 1 : m_size;
+    p_length = end - begin;
+    return m_data + begin;
+}
+
+void SourceFile::getLineAndColumn(const size_t p_offset, uint32_t &p_line,
+                                  uint32_t &p_col) const {
+    getNumLines();
+
+    const uint32_t index =
+        std::upper_bound(m_line_begins.begin(), m_line_begins.end(),
+                         static_cast<uint32_t>(p_offset)) -
+        m_line_begins.begin() - 1;
+    p_line = index + 1;
+    p_col = p_offset - m_line_begins[index] + 1;
+}
+
+const SourceFile *SourceFile::getFileOf(const Location p_location) {
+    const auto &files = getOpenFiles();
+    const auto it = std::upper_bound(
+        files.begin(), files.end(), p_location.getOffset(),
+        [](const uint32_t p_offset, const SourceFile *const p_file) {
+            return p_offset < p_file->m_base;
+        });
+    if (it == files.begin()) {
+        return nullptr;
+    }
+    const SourceFile *const file = *(it - 1);
+    return p_location.getOffset() - file->m_base <= file->m_size ? file
+                                                                 : nullptr;
+}
+
+Location::LineAndColumn Location::decode() const {
+    LineAndColumn result{0, 0};
+    if (const SourceFile *const file = SourceFile::getFileOf(*this)) {
+        file->getLineAndColumn(file->getOffsetOf(*this), result.line,
+                               result.col);
+    }
+    return result;
+}
@@ -0,0 +1,144 @@
+#include "visitor/TraversalBenchmark.hpp"
+#include "visitor/AstNodeInclude.hpp"
+#include "visitor/AstNodeVisitor.hpp"
+#include "visitor/AstWalker.hpp"
+#include "visitor/StaticAstVisitor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+
+// enough visits for the clock to be well above its resolution
+constexpr uint64_t kMinVisits = 50000000;
+// deeper trees would overflow the native stack of the recursive walks
+constexpr uint64_t kMaxRecursiveDepth = 10000;
+
+class VirtualCounter final : public AstNodeVisitor {
+  private:
+    uint64_t m_num_nodes = 0;
+
+    template <typename Node> void count(Node &p_node) {
+        ++m_num_nodes;
+        p_node.visitChildNodes(*this);
+    }
+
+  public:
+    uint64_t getNumNodes() const { return m_num_nodes; }
+
+    void visit(ProgramNode &p_program) override { count(p_program); }
+    void visit(DeclNode &p_decl) override { count(p_decl); }
+    void visit(VariableNode &p_variable) override { count(p_variable); }
+    void visit(ConstantValueNode &p_constant_value) override {
+        count(p_constant_value);
+    }
+    void visit(FunctionNode &p_function) override { count(p_function); }
+    void visit(CompoundStatementNode &p_compound_statement) override {
+        count(p_compound_statement);
+    }
+    void visit(PrintNode &p_print) override { count(p_print); }
+    void visit(BinaryOperatorNode &p_bin_op) override { count(p_bin_op); }
+    void visit(UnaryOperatorNode &p_un_op) override { count(p_un_op); }
+    void visit(FunctionInvocationNode &p_func_invocation) override {
+        count(p_func_invocation);
+    }
+    void visit(VariableReferenceNode &p_variable_ref) override {
+        count(p_variable_ref);
+    }
+    void visit(AssignmentNode &p_assignment) override { count(p_assignment); }
+    void visit(ReadNode &p_read) override { count(p_read); }
+    void visit(IfNode &p_if) override { count(p_if); }
+    void visit(WhileNode &p_while) override { count(p_while); }
+    void visit(ForNode &p_for) override { count(p_for); }
+    void visit(ReturnNode &p_return) override { count(p_return); }
+};
+
+class StaticCounter final : public StaticAstVisitor<StaticCounter> {
+  private:
+    uint64_t m_num_nodes = 0;
+
+  public:
+    uint64_t getNumNodes() const { return m_num_nodes; }
+
+    template <typename Node> void visit(Node &p_node) {
+        ++m_num_nodes;
+        dispatchChildNodes(p_node);
+    }
+};
+
+class WalkerCounter final : public AstWalker<WalkerCounter> {
+    friend class AstWalker<WalkerCounter>;
+
+  private:
+    uint64_t m_num_nodes = 0;
+    uint64_t m_depth = 0;
+    uint64_t m_max_depth = 0;
+
+    template <typename Node> bool enter(Node &) {
+        ++m_num_nodes;
+        m_max_depth = std::max(m_max_depth, ++m_depth);
+        return true;
+    }
+    template <typename Node> void leave(Node &) { --m_depth; }
+
+  public:
+    uint64_t getNumNodes() const { return m_num_nodes; }
+    uint64_t getMaxDepth() const { return m_max_depth; }
+};
+
+template <typename Walk> double timeWalks(const uint64_t p_rounds, Walk p_walk) {
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t round = 0; round < p_rounds; ++round) {
+        p_walk();
+    }
+    const std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+} // namespace
+
+void benchmarkTraversal(AstNode &p_root) {
+    WalkerCounter walker_counter;
+    walker_counter.walk(p_root);
+    const uint64_t num_nodes = walker_counter.getNumNodes();
+    const uint64_t max_depth = walker_counter.getMaxDepth();
+    const uint64_t rounds = std::max<uint64_t>(1, kMinVisits / num_nodes);
+    const double visits = static_cast<double>(rounds * num_nodes);
+
+    std::printf("%llu nodes, %llu deep, %llu walks\n",
+                static_cast<unsigned long long>(num_nodes),
+                static_cast<unsigned long long>(max_depth),
+                static_cast<unsigned long long>(rounds));
+
+    if (max_depth <= kMaxRecursiveDepth) {
+        VirtualCounter virtual_counter;
+        const double virtual_ns =
+            timeWalks(rounds, [&] { p_root.accept(virtual_counter); });
+        StaticCounter static_counter;
+        const double static_ns =
+            timeWalks(rounds, [&] { static_counter.dispatch(p_root); });
+
+        if (virtual_counter.getNumNodes() != rounds * num_nodes ||
+            static_counter.getNumNodes() != rounds * num_nodes) {
+            std::fprintf(stderr, "The walks disagree on the number of nodes\n");
+            return;
+        }
+        std::printf("accept():         %.2f ns/node\n", virtual_ns / visits);
+        std::printf("StaticAstVisitor: %.2f ns/node\n", static_ns / visits);
+    } else {
+        std::printf("accept():         skipped, too deep to recurse\n");
+        std::printf("StaticAstVisitor: skipped, too deep to recurse\n");
+    }
+
+    const double walker_ns =
+        timeWalks(rounds, [&] { walker_counter.walk(p_root); });
+    // the first walk counted the nodes once more
+    if (walker_counter.getNumNodes() != (rounds + 1) * num_nodes) {
+        std::fprintf(stderr, "The walks disagree on the number of nodes\n");
+        return;
+    }
+    std::printf("AstWalker:        %.2f ns/node\n", walker_ns / visits);
+}
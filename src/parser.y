@@ -21,45 +21,110 @@
 
 #include "codegen/CodeGenerator.hpp"
 #include "sema/SemanticAnalyzer.hpp"
+#include "util/SourceFile.hpp"
+#include "visitor/TraversalBenchmark.hpp"
 
 #include "AST/constant.hpp"
 #include "AST/operator.hpp"
 
+#include "AST/AstContext.hpp"
 #include "AST/AstDumper.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
-
-#define YYLTYPE yyltype
-
-typedef struct YYLTYPE {
-    uint32_t first_line;
-    uint32_t first_column;
-    uint32_t last_line;
-    uint32_t last_column;
-} yyltype;
-
-extern int32_t line_num;    /* declared in scanner.l */
-extern char current_line[]; /* declared in scanner.l */
-extern uint32_t opt_dmp;    /* declared in scanner.l */
-extern FILE *yyin;          /* declared by lex */
-extern char *yytext;        /* declared by lex */
-
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/* a rule is where its first symbol begins, an empty one where the symbol
+   before it begins */
+#define YYLLOC_DEFAULT(Current, Rhs, N) \
+    ((Current) = YYRHSLOC(Rhs, (N) ? 1 : 0))
+
+extern int32_t line_num;          /* declared in scanner.l */
+extern uint32_t col_num;          /* declared in scanner.l */
+extern const char *current_line;  /* declared in scanner.l */
+extern uint32_t opt_dmp;          /* declared in scanner.l */
+extern bool opt_fast_lexer;       /* declared in scanner.l */
+extern char *yytext;              /* declared by lex */
+
+/* the locations in the AST point into it until it is closed at exit */
+SourceFile source_file;
+
+/* owns the AST, which is released as a whole instead of node by node */
+static AstContext ast_context;
 static AstNode *root;
 
+/* nodes, lists and types all go to ast_context */
+template <typename T, typename... Args> static T *make(Args &&...p_args) {
+    return ast_context.create<T>(std::forward<Args>(p_args)...);
+}
+
+extern void scanSourceFile(const SourceFile &p_source);
 extern "C" int yylex(void);
 static void yyerror(const char *msg);
 extern int yylex_destroy(void);
+
+/* Deep nesting only costs parser stack, which is on the heap; this bounds
+ * it. */
+#define YYMAXDEPTH (1 << 26)
+
+/* Bison only grows its stacks itself when YYLTYPE is a C struct, so they
+ * are grown here: the first time from the arrays in yyparse()'s frame, by
+ * doubling them, up to YYMAXDEPTH entries. */
+#define yyoverflow(...)                                                        \
+    do {                                                                       \
+        if (!growParserStacks(__VA_ARGS__)) {                                  \
+            goto yyexhaustedlab;                                               \
+        }                                                                      \
+    } while (0)
+template <typename State, typename Value, typename Size>
+static bool growParserStacks(const char *, State **p_states,
+                             const Size p_states_bytes, Value **p_values,
+                             const Size, Location **p_locations, const Size,
+                             Size *p_stack_size) {
+    static std::vector<State> states;
+    static std::vector<Value> values;
+    static std::vector<Location> locations;
+
+    if (*p_stack_size >= YYMAXDEPTH) {
+        return false;
+    }
+    const Size used = p_states_bytes / static_cast<Size>(sizeof(State));
+    const Size size = std::min<Size>(*p_stack_size * 2, YYMAXDEPTH);
+
+    // the stacks may be in the vectors already
+    std::vector<State> new_states(*p_states, *p_states + used);
+    std::vector<Value> new_values(*p_values, *p_values + used);
+    std::vector<Location> new_locations(*p_locations, *p_locations + used);
+    new_states.resize(size);
+    new_values.resize(size);
+    new_locations.resize(size);
+    states.swap(new_states);
+    values.swap(new_values);
+    locations.swap(new_locations);
+
+    *p_states = states.data();
+    *p_values = values.data();
+    *p_locations = locations.data();
+    *p_stack_size = size;
+    return true;
+}
 %}
 
 %code requires {
     #include "AST/utils.hpp"
     #include "AST/PType.hpp"
+    #include "util/Arena.hpp"
+    #include "util/InternedString.hpp"
+    #include "util/SourceLocation.hpp"
 
-    #include <vector>
-    #include <memory>
+    /* a token is where it begins in the source */
+    #define YYLTYPE Location
 
     class AstNode;
     class DeclNode;
@@ -72,7 +137,7 @@ extern int yylex_destroy(void);
     /* For yylval */
 %union {
     /* basic semantic value */
-    char *identifier;
+    InternedString::Id identifier;
     uint32_t integer;
     double real;
     char *string;
@@ -81,19 +146,20 @@ extern int yylex_destroy(void);
     int32_t sign;
 
     AstNode *node;
-    PType *type_ptr;
+    const PType *type_ptr;
     DeclNode *decl_ptr;
     CompoundStatementNode *compound_stmt_ptr;
     ConstantValueNode *constant_value_node_ptr;
     FunctionNode *func_ptr;
     ExpressionNode *expr_ptr;
 
-    std::vector<std::unique_ptr<DeclNode>> *decls_ptr;
-    std::vector<IdInfo> *ids_ptr;
-    std::vector<uint64_t> *dimensions_ptr;
-    std::vector<std::unique_ptr<FunctionNode>> *funcs_ptr;
-    std::vector<std::unique_ptr<AstNode>> *nodes_ptr;
-    std::vector<std::unique_ptr<ExpressionNode>> *exprs_ptr;
+    /* in the arena as well; their elements are moved into the nodes */
+    ArenaVector<DeclNode *> *decls_ptr;
+    ArenaVector<IdInfo> *ids_ptr;
+    ArenaVector<uint64_t> *dimensions_ptr;
+    ArenaVector<FunctionNode *> *funcs_ptr;
+    ArenaVector<AstNode *> *nodes_ptr;
+    ArenaVector<ExpressionNode *> *exprs_ptr;
 };
 
 %type <identifier> ProgramName ID FunctionName
@@ -159,13 +225,10 @@ Program:
     DeclarationList FunctionList CompoundStatement
     /* End of ProgramBody */
     END {
-        root = new ProgramNode(@1.first_line, @1.first_column,
-                               $1, new PType(PType::PrimitiveTypeEnum::kVoidType),
-                               *$3, *$4, $5);
-
-        free($1);
-        delete $3;
-        delete $4;
+        root = make<ProgramNode>(
+            @1, InternedString::fromId($1),
+            ast_context.getType(PType::PrimitiveTypeEnum::kVoidType),
+            *$3, *$4, $5);
     }
 ;
 
@@ -175,7 +238,7 @@ ProgramName:
 
 DeclarationList:
     Epsilon {
-        $$ = new std::vector<std::unique_ptr<DeclNode>>();
+        $$ = ast_context.createVector<DeclNode *>();
     }
     |
     Declarations
@@ -183,7 +246,7 @@ DeclarationList:
 
 Declarations:
     Declaration {
-        $$ = new std::vector<std::unique_ptr<DeclNode>>();
+        $$ = ast_context.createVector<DeclNode *>();
         $$->emplace_back($1);
     }
     |
@@ -195,7 +258,7 @@ Declarations:
 
 FunctionList:
     Epsilon {
-        $$ = new std::vector<std::unique_ptr<FunctionNode>>();
+        $$ = ast_context.createVector<FunctionNode *>();
     }
     |
     Functions
@@ -203,7 +266,7 @@ FunctionList:
 
 Functions:
     Function {
-        $$ = new std::vector<std::unique_ptr<FunctionNode>>();
+        $$ = ast_context.createVector<FunctionNode *>();
         $$->emplace_back($1);
     }
     |
@@ -221,9 +284,8 @@ Function:
 
 FunctionDeclaration:
     FunctionName L_PARENTHESIS FormalArgList R_PARENTHESIS ReturnType SEMICOLON {
-        $$ = new FunctionNode(@1.first_line, @1.first_column, $1, *$3, $5, nullptr);
-        free($1);
-        delete $3;
+        $$ = make<FunctionNode>(ast_context.getArena(), @1,
+                                InternedString::fromId($1), *$3, $5, nullptr);
     }
 ;
 
@@ -231,9 +293,8 @@ FunctionDefinition:
     FunctionName L_PARENTHESIS FormalArgList R_PARENTHESIS ReturnType
     CompoundStatement
     END {
-        $$ = new FunctionNode(@1.first_line, @1.first_column, $1, *$3, $5, $6);
-        free($1);
-        delete $3;
+        $$ = make<FunctionNode>(ast_context.getArena(), @1,
+                                InternedString::fromId($1), *$3, $5, $6);
     }
 ;
 
@@ -243,7 +304,7 @@ FunctionName:
 
 FormalArgList:
     Epsilon {
-        $$ = new std::vector<std::unique_ptr<DeclNode>>();
+        $$ = ast_context.createVector<DeclNode *>();
     }
     |
     FormalArgs
@@ -251,7 +312,7 @@ FormalArgList:
 
 FormalArgs:
     FormalArg {
-        $$ = new std::vector<std::unique_ptr<DeclNode>>();
+        $$ = ast_context.createVector<DeclNode *>();
         $$->emplace_back($1);
     }
     |
@@ -263,21 +324,18 @@ FormalArgs:
 
 FormalArg:
     IdList COLON Type {
-        $$ = new DeclNode(@1.first_line, @1.first_column, $1, $3);
-        delete $1;
+        $$ = make<DeclNode>(ast_context.getArena(), @1, $1, $3);
     }
 ;
 
 IdList:
     ID {
-        $$ = new std::vector<IdInfo>();
-        $$->emplace_back(@1.first_line, @1.first_column, $1);
-        free($1);
+        $$ = ast_context.createVector<IdInfo>();
+        $$->emplace_back(@1, InternedString::fromId($1));
     }
     |
     IdList COMMA ID {
-        $1->emplace_back(@3.first_line, @3.first_column, $3);
-        free($3);
+        $1->emplace_back(@3, InternedString::fromId($3));
         $$ = $1;
     }
 ;
@@ -288,7 +346,7 @@ ReturnType:
     }
     |
     Epsilon {
-        $$ = new PType(PType::PrimitiveTypeEnum::kVoidType);
+        $$ = ast_context.getType(PType::PrimitiveTypeEnum::kVoidType);
     }
 ;
 
@@ -298,13 +356,11 @@ ReturnType:
 
 Declaration:
     VAR IdList COLON Type SEMICOLON {
-        $$ = new DeclNode(@1.first_line, @1.first_column, $2, $4);
-        delete $2;
+        $$ = make<DeclNode>(ast_context.getArena(), @1, $2, $4);
     }
     |
     VAR IdList COLON LiteralConstant SEMICOLON {
-        $$ = new DeclNode(@1.first_line, @1.first_column, $2, $4);
-        delete $2;
+        $$ = make<DeclNode>(ast_context.getArena(), @1, $2, $4);
     }
 ;
 
@@ -314,28 +370,26 @@ Type:
     ArrType
 ;
 
-    /* no need to release PType object since it'll be assigned to the shared_ptr */
 ScalarType:
-    INTEGER { $$ = new PType(PType::PrimitiveTypeEnum::kIntegerType); }
+    INTEGER { $$ = ast_context.getType(PType::PrimitiveTypeEnum::kIntegerType); }
     |
-    REAL { $$ = new PType(PType::PrimitiveTypeEnum::kRealType); }
+    REAL { $$ = ast_context.getType(PType::PrimitiveTypeEnum::kRealType); }
     |
-    STRING { $$ = new PType(PType::PrimitiveTypeEnum::kStringType); }
+    STRING { $$ = ast_context.getType(PType::PrimitiveTypeEnum::kStringType); }
     |
-    BOOLEAN { $$ = new PType(PType::PrimitiveTypeEnum::kBoolType); }
+    BOOLEAN { $$ = ast_context.getType(PType::PrimitiveTypeEnum::kBoolType); }
 ;
 
 ArrType:
     ArrDecl ScalarType {
-        $2->setDimensions(*$1);
-        delete $1;
-        $$ = $2;
+        $$ = ast_context.getArrayType($2->getPrimitiveType(), *$1);
     }
 ;
 
 ArrDecl:
     ARRAY INT_LITERAL OF {
-        $$ = new std::vector<uint64_t>{static_cast<uint64_t>($2)};
+        $$ = ast_context.createVector<uint64_t>();
+        $$->emplace_back(static_cast<uint64_t>($2));
     }
     |
     ArrDecl ARRAY INT_LITERAL OF {
@@ -348,25 +402,23 @@ LiteralConstant:
     NegOrNot INT_LITERAL {
         Constant::ConstantValue value;
         value.integer = static_cast<int64_t>($1) * static_cast<int64_t>($2);
-        auto * const constant = new Constant(
-            std::make_shared<PType>(
-				PType::PrimitiveTypeEnum::kIntegerType),
+        auto * const constant = make<Constant>(
+            ast_context.getArena(),
+            ast_context.getType(PType::PrimitiveTypeEnum::kIntegerType),
             value);
         auto * const pos = ($1 == 1) ? &@2 : &@1;
-        // no need to release constant object since it'll be assigned to the unique_ptr
-        $$ = new ConstantValueNode(pos->first_line, pos->first_column, constant);
+        $$ = make<ConstantValueNode>(*pos, constant);
     }
     |
     NegOrNot REAL_LITERAL {
         Constant::ConstantValue value;
         value.real = static_cast<double>($1) * static_cast<double>($2);
-        auto * const constant = new Constant(
-            std::make_shared<PType>(
-                PType::PrimitiveTypeEnum::kRealType),
+        auto * const constant = make<Constant>(
+            ast_context.getArena(),
+            ast_context.getType(PType::PrimitiveTypeEnum::kRealType),
             value);
         auto * const pos = ($1 == 1) ? &@2 : &@1;
-        // no need to release constant object since it'll be assigned to the unique_ptr
-        $$ = new ConstantValueNode(pos->first_line, pos->first_column, constant);
+        $$ = make<ConstantValueNode>(*pos, constant);
     }
     |
     StringAndBoolean
@@ -385,32 +437,34 @@ NegOrNot:
 StringAndBoolean:
     STRING_LITERAL {
         Constant::ConstantValue value;
-        value.string = $1;
-        auto * const constant = new Constant(
-            std::make_shared<PType>(
-                PType::PrimitiveTypeEnum::kStringType),
+        // the lexers hand over a malloc()ed copy; keep it with the AST
+        value.string = ast_context.copyString($1, strlen($1));
+        free($1);
+        auto * const constant = make<Constant>(
+            ast_context.getArena(),
+            ast_context.getType(PType::PrimitiveTypeEnum::kStringType),
             value);
-        $$ = new ConstantValueNode(@1.first_line, @1.first_column, constant);
+        $$ = make<ConstantValueNode>(@1, constant);
     }
     |
     TRUE {
         Constant::ConstantValue value;
         value.boolean = $1;
-        auto * const constant = new Constant(
-            std::make_shared<PType>(
-                PType::PrimitiveTypeEnum::kBoolType),
+        auto * const constant = make<Constant>(
+            ast_context.getArena(),
+            ast_context.getType(PType::PrimitiveTypeEnum::kBoolType),
             value);
-        $$ = new ConstantValueNode(@1.first_line, @1.first_column, constant);
+        $$ = make<ConstantValueNode>(@1, constant);
     }
     |
     FALSE {
         Constant::ConstantValue value;
         value.boolean = $1;
-        auto * const constant = new Constant(
-            std::make_shared<PType>(
-                PType::PrimitiveTypeEnum::kBoolType),
+        auto * const constant = make<Constant>(
+            ast_context.getArena(),
+            ast_context.getType(PType::PrimitiveTypeEnum::kBoolType),
             value);
-        $$ = new ConstantValueNode(@1.first_line, @1.first_column, constant);
+        $$ = make<ConstantValueNode>(@1, constant);
     }
 ;
 
@@ -418,23 +472,21 @@ IntegerAndReal:
     INT_LITERAL {
         Constant::ConstantValue value;
         value.integer = static_cast<int64_t>($1);
-        auto * const constant = new Constant(
-            std::make_shared<PType>(
-				PType::PrimitiveTypeEnum::kIntegerType),
+        auto * const constant = make<Constant>(
+            ast_context.getArena(),
+            ast_context.getType(PType::PrimitiveTypeEnum::kIntegerType),
             value);
-        // no need to release constant object since it'll be assigned to the unique_ptr
-        $$ = new ConstantValueNode(@1.first_line, @1.first_column, constant);
+        $$ = make<ConstantValueNode>(@1, constant);
     }
     |
     REAL_LITERAL {
         Constant::ConstantValue value;
         value.real = static_cast<double>($1);
-        auto * const constant = new Constant(
-            std::make_shared<PType>(
-                PType::PrimitiveTypeEnum::kRealType),
+        auto * const constant = make<Constant>(
+            ast_context.getArena(),
+            ast_context.getType(PType::PrimitiveTypeEnum::kRealType),
             value);
-        // no need to release constant object since it'll be assigned to the unique_ptr
-        $$ = new ConstantValueNode(@1.first_line, @1.first_column, constant);
+        $$ = make<ConstantValueNode>(@1, constant);
     }
 ;
 
@@ -465,40 +517,34 @@ CompoundStatement:
     DeclarationList
     StatementList
     END {
-        $$ = new CompoundStatementNode(@1.first_line, @1.first_column,
-                                       *$2, *$3);
-        delete $2;
-        delete $3;
+        $$ = make<CompoundStatementNode>(@1, *$2, *$3);
     }
 ;
 
 Simple:
     VariableReference ASSIGN Expression SEMICOLON {
-        $$ = new AssignmentNode(@2.first_line, @2.first_column,
-                                dynamic_cast<VariableReferenceNode *>($1), $3);
+        $$ = make<AssignmentNode>(@2,
+                                  dynamic_cast<VariableReferenceNode *>($1), $3);
     }
     |
     PRINT Expression SEMICOLON {
-        $$ = new PrintNode(@1.first_line, @1.first_column, $2);
+        $$ = make<PrintNode>(@1, $2);
     }
     |
     READ VariableReference SEMICOLON {
-        $$ = new ReadNode(@1.first_line, @1.first_column,
-                          dynamic_cast<VariableReferenceNode *>($2));
+        $$ = make<ReadNode>(@1, dynamic_cast<VariableReferenceNode *>($2));
     }
 ;
 
 VariableReference:
     ID ArrRefList {
-        $$ = new VariableReferenceNode(@1.first_line, @1.first_column, $1, *$2);
-        free($1);
-        delete $2;
+        $$ = make<VariableReferenceNode>(@1, InternedString::fromId($1), *$2);
     }
 ;
 
 ArrRefList:
     Epsilon {
-        $$ = new std::vector<std::unique_ptr<ExpressionNode>>();
+        $$ = ast_context.createVector<ExpressionNode *>();
     }
     |
     ArrRefs
@@ -506,7 +552,7 @@ ArrRefList:
 
 ArrRefs:
     L_BRACKET Expression R_BRACKET {
-        $$ = new std::vector<std::unique_ptr<ExpressionNode>>();
+        $$ = ast_context.createVector<ExpressionNode *>();
         $$->emplace_back($2);
     }
     |
@@ -521,7 +567,7 @@ Condition:
     CompoundStatement
     ElseOrNot
     END IF {
-        $$ = new IfNode(@1.first_line, @1.first_column, $2, $4, $5);
+        $$ = make<IfNode>(@1, $2, $4, $5);
     }
 ;
 
@@ -540,7 +586,7 @@ While:
     WHILE Expression DO
     CompoundStatement
     END DO {
-        $$ = new WhileNode(@1.first_line, @1.first_column, $2, $4);
+        $$ = make<WhileNode>(@1, $2, $4);
     }
 ;
 
@@ -552,42 +598,41 @@ For:
         Constant *constant;
         ConstantValueNode *constant_value_node;
 
+        const InternedString loop_var = InternedString::fromId($2);
+
         // DeclNode
-        auto *ids = new std::vector<IdInfo>{IdInfo(@2.first_line, @2.first_column,
-                                                   $2)};
-        auto *type = new PType(PType::PrimitiveTypeEnum::kIntegerType);
-        auto *var_decl = new DeclNode(@2.first_line, @2.first_column, ids, type);
+        auto *ids = ast_context.createVector<IdInfo>();
+        ids->emplace_back(@2, loop_var);
+        auto *type = ast_context.getType(PType::PrimitiveTypeEnum::kIntegerType);
+        auto *var_decl = make<DeclNode>(ast_context.getArena(), @2, ids, type);
 
         // AssignmentNode
-        auto *var_ref = new VariableReferenceNode(@2.first_line, @2.first_column, $2);
+        auto *var_ref =
+            make<VariableReferenceNode>(ast_context.getArena(), @2, loop_var);
         value.integer = static_cast<int64_t>($4);
-        constant = new Constant(
-            std::make_shared<PType>(PType::PrimitiveTypeEnum::kIntegerType),
+        constant = make<Constant>(
+            ast_context.getArena(),
+            ast_context.getType(PType::PrimitiveTypeEnum::kIntegerType),
             value);
-        constant_value_node = new ConstantValueNode(@4.first_line, @4.first_column,
-                                                    constant);
-        auto *assignment = new AssignmentNode(@3.first_line, @3.first_column,
-                                              var_ref, constant_value_node);
+        constant_value_node = make<ConstantValueNode>(@4, constant);
+        auto *assignment =
+            make<AssignmentNode>(@3, var_ref, constant_value_node);
 
         // ExpressionNode
         value.integer = static_cast<int64_t>($6);
-        constant = new Constant(
-            std::make_shared<PType>(PType::PrimitiveTypeEnum::kIntegerType),
+        constant = make<Constant>(
+            ast_context.getArena(),
+            ast_context.getType(PType::PrimitiveTypeEnum::kIntegerType),
             value);
-        constant_value_node = new ConstantValueNode(@6.first_line, @6.first_column,
-                                                    constant);
+        constant_value_node = make<ConstantValueNode>(@6, constant);
 
-        $$ = new ForNode(@1.first_line, @1.first_column,
-                         var_decl, assignment, constant_value_node,
-                         $8);
-        free($2);
-        delete ids;
+        $$ = make<ForNode>(@1, var_decl, assignment, constant_value_node, $8);
     }
 ;
 
 Return:
     RETURN Expression SEMICOLON {
-        $$ = new ReturnNode(@1.first_line, @1.first_column, $2);
+        $$ = make<ReturnNode>(@1, $2);
     }
 ;
 
@@ -599,15 +644,13 @@ FunctionCall:
 
 FunctionInvocation:
     ID L_PARENTHESIS ExpressionList R_PARENTHESIS {
-        $$ = new FunctionInvocationNode(@1.first_line, @1.first_column, $1, *$3);
-        free($1);
-        delete $3;
+        $$ = make<FunctionInvocationNode>(@1, InternedString::fromId($1), *$3);
     }
 ;
 
 ExpressionList:
     Epsilon {
-        $$ = new std::vector<std::unique_ptr<ExpressionNode>>();
+        $$ = ast_context.createVector<ExpressionNode *>();
     }
     |
     Expressions
@@ -615,7 +658,7 @@ ExpressionList:
 
 Expressions:
     Expression {
-        $$ = new std::vector<std::unique_ptr<ExpressionNode>>();
+        $$ = ast_context.createVector<ExpressionNode *>();
         $$->emplace_back($1);
     }
     |
@@ -627,7 +670,7 @@ Expressions:
 
 StatementList:
     Epsilon {
-        $$ = new std::vector<std::unique_ptr<AstNode>>();
+        $$ = ast_context.createVector<AstNode *>();
     }
     |
     Statements
@@ -635,7 +678,7 @@ StatementList:
 
 Statements:
     Statement {
-        $$ = new std::vector<std::unique_ptr<AstNode>>();
+        $$ = ast_context.createVector<AstNode *>();
         $$->emplace_back($1);
     }
     |
@@ -651,78 +694,63 @@ Expression:
     }
     |
     MINUS Expression %prec UNARY_MINUS {
-        $$ = new UnaryOperatorNode(@1.first_line, @1.first_column,
-                                   Operator::kNegOp, $2);
+        $$ = make<UnaryOperatorNode>(@1, Operator::kNegOp, $2);
     }
     |
     Expression MULTIPLY Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kMultiplyOp, $1, $3);
+        $$ = make<BinaryOperatorNode>(@2, Operator::kMultiplyOp, $1, $3);
     }
     |
     Expression DIVIDE Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kDivideOp, $1, $3);
+        $$ = make<BinaryOperatorNode>(@2, Operator::kDivideOp, $1, $3);
     }
     |
     Expression MOD Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kModOp, $1, $3);
+        $$ = make<BinaryOperatorNode>(@2, Operator::kModOp, $1, $3);
     }
     |
     Expression PLUS Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kPlusOp, $1, $3);
+        $$ = make<BinaryOperatorNode>(@2, Operator::kPlusOp, $1, $3);
     }
     |
     Expression MINUS Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kMinusOp, $1, $3);
+        $$ = make<BinaryOperatorNode>(@2, Operator::kMinusOp, $1, $3);
     }
     |
     Expression LESS Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kLessOp, $1, $3);
+        $$ = make<BinaryOperatorNode>(@2, Operator::kLessOp, $1, $3);
     }
     |
     Expression LESS_OR_EQUAL Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kLessOrEqualOp, $1, $3);
+        $$ = make<BinaryOperatorNode>(@2, Operator::kLessOrEqualOp, $1, $3);
     }
     |
     Expression GREATER Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kGreaterOp, $1, $3);
+        $$ = make<BinaryOperatorNode>(@2, Operator::kGreaterOp, $1, $3);
     }
     |
     Expression GREATER_OR_EQUAL Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kGreaterOrEqualOp, $1, $3);
+        $$ = make<BinaryOperatorNode>(@2, Operator::kGreaterOrEqualOp, $1, $3);
     }
     |
     Expression EQUAL Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kEqualOp, $1, $3);
+        $$ = make<BinaryOperatorNode>(@2, Operator::kEqualOp, $1, $3);
     }
     |
     Expression NOT_EQUAL Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kNotEqualOp, $1, $3);
+        $$ = make<BinaryOperatorNode>(@2, Operator::kNotEqualOp, $1, $3);
     }
     |
     NOT Expression {
-        $$ = new UnaryOperatorNode(@1.first_line, @1.first_column,
-                                   Operator::kNotOp, $2);
+        $$ = make<UnaryOperatorNode>(@1, Operator::kNotOp, $2);
     }
     |
     Expression AND Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kAndOp, $1, $3);
+        $$ = make<BinaryOperatorNode>(@2, Operator::kAndOp, $1, $3);
     }
     |
     Expression OR Expression {
-        $$ = new BinaryOperatorNode(@2.first_line, @2.first_column,
-                                    Operator::kOrOp, $1, $3);
+        $$ = make<BinaryOperatorNode>(@2, Operator::kOrOp, $1, $3);
     }
     |
     IntegerAndReal
@@ -749,40 +777,175 @@ void yyerror(const char *msg) {
             "\n"
             "|-----------------------------------------------------------------"
             "---------\n"
-            "| Error found in Line #%d: %s\n"
+            "| Error found in Line #%d: %.*s\n"
             "|\n"
             "| Unmatched token: %s\n"
             "|-----------------------------------------------------------------"
             "---------\n",
-            line_num, current_line, yytext);
+            line_num, static_cast<int>(col_num - 1), current_line, yytext);
     exit(-1);
 }
 
+struct ScannedToken {
+    int token;
+    Location location;
+    std::string value;
+
+    bool operator==(const ScannedToken &p_other) const {
+        return token == p_other.token && location == p_other.location &&
+               value == p_other.value;
+    }
+};
+
+// Scans the whole source with the lexer that opt_fast_lexer picks. Its
+// listing goes to `p_listing` instead of stdout.
+static std::vector<ScannedToken> scanAll(std::string &p_listing) {
+    scanSourceFile(source_file);
+
+    fflush(stdout);
+    FILE *listing = tmpfile();
+    const int saved_stdout = dup(STDOUT_FILENO);
+    dup2(fileno(listing), STDOUT_FILENO);
+
+    std::vector<ScannedToken> tokens;
+    for (int token; (token = yylex()) != 0;) {
+        std::string value;
+        switch (token) {
+        case ID:
+            value = InternedString::fromId(yylval.identifier).str();
+            break;
+        case STRING_LITERAL:
+            value = yylval.string;
+            free(yylval.string);
+            break;
+        case INT_LITERAL:
+            value = std::to_string(yylval.integer);
+            break;
+        case REAL_LITERAL: {
+            char real[32];
+            snprintf(real, sizeof(real), "%a", yylval.real);
+            value = real;
+            break;
+        }
+        case TRUE:
+        case FALSE:
+            value = yylval.boolean ? "true" : "false";
+            break;
+        }
+        tokens.push_back({token, yylloc, value});
+    }
+
+    fflush(stdout);
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+    rewind(listing);
+    char buffer[4096];
+    for (size_t size; (size = fread(buffer, 1, sizeof(buffer), listing)) != 0;) {
+        p_listing.append(buffer, size);
+    }
+    fclose(listing);
+    return tokens;
+}
+
+// Scans the source with flex and with the hand-written lexer; returns false
+// after reporting the first token they disagree on.
+static bool verifyLexers() {
+    std::string listings[2];
+    opt_fast_lexer = false;
+    const auto expected = scanAll(listings[0]);
+    opt_fast_lexer = true;
+    const auto actual = scanAll(listings[1]);
+
+    const size_t num_tokens = std::min(expected.size(), actual.size());
+    const auto mismatch =
+        std::mismatch(expected.begin(), expected.begin() + num_tokens,
+                      actual.begin());
+    if (mismatch.first != expected.begin() + num_tokens) {
+        const auto expected_location = mismatch.first->location.decode();
+        const auto actual_location = mismatch.second->location.decode();
+        fprintf(stderr,
+                "Lexers disagree on token #%zu: flex scans %d \"%s\" at "
+                "%u:%u, the hand-written lexer %d \"%s\" at %u:%u\n",
+                static_cast<size_t>(mismatch.first - expected.begin()),
+                mismatch.first->token, mismatch.first->value.c_str(),
+                expected_location.line, expected_location.col,
+                mismatch.second->token, mismatch.second->value.c_str(),
+                actual_location.line, actual_location.col);
+        return false;
+    }
+    if (expected.size() != actual.size()) {
+        fprintf(stderr, "Lexers disagree on the number of tokens: %zu, %zu\n",
+                expected.size(), actual.size());
+        return false;
+    }
+    if (listings[0] != listings[1]) {
+        fprintf(stderr, "Lexers disagree on the listing\n");
+        return false;
+    }
+    printf("Lexers agree on %zu tokens\n", expected.size());
+    return true;
+}
+
 int main(int argc, const char *argv[]) {
     if (argc < 2) {
-        fprintf(stderr, "Usage: %s <filename> --save-path [save path]\n", argv[0]);
+        fprintf(stderr, "Usage: %s <filename> --save-path [save path] [options]\n", argv[0]);
         exit(-1);
     }
 
-    yyin = fopen(argv[1], "r");
-    if (yyin == NULL) {
-        perror("fopen() failed");
+    const char *save_path = "";
+    bool opt_dump_ast = false;
+    bool opt_verify_lexer = false;
+    bool opt_bench_traversal = false;
+    CodeGenOptions codegen_options;
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--dump-ast") == 0) {
+            opt_dump_ast = true;
+        } else if (strcmp(argv[i], "--lexer=flex") == 0) {
+            opt_fast_lexer = false;
+        } else if (strcmp(argv[i], "--lexer=fast") == 0) {
+            opt_fast_lexer = true;
+        } else if (strcmp(argv[i], "--verify-lexer") == 0) {
+            opt_verify_lexer = true;
+        } else if (strcmp(argv[i], "--bench-traversal") == 0) {
+            opt_bench_traversal = true;
+        } else if ((strcmp(argv[i], "--save-path") == 0 ||
+                    strcmp(argv[i], "--save_path") == 0) && i + 1 < argc) {
+            save_path = argv[++i];
+        } else if (!codegen_options.parse(argv[i])) {
+            fprintf(stderr, "Invalid option: %s\n", argv[i]);
+            exit(-1);
+        }
+    }
+    codegen_options.finalize();
+
+    if (!source_file.open(argv[1])) {
+        perror("open() failed");
         exit(-1);
     }
+    if (opt_verify_lexer) {
+        return verifyLexers() ? 0 : 1;
+    }
+    scanSourceFile(source_file);
 
     yyparse();
 
-    if (argc >= 3 && strcmp(argv[2], "--dump-ast") == 0) {
+    if (opt_bench_traversal) {
+        benchmarkTraversal(*root);
+        return 0;
+    }
+
+    if (opt_dump_ast) {
         AstDumper ast_dumper;
-        root->accept(ast_dumper);
+        ast_dumper.walk(*root);
     }
 
-    SemanticAnalyzer sema_analyzer(opt_dmp);
-    root->accept(sema_analyzer);
+    SemanticAnalyzer sema_analyzer(opt_dmp, ast_context);
+    sema_analyzer.walk(*root);
 
-    CodeGenerator code_generator(argv[1], (argc == 4) ? argv[3] : "",
-                                 sema_analyzer.getSymbolManager());
-    root->accept(code_generator);
+    CodeGenerator code_generator(argv[1], save_path,
+                                 sema_analyzer.getSymbolManager(),
+                                 codegen_options);
+    code_generator.walk(*root);
 
     if (!sema_analyzer.hasError()) {
         printf("\n"
@@ -791,8 +954,7 @@ int main(int argc, const char *argv[]) {
                "|---------------------------------------------------|\n");
     }
 
-    delete root;
-    fclose(yyin);
+    ast_context.release();
     yylex_destroy();
     return 0;
 }
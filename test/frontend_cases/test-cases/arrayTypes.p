@@ -0,0 +1,68 @@
+//&S-
+//&T-
+//&D-
+// array types of every shape, and where integer and real mix
+arrayTypes;
+
+var vec: array 4 of integer;
+var grid: array 2 of array 3 of integer;
+var cube: array 2 of array 3 of array 4 of real;
+var flags: array 5 of boolean;
+
+sum(v: array 4 of integer): integer
+begin
+	return v[0] + v[3];
+end
+end
+
+area(g: array 2 of array 3 of integer): real
+begin
+	return g[1][2] * 1.5;
+end
+end
+
+begin
+
+var i: integer;
+var r: real;
+
+// integer and real mix freely
+r := vec[1];
+r := cube[1][2][3] + vec[0];
+i := sum(vec);
+r := area(grid);
+i := r;
+if r > i then
+begin
+	print r;
+end
+end if
+
+// a row of grid has the shape of neither vec nor grid
+i := sum(grid[1]);
+r := area(cube[0]);
+i := sum(grid);
+
+// the remaining dimensions of a partly indexed array
+i := grid[0] + 1;
+r := cube[1] * 2.0;
+r := cube[1][2] - r;
+print grid[1];
+read cube[0][1];
+
+// too many indices, and indices that are not integers
+i := vec[1][2];
+i := grid[1.5][0];
+i := vec[r];
+
+// mod takes integers only, and boolean mixes with neither
+i := vec[0] mod r;
+flags[0] := vec[2];
+r := flags[1];
+
+// arrays cannot be assigned or returned
+vec := vec;
+i := -grid;
+
+end
+end
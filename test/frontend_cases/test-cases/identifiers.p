@@ -0,0 +1,38 @@
+//&S-
+//&T-
+// the same spellings in different scopes, and names that only differ
+// after the 32 characters an identifier keeps
+identifiers;
+
+var count: integer;
+var abcdefghijklmnopqrstuvwxyz012345first: integer;
+var abcdefghijklmnopqrstuvwxyz012345second: boolean;
+
+count(count: integer): integer
+begin
+	var total: integer;
+	total := count + 1;
+	return total;
+end
+end
+
+total(value: integer): integer
+begin
+	var count: boolean;
+	count := value > 0;
+	return value;
+end
+end
+
+begin
+
+var total: integer;
+total := count;
+begin
+	var count: boolean;
+	count := total;
+end
+abcdefghijklmnopqrstuvwxyz012345third := 1;
+print total;
+end
+end
@@ -0,0 +1,34 @@
+//&S-
+//&T+
+//&D-
+// tokens where the longest match or the rule order decides
+lexerEdges;
+
+var octal: 0123;
+var zero: 0;
+var small: 0.5;
+var exact: 1.0;
+var scaled: 1.5E-3;
+var big: 25e+2;
+var quoted: "say ""hi"" /* not a comment */ // nor this";
+var empty: "";
+
+/* a comment over
+   two lines, with * and / inside */
+main2(varx, ifthen, mod2: integer): boolean
+begin
+	return (varx <= ifthen) and (mod2 <> 0) or not (varx >= 1);
+end
+end
+
+begin
+
+var averyveryverylongidentifiernamethatkeepsgoingandgoing: integer;
+var a1b2c3: integer;
+averyveryverylongidentifiernamethatkeepsgoingandgoing := octal mod 7;
+a1b2c3 := zero-1*(2/3);
+//&X+ is only a comment
+print a1b2c3;//&S+ turns the listing on
+print averyveryverylongidentifiernamethatkeepsgoingandgoing;
+end
+end
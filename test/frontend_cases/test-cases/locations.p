@@ -0,0 +1,19 @@
+//&S-
+//&T-
+//&D-
+// tabs, several nodes and errors on one line, and a last line with no
+// newline after it
+locations;
+
+var a, b: integer; var flag: boolean;
+
+f(x: integer): integer begin return x + flag; end end
+
+begin
+	var c: integer;
+		c := a + flag; b := flag * 2; flag := a - -b;
+	if a then begin print c; end else begin print -flag; end end if
+	  	while c do begin c := c - 1; end end do
+c := f(flag) + f(a, b);
+end
+end
\ No newline at end of file
@@ -0,0 +1,263 @@
+//&T-
+//&S-
+//&D-
+// more lines than the old 200-entry line table, and lines longer than its
+// 512-byte buffers
+
+longLines;
+
+var gv: integer;
+
+begin
+
+var total: integer;
+var flag: boolean;
+total := 0;
+total := total + 0;
+total := total + 1;
+total := total + 2;
+total := total + 3;
+total := total + 4;
+total := total + 5;
+total := total + 6;
+total := total + 7;
+total := total + 8;
+total := total + 9;
+total := total + 10;
+total := total + 11;
+total := total + 12;
+total := total + 13;
+total := total + 14;
+total := total + 15;
+total := total + 16;
+total := total + 17;
+total := total + 18;
+total := total + 19;
+total := total + 20;
+total := total + 21;
+total := total + 22;
+total := total + 23;
+total := total + 24;
+total := total + 25;
+total := total + 26;
+total := total + 27;
+total := total + 28;
+total := total + 29;
+total := total + 30;
+total := total + 31;
+total := total + 32;
+total := total + 33;
+total := total + 34;
+total := total + 35;
+total := total + 36;
+total := total + 37;
+total := total + 38;
+total := total + 39;
+total := total + 40;
+total := total + 41;
+total := total + 42;
+total := total + 43;
+total := total + 44;
+total := total + 45;
+total := total + 46;
+total := total + 47;
+total := total + 48;
+total := total + 49;
+total := total + 50;
+total := total + 51;
+total := total + 52;
+total := total + 53;
+total := total + 54;
+total := total + 55;
+total := total + 56;
+total := total + 57;
+total := total + 58;
+total := total + 59;
+total := total + 60;
+total := total + 61;
+total := total + 62;
+total := total + 63;
+total := total + 64;
+total := total + 65;
+total := total + 66;
+total := total + 67;
+total := total + 68;
+total := total + 69;
+total := total + 70;
+total := total + 71;
+total := total + 72;
+total := total + 73;
+total := total + 74;
+total := total + 75;
+total := total + 76;
+total := total + 77;
+total := total + 78;
+total := total + 79;
+total := total + 80;
+total := total + 81;
+total := total + 82;
+total := total + 83;
+total := total + 84;
+total := total + 85;
+total := total + 86;
+total := total + 87;
+total := total + 88;
+total := total + 89;
+total := total + 90;
+total := total + 91;
+total := total + 92;
+total := total + 93;
+total := total + 94;
+total := total + 95;
+total := total + 96;
+total := total + 97;
+total := total + 98;
+total := total + 99;
+total := total + 100;
+total := total + 101;
+total := total + 102;
+total := total + 103;
+total := total + 104;
+total := total + 105;
+total := total + 106;
+total := total + 107;
+total := total + 108;
+total := total + 109;
+total := total + 110;
+total := total + 111;
+total := total + 112;
+total := total + 113;
+total := total + 114;
+total := total + 115;
+total := total + 116;
+total := total + 117;
+total := total + 118;
+total := total + 119;
+total := total + 120;
+total := total + 121;
+total := total + 122;
+total := total + 123;
+total := total + 124;
+total := total + 125;
+total := total + 126;
+total := total + 127;
+total := total + 128;
+total := total + 129;
+total := total + 130;
+total := total + 131;
+total := total + 132;
+total := total + 133;
+total := total + 134;
+total := total + 135;
+total := total + 136;
+total := total + 137;
+total := total + 138;
+total := total + 139;
+total := total + 140;
+total := total + 141;
+total := total + 142;
+total := total + 143;
+total := total + 144;
+total := total + 145;
+total := total + 146;
+total := total + 147;
+total := total + 148;
+total := total + 149;
+total := total + 150;
+total := total + 151;
+total := total + 152;
+total := total + 153;
+total := total + 154;
+total := total + 155;
+total := total + 156;
+total := total + 157;
+total := total + 158;
+total := total + 159;
+total := total + 160;
+total := total + 161;
+total := total + 162;
+total := total + 163;
+total := total + 164;
+total := total + 165;
+total := total + 166;
+total := total + 167;
+total := total + 168;
+total := total + 169;
+total := total + 170;
+total := total + 171;
+total := total + 172;
+total := total + 173;
+total := total + 174;
+total := total + 175;
+total := total + 176;
+total := total + 177;
+total := total + 178;
+total := total + 179;
+total := total + 180;
+total := total + 181;
+total := total + 182;
+total := total + 183;
+total := total + 184;
+total := total + 185;
+total := total + 186;
+total := total + 187;
+total := total + 188;
+total := total + 189;
+total := total + 190;
+total := total + 191;
+total := total + 192;
+total := total + 193;
+total := total + 194;
+total := total + 195;
+total := total + 196;
+total := total + 197;
+total := total + 198;
+total := total + 199;
+total := total + 200;
+total := total + 201;
+total := total + 202;
+total := total + 203;
+total := total + 204;
+total := total + 205;
+total := total + 206;
+total := total + 207;
+total := total + 208;
+total := total + 209;
+total := total + 210;
+total := total + 211;
+total := total + 212;
+total := total + 213;
+total := total + 214;
+total := total + 215;
+total := total + 216;
+total := total + 217;
+total := total + 218;
+total := total + 219;
+total := total + 220;
+total := total + 221;
+total := total + 222;
+total := total + 223;
+total := total + 224;
+total := total + 225;
+total := total + 226;
+total := total + 227;
+total := total + 228;
+total := total + 229;
+total := total + 230;
+total := total + 231;
+total := total + 232;
+total := total + 233;
+total := total + 234;
+total := total + 235;
+total := total + 236;
+total := total + 237;
+total := total + 238;
+total := total + 239;
+total := total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + total + flag;
+//&T+
+print "abcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghijabcdefghij";
+//&T-
+flag := total;
+
+end
+end
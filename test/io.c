@@ -27,3 +27,30 @@ void printString(char *value)
 {
     printf("%s\n", value);
 }
+
+// Called before main returns in programs compiled with -fprofile-generate.
+void __profile_write(const char *path, const int *counters, int num_sites)
+{
+    FILE *file = fopen(path, "w");
+    if (!file)
+    {
+        perror(path);
+        return;
+    }
+    fprintf(file, "pprof %d\n", num_sites);
+    for (int i = 0; i < num_sites; ++i)
+    {
+        fprintf(file, "%d %d\n", counters[2 * i], counters[2 * i + 1]);
+    }
+    fclose(file);
+}
+
+// Called before main returns in programs compiled with -fmemoize-stats.
+void __memo_report(const char *const *names, const int *counters, int num_functions)
+{
+    for (int i = 0; i < num_functions; ++i)
+    {
+        fprintf(stderr, "%s: %d hits, %d misses\n", names[i], counters[2 * i],
+                counters[2 * i + 1]);
+    }
+}
@@ -0,0 +1,56 @@
+//&S-
+//&T-
+//&D-
+
+compressed;
+
+var gv: integer;
+var gc: 7;
+
+// a6 ~ a7 hold arguments, and t0 ~ t3 are renamed to a2 ~ a5
+mix(a, b, c, d, e, f, g: integer): integer
+begin
+	var r: integer;
+	r := (a - b) * (c + d) - e / f + g mod gc;
+	return r;
+end
+end
+
+collatz(n: integer): integer
+begin
+	var steps: integer;
+	steps := 0;
+	while n <> 1 do
+	begin
+		if n mod 2 = 0 then
+		begin
+			n := n / 2;
+		end
+		else
+		begin
+			n := 3 * n + 1;
+		end
+		end if
+		steps := steps + 1;
+	end
+	end do
+	return steps;
+end
+end
+
+begin
+
+var i, sum: integer;
+read gv;
+print mix(gv, 3, 4, 5, 60, 7, gv);
+sum := 0;
+for i := 1 to 10 do
+begin
+	sum := sum + mix(i, gv, i, i, gv * i, i, i + gc);
+end
+end do
+print sum;
+print collatz(gv) + collatz(27);
+
+end
+end
@@ -0,0 +1,80 @@
+//&S-
+//&T-
+//&D-
+
+frameSlots;
+
+var gv: integer;
+
+// locals of sibling scopes share slots; y and z don't, as z is first used
+// after the last mention of y but inside the loop that still reads y
+weave(n: integer): integer
+begin
+	var y, t, i: integer;
+	y := n - 118;
+	t := 0;
+	for i := 0 to 4 do
+	begin
+		var z: integer;
+		t := t + y;
+		z := i * 100;
+		t := t + z;
+	end
+	end do
+	return t;
+end
+end
+
+fact(n: integer): integer
+begin
+	var r: integer;
+	if n <= 1 then
+	begin
+		return 1;
+	end
+	end if
+	r := n * fact(n - 1);
+	return r;
+end
+end
+
+begin
+
+var a, i: integer;
+read gv;
+a := gv mod 10;
+begin
+	var b: integer;
+	b := a * 2;
+	begin
+		var c: integer;
+		c := b * 10 + a;
+		print c;
+	end
+	print b;
+end
+begin
+	var d: integer;
+	d := 7;
+	begin
+		var e: integer;
+		e := d + a;
+		print e * d;
+	end
+end
+for i := 0 to 3 do
+begin
+	a := a + i;
+end
+end do
+for i := 2 to 6 do
+begin
+	a := a * 2 - i;
+end
+end do
+print a;
+print weave(gv);
+print fact(6) + a;
+
+end
+end
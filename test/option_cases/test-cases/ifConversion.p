@@ -0,0 +1,69 @@
+//&S-
+//&T-
+//&D-
+
+ifConversion;
+
+var gv: integer;
+
+begin
+
+var a, b, lo, hi, sel, i, acc: integer;
+
+read gv;
+a := gv - 100;
+b := 50;
+
+if a < b then
+begin
+	lo := a;
+end
+else
+begin
+	lo := b;
+end
+end if
+
+if a > b then
+begin
+	hi := a;
+end
+else
+begin
+	hi := b;
+end
+end if
+
+print lo;
+print hi;
+
+acc := 0;
+for i := 0 to 9 do
+begin
+	if i mod 3 = 0 then
+	begin
+		sel := i * 2;
+	end
+	else
+	begin
+		sel := 0 - i;
+	end
+	end if
+	acc := acc + sel;
+end
+end do
+print acc;
+
+if gv = 123 then
+begin
+	sel := 1;
+end
+else
+begin
+	sel := 2;
+end
+end if
+print sel;
+
+end
+end
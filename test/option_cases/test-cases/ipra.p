@@ -0,0 +1,46 @@
+//&S-
+//&T-
+//&D-
+
+ipra;
+
+var gv: integer;
+
+square(x: integer): integer
+begin
+	return x * x;
+end
+end
+
+sumSquares(a, b, c: integer): integer
+begin
+	var s: integer;
+	s := square(a);
+	s := s + square(b);
+	s := s + square(c);
+	return s;
+end
+end
+
+poly(x: integer): integer
+begin
+	return sumSquares(x, x + 1, x + 2) - square(x - 1) + x;
+end
+end
+
+begin
+
+var i, total: integer;
+
+read gv;
+total := 0;
+for i := 1 to 5 do
+begin
+	total := total + poly(i + gv - 123);
+end
+end do
+print total;
+print sumSquares(gv, poly(2), square(3));
+
+end
+end
@@ -0,0 +1,37 @@
+//&S-
+//&T-
+//&D-
+
+manyArgs;
+
+var gv: integer;
+
+weigh(a, b, c, d, e, f, g, h, i, j: integer): integer
+begin
+	return a * 1 + b * 2 + c * 3 + d * 4 + e * 5 + f * 6 + g * 7 + h * 8 + i * 9 + j * 10;
+end
+end
+
+// the ninth and later arguments are passed on the stack
+shift(a, b, c, d, e, f, g, h, i, j, k, l: integer): integer
+begin
+	if a <= 0 then
+	begin
+		return b + c + d + e + f + g + h + i + j * 10 + k * 100 + l * 1000;
+	end
+	end if
+	return shift(a - 1, c, d, e, f, g, h, i, j, k, l, b);
+end
+end
+
+begin
+
+read gv;
+gv := gv - 122;
+
+print weigh(gv, 2, 3, 4, 5, 6, 7, 8, 9, 10);
+print weigh(10, 9, 8, 7, 6, 5, 4, 3, 2, gv) + weigh(gv, gv, gv, gv, gv, gv, gv, gv, gv, gv);
+print shift(gv, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11);
+
+end
+end
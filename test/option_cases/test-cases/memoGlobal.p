@@ -0,0 +1,46 @@
+//&S-
+//&T-
+//&D-
+
+memoGlobal;
+
+var base: integer;
+var n: integer;
+
+// recursive, so -fmemoize caches it, but it reads a global variable
+sumto(k: integer): integer
+begin
+	if k = 0 then
+	begin
+		return base;
+	end
+	else
+	begin
+		return k + sumto(k - 1);
+	end
+	end if
+end
+end
+
+fib(k: integer): integer
+begin
+	if k < 2 then
+	begin
+		return k;
+	end
+	end if
+	return fib(k - 1) + fib(k - 2);
+end
+end
+
+begin
+
+base := 2;
+n := 3;
+print sumto(n);
+base := 100;
+print sumto(n);
+print fib(n * 8);
+
+end
+end
@@ -0,0 +1,44 @@
+//&S-
+//&T-
+//&D-
+
+mergeFunctions;
+
+var gv: integer;
+
+// addTax and addFee lower to the same body, so one becomes an alias of the
+// other; scale differs in a constant and keeps its own
+addTax(price, rate: integer): integer
+begin
+	var total: integer;
+	total := price + price * rate / 100;
+	return total;
+end
+end
+
+addFee(amount, percent: integer): integer
+begin
+	var sum: integer;
+	sum := amount + amount * percent / 100;
+	return sum;
+end
+end
+
+scale(price, rate: integer): integer
+begin
+	var total: integer;
+	total := price + price * rate / 10;
+	return total;
+end
+end
+
+begin
+
+read gv;
+print addTax(gv, 20);
+print addFee(gv * 10, 5);
+print scale(gv, 3);
+print addTax(addFee(gv, 50), 50);
+
+end
+end
@@ -0,0 +1,82 @@
+//&S-
+//&T-
+//&D-
+
+// every kind of node, each nested inside the others
+nodeKinds;
+
+var base: 7;
+var total: integer;
+
+scale(n, by: integer): integer
+begin
+	var k: 3;
+	return (n + k) * by - -1;
+end
+end
+
+isOdd(n: integer): boolean
+begin
+	return not (n mod 2 = 0);
+end
+end
+
+bump(n: integer): integer
+begin
+	return total + scale(n, base);
+end
+end
+
+begin
+
+var i, j, x: integer;
+var done, enabled: boolean;
+
+total := 0;
+enabled := true;
+read x;
+print scale(x, 2);
+
+if enabled and isOdd(x) then
+begin
+	var y: integer;
+	y := -scale(x mod 10, base - 5);
+	print y;
+end
+else
+begin
+	print 0;
+end
+end if
+
+for i := 1 to 6 do
+begin
+	j := i;
+	done := false;
+	while not done do
+	begin
+		if isOdd(j) or j > base then
+		begin
+			total := bump(j);
+			done := true;
+		end
+		else
+		begin
+			j := j + scale(0, 1) - 3;
+		end
+		end if
+	end
+	end do
+end
+end do
+print total;
+
+print x / (base - 2) + x mod base * -(1 - 2) ;
+if isOdd(scale(x, base)) and enabled then
+begin
+	print 1;
+end
+end if
+
+end
+end
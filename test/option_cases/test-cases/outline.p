@@ -0,0 +1,52 @@
+//&S-
+//&T-
+//&D-
+
+outline;
+
+var gv: integer;
+
+// the three functions share the sequences that load, combine and store
+// their locals, which the outliner hoists into routines
+first(a, b: integer): integer
+begin
+	var x, y: integer;
+	x := a * 3 + b;
+	y := x mod 11 + a;
+	return x * y - b;
+end
+end
+
+second(a, b: integer): integer
+begin
+	var x, y: integer;
+	x := a * 3 + b;
+	y := x mod 11 + b;
+	return x * y - a;
+end
+end
+
+third(a, b: integer): integer
+begin
+	var x, y: integer;
+	x := b * 3 + a;
+	y := x mod 11 + a;
+	return x * y - b;
+end
+end
+
+begin
+
+var i, acc: integer;
+read gv;
+acc := 0;
+for i := 0 to 5 do
+begin
+	acc := acc + first(gv, i) - second(i, gv) + third(gv, i);
+end
+end do
+print acc;
+print first(gv, gv) + second(gv, 1) + third(2, gv);
+
+end
+end
@@ -0,0 +1,65 @@
+//&S-
+//&T-
+//&D-
+
+profileLayout;
+
+var gv: integer;
+
+square(x: integer): integer
+begin
+	return x * x;
+end
+end
+
+// most calls pass a constant mode, so -fspecialize clones step for it
+step(mode, x: integer): integer
+begin
+	if mode = 1 then
+	begin
+		return x + 1;
+	end
+	else
+	begin
+		return x * 2;
+	end
+	end if
+end
+end
+
+begin
+
+var i, acc, n: integer;
+read gv;
+acc := 0;
+
+// square(3) is evaluated at compile time under -Os
+if square(3) > 5 then
+begin
+	acc := gv;
+end
+end if
+
+for i := 0 to 50 do
+begin
+	acc := step(1, acc);
+	if acc mod 7 = 0 then
+	begin
+		acc := acc + 3;
+	end
+	end if
+end
+end do
+print acc;
+
+n := gv - 121;
+acc := step(n, acc);
+while acc > 100 do
+begin
+	acc := acc - 37;
+end
+end do
+print acc;
+
+end
+end
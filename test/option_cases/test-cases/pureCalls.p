@@ -0,0 +1,89 @@
+//&S-
+//&T-
+//&D-
+
+pureCalls;
+
+var limit: 10;
+var gv: integer;
+
+fib(n: integer): integer
+begin
+	if n < 2 then
+	begin
+		return n;
+	end
+	end if
+	return fib(n - 1) + fib(n - 2);
+end
+end
+
+gcd(a, b: integer): integer
+begin
+	while b <> 0 do
+	begin
+		var t: integer;
+		t := a mod b;
+		a := b;
+		b := t;
+	end
+	end do
+	return a;
+end
+end
+
+isEven(n: integer): boolean
+begin
+	return n mod 2 = 0;
+end
+end
+
+// takes more steps than the compiler spends on one call, so it runs as
+// lowered
+count(n: integer): integer
+begin
+	var c: integer;
+	c := 0;
+	while c < n do
+	begin
+		c := c + 1;
+	end
+	end do
+	return c;
+end
+end
+
+// reads a global variable, so it is never run at compile time
+scaled(n: integer): integer
+begin
+	return n * gv;
+end
+end
+
+begin
+
+var a: integer;
+read gv;
+print fib(limit) * fib(7);
+print gcd(1071, 462) + gcd(gv, 41);
+if isEven(fib(9)) then
+begin
+	print 1;
+end
+else
+begin
+	print 0;
+end
+end if
+a := 0;
+while a < fib(6) do
+begin
+	a := a + gcd(12, 18);
+end
+end do
+print a;
+print count(120000);
+print scaled(fib(5));
+
+end
+end
@@ -0,0 +1,48 @@
+//&S-
+//&T-
+//&D-
+
+scev;
+
+var gv: integer;
+
+begin
+
+var i, sum, squares, mixed, count: integer;
+
+read gv;
+sum := 0;
+squares := 0;
+mixed := gv;
+count := 0;
+
+// reductions whose closed forms only depend on the loop variable
+for i := 1 to 10 do
+begin
+	sum := sum + i;
+	squares := squares + i * i;
+end
+end do
+
+// one that also depends on a value only known at run time
+for i := 0 to 7 do
+begin
+	mixed := mixed + gv * i - 3;
+end
+end do
+
+// a loop that does more than reduce
+for i := 1 to 4 do
+begin
+	count := count + 1;
+	print i * gv;
+end
+end do
+
+print sum;
+print squares;
+print mixed;
+print count;
+
+end
+end
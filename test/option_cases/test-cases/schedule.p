@@ -0,0 +1,39 @@
+//&S-
+//&T-
+//&D-
+
+schedule;
+
+var gv: integer;
+
+// each statement loads, multiplies and divides values the previous one
+// stored, so the scheduler has latencies to hide and dependences to keep
+poly(x, c0, c1, c2, c3: integer): integer
+begin
+	var r: integer;
+	r := ((c3 * x + c2) * x + c1) * x + c0;
+	return r;
+end
+end
+
+begin
+
+var a, b, c, i: integer;
+read gv;
+a := gv / 3;
+b := gv mod 10 * a;
+c := a * b - gv / 7 + b / 4;
+print a;
+print b;
+print c;
+for i := 0 to 8 do
+begin
+	a := (a * 5 + b) mod 1009;
+	b := (b * 3 + a + i) mod 1013;
+	c := c + a * b / (i + 1) - poly(i, a, b, 2, 1);
+end
+end do
+print a + b + c;
+
+end
+end
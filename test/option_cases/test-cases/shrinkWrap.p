@@ -0,0 +1,49 @@
+//&S-
+//&T-
+//&D-
+
+shrinkWrap;
+
+var calls: integer;
+
+leaf(x: integer): integer
+begin
+	return x + 1;
+end
+end
+
+// only the slow path calls out, so only it needs ra saved
+clamp(x: integer): integer
+begin
+	if x < 0 then
+	begin
+		return 0;
+	end
+	end if
+	if x > 100 then
+	begin
+		return 100;
+	end
+	end if
+	calls := calls + 1;
+	return leaf(x) * 2;
+end
+end
+
+begin
+
+var i, total: integer;
+
+calls := 0;
+total := 0;
+for i := 0 to 15 do
+begin
+	total := total + clamp(i * 17 - 40);
+end
+end do
+print total;
+print calls;
+print clamp(-5) + clamp(500) + clamp(7);
+
+end
+end
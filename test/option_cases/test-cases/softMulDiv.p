@@ -0,0 +1,40 @@
+//&S-
+//&T-
+//&D-
+
+softMulDiv;
+
+var gv: integer;
+
+// without the M extension every product, quotient and remainder below is a
+// call, which must keep the operands and temporaries around it intact
+mix(a, b: integer): integer
+begin
+	return a * b + a / b - a mod b;
+end
+end
+
+begin
+
+var a, b, c, i: integer;
+read gv;
+a := gv * 7;
+b := 0 - gv;
+print a;
+print a / 10 + a mod 10;
+print b / 4;
+print b mod 4;
+print a * b / (gv - 100);
+c := 0;
+for i := 1 to 8 do
+begin
+	c := c + mix(gv + i, i) * 3;
+end
+end do
+print c;
+print mix(b, 7) + mix(a, 0 - 5);
+// products with known factors become shifts and adds
+print gv * 8 + gv * 10 - gv * 1000;
+
+end
+end
@@ -0,0 +1,77 @@
+//&S-
+//&T-
+//&D-
+
+specialize;
+
+var gv: integer;
+
+// mode and steps are tested in conditions and never assigned, so calls
+// passing constants for them get clones with the tests folded
+apply(mode, x, steps: integer): integer
+begin
+	var r, k: integer;
+	r := x;
+	if mode = 0 then
+	begin
+		r := r + mode + 1;
+	end
+	else
+	begin
+		if mode = 1 then
+		begin
+			r := r * 2 + mode;
+		end
+		else
+		begin
+			r := r - mode;
+		end
+		end if
+	end
+	end if
+	k := 0;
+	while steps > k do
+	begin
+		k := k + 1;
+		r := r + k;
+	end
+	end do
+	return r;
+end
+end
+
+countDown(flag, n: integer): integer
+begin
+	if n <= 0 then
+	begin
+		return flag;
+	end
+	end if
+	if flag > 0 then
+	begin
+		return countDown(flag, n - 1) + n;
+	end
+	end if
+	return countDown(flag, n - 2) - n;
+end
+end
+
+begin
+
+var i, total: integer;
+read gv;
+total := 0;
+for i := 0 to 10 do
+begin
+	total := total + apply(0, i, 0) + apply(1, i, 3) * 3;
+end
+end do
+print total;
+print apply(2, gv, 0);
+print apply(gv - 121, gv, 0);
+print countDown(1, 10);
+print countDown(0, gv mod 10);
+print countDown(gv, 4);
+
+end
+end
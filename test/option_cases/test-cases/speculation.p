@@ -0,0 +1,101 @@
+//&S-
+//&T-
+//&D-
+
+speculation;
+
+var gv: integer;
+var calls: integer;
+
+// prints and counts every call, so a call moved out of its arm shows up
+// in the output
+noisy(n: integer): integer
+begin
+	print n;
+	calls := calls + 1;
+	return n * 10;
+end
+end
+
+begin
+
+var i, x: integer;
+
+read gv;
+calls := 0;
+// only the taken arm's call runs
+if gv > 100 then
+begin
+	x := noisy(1);
+end
+else
+begin
+	x := noisy(2);
+end
+end if
+print x;
+
+// the call is the last operand of the else arm's subtree
+if gv < 100 then
+begin
+	x := gv + 1;
+end
+else
+begin
+	x := gv - noisy(3);
+end
+end if
+print x;
+
+// five nodes in each arm may still be computed unconditionally
+if gv = 123 then
+begin
+	x := gv * 2 + 1;
+end
+else
+begin
+	x := gv - 3 * gv;
+end
+end if
+print x;
+
+// six nodes in an arm are not
+if gv <> 123 then
+begin
+	x := (gv + 1) * (gv - 1);
+end
+else
+begin
+	x := gv * gv - gv;
+end
+end if
+print x;
+
+// the arms of a nested if convert while the outer one stays a branch
+for i := 0 to 4 do
+begin
+	if i > 1 then
+	begin
+		if i * i > gv / 20 then
+		begin
+			x := i;
+		end
+		else
+		begin
+			x := 0 - i;
+		end
+		end if
+	end
+	else
+	begin
+		x := noisy(i);
+	end
+	end if
+	print x;
+end
+end do
+
+print calls;
+
+end
+end
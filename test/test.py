@@ -47,12 +47,150 @@ class Grader:
     bonus_case_scores = [0, 2, 2, 3, 3, 3, 3, 3]
     bonus_id_list = bonus_cases.keys()
 
+    # each case is compiled with the code generation flags next to it
+    option_case_dir = "./option_cases"
+    option_cases = {
+        1: "compressed",
+        2: "outline",
+        3: "mergeFunctions",
+        4: "schedule",
+        5: "ipra",
+        6: "manyArgs",
+        7: "shrinkWrap",
+        8: "frameSlots",
+        9: "specialize",
+        10: "pureCalls",
+        11: "memoGlobal",
+        12: "scev",
+        13: "ifConversion",
+        14: "softMulDiv",
+        15: "speculation",
+        16: "nodeKinds"
+    }
+    option_case_flags = {
+        1: ["-mrvc"],
+        2: ["-mrvc", "-moutline"],
+        3: ["-fmerge-functions"],
+        4: ["-mtune=rocket"],
+        5: ["-fipra"],
+        6: ["-Os"],
+        7: ["-fshrink-wrap"],
+        8: [],
+        9: ["-fspecialize=400"],
+        10: ["-ffold-pure-calls"],
+        11: ["-fmemoize"],
+        12: ["-fscev"],
+        13: ["-fif-conversion"],
+        14: ["-march=rv32i"],
+        15: ["-fif-conversion"],
+        16: []
+    }
+    option_case_scores = [0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2]
+    option_id_list = option_cases.keys()
+
+    # option cases compiled with the flags on the left and on the right; the
+    # code -fsize-report counts must be smaller with the right ones
+    size_cases = {
+        1: "compressed",
+        2: "compressed",
+        3: "outline",
+        4: "mergeFunctions"
+    }
+    size_case_flags = {
+        1: ([], ["-mrvc"]),
+        2: ([], ["-Os"]),
+        3: (["-mrvc"], ["-mrvc", "-moutline"]),
+        4: ([], ["-fmerge-functions"])
+    }
+    size_case_scores = [0, 1, 1, 1, 1]
+    size_id_list = size_cases.keys()
+
+    # programs written by gen_stress_program, too large to check in; each
+    # must compile within stress_timeout seconds and print what it expects
+    stress_cases = {
+        1: "repeatedStatements",
+        2: "straightLine",
+        3: "nestedIfs",
+        4: "spinningCalls",
+        5: "manyFunctions",
+        6: "deepExpression",
+        7: "deepLoops"
+    }
+    stress_case_flags = {
+        1: ["-Os"],
+        2: ["-mtune=rocket"],
+        3: ["-fshrink-wrap"],
+        4: ["-ffold-pure-calls"],
+        5: [],
+        6: [],
+        7: ["-Os"]
+    }
+    stress_case_scores = [0, 1, 1, 1, 1, 1, 1, 1]
+    stress_id_list = stress_cases.keys()
+    stress_timeout = 60
+
+    # option cases run with -fprofile-generate, once without other flags and
+    # once with the flags on the left, which must write the same profile,
+    # then with the profile and the flags on the right, which must accept it
+    profile_cases = {
+        1: "profileLayout",
+        2: "profileLayout",
+        3: "profileLayout"
+    }
+    profile_case_flags = {
+        1: ([], []),
+        2: (["-Os"], []),
+        3: (["-fspecialize"], ["-Os"])
+    }
+    profile_case_scores = [0, 1, 1, 1]
+    profile_id_list = profile_cases.keys()
+
+    # programs that are only compiled; what the compiler prints to stdout
+    # (listings, symbol tables, --dump-ast), followed by what it prints to
+    # stderr (diagnostics), must match the sample solution
+    frontend_case_dir = "./frontend_cases"
+    frontend_cases = {
+        1: "noTrailingNewline",
+        2: "longLines",
+        3: "lexerEdges",
+        4: "identifiers",
+        5: "arrayTypes",
+        6: "locations"
+    }
+    frontend_case_flags = {
+        1: [],
+        2: [],
+        3: [],
+        4: [],
+        5: [],
+        6: ["--dump-ast"]
+    }
+    frontend_case_scores = [0, 1, 1, 1, 1, 1, 1]
+    frontend_id_list = frontend_cases.keys()
+
+    # every input in these directories, and every generated stress program,
+    # is scanned with both lexers, which must agree on its tokens and
+    # listings (--verify-lexer)
+    lexer_case_dirs = [basic_case_dir, advance_case_dir, bonus_case_dir,
+                       option_case_dir, frontend_case_dir]
+
+    # flags the compiler must refuse with a diagnostic instead of compiling
+    rejected_flags = {
+        1: "-fmemoize=3",
+        2: "-fmemoize=131072",
+        3: "-fmemoize=4294968320"
+    }
+    rejected_flag_scores = [0, 1, 1, 1]
+    rejected_id_list = rejected_flags.keys()
+
     diff_result = ""
 
     def __init__(self, compiler, save_path, executable_file_path,
-                 code_result_path, io_file):
+                 code_result_path, io_file, march=None, cflags=None):
         self.compiler = compiler
         self.io_file = io_file
+        self.march = march
+        self.cflags = cflags or []
 
         self.save_path = save_path
         if not os.path.exists(self.save_path):
@@ -66,6 +204,18 @@ class Grader:
         if not os.path.exists(self.code_result_path):
             os.makedirs(self.code_result_path)
 
+        self.size_save_path = os.path.join(self.save_path, "size")
+        if not os.path.exists(self.size_save_path):
+            os.makedirs(self.size_save_path)
+
+        self.stress_case_dir = os.path.join(self.save_path, "stress")
+        for subdir in ("test-cases", "sample-solutions"):
+            if not os.path.exists(os.path.join(self.stress_case_dir, subdir)):
+                os.makedirs(os.path.join(self.stress_case_dir, subdir))
+
+        # the flags of the stage of a profile case being run
+        self.profile_stage_flags = []
+
         self.output_dir = "result"
         if not os.path.exists(self.output_dir):
             os.makedirs(self.output_dir)
@@ -80,17 +230,52 @@ class Grader:
         elif case_type == "bonus":
             test_case = "%s/%s/%s.p" % (self.bonus_case_dir,
                                         "test-cases", self.bonus_cases[case_id])
+        elif case_type == "option":
+            test_case = "%s/%s/%s.p" % (self.option_case_dir,
+                                        "test-cases", self.option_cases[case_id])
+        elif case_type == "stress":
+            test_case = "%s/%s/%s.p" % (self.stress_case_dir,
+                                        "test-cases", self.stress_cases[case_id])
+            self.gen_stress_program(case_id)
+        elif case_type == "profile":
+            test_case = "%s/%s/%s.p" % (self.option_case_dir,
+                                        "test-cases", self.profile_cases[case_id])
 
         clist = [self.compiler, test_case, "--save-path", self.save_path]
+        if self.march:
+            clist.append("-march=%s" % self.march)
+        clist += self.cflags
+        if case_type == "option":
+            clist += self.option_case_flags[case_id]
+        elif case_type == "stress":
+            clist += self.stress_case_flags[case_id]
+        elif case_type == "profile":
+            clist += self.profile_stage_flags
         try:
             proc = subprocess.Popen(
-                clist, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+                clist, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
         except Exception as e:
             print(colorama.Fore.RED + "Call of '%s' failed: %s" %
                   (" ".join(clist), e))
             exit(1)
 
-        proc.wait()
+        try:
+            _, stderr_bytes = proc.communicate(
+                timeout=self.stress_timeout if case_type == "stress" else None)
+        except subprocess.TimeoutExpired:
+            proc.kill()
+            proc.wait()
+            self.diff_result += "{}\ncompilation took more than {} seconds\n".format(
+                self.stress_cases[case_id], self.stress_timeout)
+            return False
+
+        # e.g. a profile that doesn't apply
+        if case_type == "profile" and b"warning" in stderr_bytes:
+            self.diff_result += "{} ({})\n{}".format(
+                self.profile_cases[case_id], " ".join(self.profile_stage_flags),
+                stderr_bytes.decode())
+            return False
+        return True
 
     def compile_riscv_code(self, case_type, case_id):
         if case_type == "basic":
@@ -106,9 +291,23 @@ class Grader:
             test_case = "%s/%s.S" % (self.save_path, self.bonus_cases[case_id])
             executable_file = "%s/%s" % (self.executable_file_path,
                                          self.bonus_cases[case_id])
+        elif case_type == "option":
+            test_case = "%s/%s.S" % (self.save_path, self.option_cases[case_id])
+            executable_file = "%s/%s" % (self.executable_file_path,
+                                         self.option_cases[case_id])
+        elif case_type == "stress":
+            test_case = "%s/%s.S" % (self.save_path, self.stress_cases[case_id])
+            executable_file = "%s/%s" % (self.executable_file_path,
+                                         self.stress_cases[case_id])
+        elif case_type == "profile":
+            test_case = "%s/%s.S" % (self.save_path, self.profile_cases[case_id])
+            executable_file = "%s/%s" % (self.executable_file_path,
+                                         self.profile_cases[case_id])
 
         clist = ["riscv32-unknown-elf-gcc", test_case,
                  self.io_file, "-o", executable_file]
+        if self.march:
+            clist += ["-march=%s" % self.march, "-mabi=ilp32"]
         try:
             proc = subprocess.Popen(
                 clist, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
@@ -135,8 +334,24 @@ class Grader:
                                      self.bonus_cases[case_id])
             executable_file = "%s/%s" % (self.executable_file_path,
                                          self.bonus_cases[case_id])
+        elif case_type == "option":
+            output_file = "%s/%s" % (self.code_result_path,
+                                     self.option_cases[case_id])
+            executable_file = "%s/%s" % (self.executable_file_path,
+                                         self.option_cases[case_id])
+        elif case_type == "stress":
+            output_file = "%s/%s" % (self.code_result_path,
+                                     self.stress_cases[case_id])
+            executable_file = "%s/%s" % (self.executable_file_path,
+                                         self.stress_cases[case_id])
+        elif case_type == "profile":
+            output_file = "%s/%s" % (self.code_result_path,
+                                     self.profile_cases[case_id])
+            executable_file = "%s/%s" % (self.executable_file_path,
+                                         self.profile_cases[case_id])
 
-        clist = ["spike", "--isa=RV32",
+        # the simulated core has exactly the extensions the code was built for
+        clist = ["spike", "--isa=%s" % (self.march or "RV32"),
                  "/risc-v/riscv32-unknown-elf/bin/pk", executable_file]
         try:
             proc = subprocess.Popen(
@@ -171,6 +386,26 @@ class Grader:
                                      self.bonus_cases[case_id])
             solution = "%s/%s/%s" % (self.bonus_case_dir,
                                      "sample-solutions", self.bonus_cases[case_id])
+        elif case_type == "option":
+            output_file = "%s/%s" % (self.code_result_path,
+                                     self.option_cases[case_id])
+            solution = "%s/%s/%s" % (self.option_case_dir,
+                                     "sample-solutions", self.option_cases[case_id])
+        elif case_type == "stress":
+            output_file = "%s/%s" % (self.code_result_path,
+                                     self.stress_cases[case_id])
+            solution = "%s/%s/%s" % (self.stress_case_dir,
+                                     "sample-solutions", self.stress_cases[case_id])
+        elif case_type == "profile":
+            output_file = "%s/%s" % (self.code_result_path,
+                                     self.profile_cases[case_id])
+            solution = "%s/%s/%s" % (self.option_case_dir,
+                                     "sample-solutions", self.profile_cases[case_id])
+        elif case_type == "frontend":
+            output_file = "%s/%s" % (self.code_result_path,
+                                     self.frontend_cases[case_id])
+            solution = "%s/%s/%s" % (self.frontend_case_dir,
+                                     "sample-solutions", self.frontend_cases[case_id])
 
         clist = ["diff", "-Z", "-u", output_file, solution,
                  f'--label="your output:({output_file})"', f'--label="answer:({solution})"']
@@ -190,12 +425,256 @@ class Grader:
                 self.diff_result += "{}\n".format(self.advance_cases[case_id])
             elif case_type == "bonus":
                 self.diff_result += "{}\n".format(self.bonus_cases[case_id])
+            elif case_type == "option":
+                self.diff_result += "{}\n".format(self.option_cases[case_id])
+            elif case_type == "stress":
+                self.diff_result += "{}\n".format(self.stress_cases[case_id])
+            elif case_type == "profile":
+                self.diff_result += "{} ({})\n".format(
+                    self.profile_cases[case_id], " ".join(self.profile_stage_flags))
+            elif case_type == "frontend":
+                self.diff_result += "{}\n".format(self.frontend_cases[case_id])
             self.diff_result += "{}\n".format(output)
 
         return retcode == 0
 
+    def measure_code_size(self, case_id, flags):
+        test_case = "%s/%s/%s.p" % (self.option_case_dir,
+                                    "test-cases", self.size_cases[case_id])
+        clist = [self.compiler, test_case, "--save-path",
+                 self.size_save_path, "-fsize-report"] + flags
+        try:
+            proc = subprocess.Popen(
+                clist, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+        except Exception as e:
+            print(colorama.Fore.RED + "Call of '%s' failed: %s" %
+                  (" ".join(clist), e))
+            exit(1)
+
+        stdout_bytes, _ = proc.communicate()
+        for line in stdout_bytes.decode().splitlines():
+            fields = line.split()
+            if len(fields) == 4 and fields[0] == "(total)":
+                return int(fields[2])
+        return None
+
+    def test_size_case(self, case_id):
+        base_flags, flags = self.size_case_flags[case_id]
+        base_size = self.measure_code_size(case_id, base_flags)
+        size = self.measure_code_size(case_id, flags)
+        if base_size is not None and size is not None and size < base_size:
+            return True
+
+        self.diff_result += "{} ({})\n".format(self.size_cases[case_id],
+                                               " ".join(flags))
+        self.diff_result += "code size: {} bytes with '{}', {} bytes with '{}'\n".format(
+            base_size, " ".join(base_flags), size, " ".join(flags))
+        return False
+
+    def test_frontend_case(self, case_id):
+        name = self.frontend_cases[case_id]
+        test_case = "%s/%s/%s.p" % (self.frontend_case_dir, "test-cases", name)
+        clist = [self.compiler, test_case, "--save-path",
+                 self.save_path] + self.frontend_case_flags[case_id]
+        try:
+            proc = subprocess.Popen(
+                clist, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+        except Exception as e:
+            print(colorama.Fore.RED + "Call of '%s' failed: %s" %
+                  (" ".join(clist), e))
+            exit(1)
+
+        stdout_bytes, stderr_bytes = proc.communicate()
+        if proc.returncode < 0:
+            self.diff_result += "{}\ncompiler killed by signal {}\n".format(
+                name, -proc.returncode)
+            return False
+        output_file = "%s/%s" % (self.code_result_path, name)
+        with open(output_file, "wb") as output:
+            output.write(stdout_bytes + stderr_bytes)
+        return self.compare_file_content("frontend", case_id)
+
+    def test_lexers(self, case_dir):
+        test_case_dir = os.path.join(case_dir, "test-cases")
+        ok = True
+        for name in sorted(os.listdir(test_case_dir)):
+            if not name.endswith(".p"):
+                continue
+            test_case = os.path.join(test_case_dir, name)
+            clist = [self.compiler, test_case, "--verify-lexer"]
+            try:
+                proc = subprocess.Popen(
+                    clist, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+            except Exception as e:
+                print(colorama.Fore.RED + "Call of '%s' failed: %s" %
+                      (" ".join(clist), e))
+                exit(1)
+
+            _, stderr_bytes = proc.communicate()
+            if proc.returncode != 0:
+                self.diff_result += "{} (--verify-lexer)\n{}\n".format(
+                    test_case, stderr_bytes.decode())
+                ok = False
+        return ok
+
+    def test_rejected_flag(self, case_id):
+        flag = self.rejected_flags[case_id]
+        test_case = "%s/%s/%s.p" % (self.basic_case_dir, "test-cases",
+                                    self.basic_cases[1])
+        clist = [self.compiler, test_case, "--save-path",
+                 self.save_path, flag]
+        try:
+            proc = subprocess.Popen(
+                clist, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+        except Exception as e:
+            print(colorama.Fore.RED + "Call of '%s' failed: %s" %
+                  (" ".join(clist), e))
+            exit(1)
+
+        _, stderr_bytes = proc.communicate()
+        stderr = stderr_bytes.decode()
+        if proc.returncode != 0 and "Invalid option: " + flag in stderr:
+            return True
+
+        self.diff_result += "{}\n".format(flag)
+        self.diff_result += "exit status {}\n{}\n".format(proc.returncode, stderr)
+        return False
+
+    def gen_stress_program(self, case_id):
+        name = self.stress_cases[case_id]
+        functions = []
+        body = []
+        expected = []
+        if name == "repeatedStatements":
+            # one long block of identical statements for the outliner
+            body.append("read gv;")
+            body.append("a := 0;")
+            a = 0
+            for _ in range(6000):
+                body.append("a := (a * 7 + gv) mod 1009;")
+                a = (a * 7 + 123) % 1009
+            body.append("print a;")
+            expected.append(a)
+        elif name == "straightLine":
+            # one long basic block of dependent loads and multiplies for the
+            # scheduler
+            body += ["read gv;", "a := 1;", "b := 2;"]
+            a, b = 1, 2
+            for _ in range(1500):
+                body.append("a := (a * 5 + b) mod 1009;")
+                a = (a * 5 + b) % 1009
+                body.append("b := (b * 3 + a + gv) mod 1013;")
+                b = (b * 3 + a + 123) % 1013
+            body.append("print a * b;")
+            expected.append(a * b)
+        elif name == "nestedIfs":
+            # deeply nested if statements, all ending at the same join, for
+            # the dominator tree of shrink-wrapping
+            depth = 100000
+            body += ["read gv;", "a := 0;"]
+            for level in range(depth):
+                body += ["if gv > %d then" % (level % 100), "begin",
+                         "a := a + 1;"]
+            body.append("print a;")
+            body += ["end", "end if"] * depth
+            body.append("print a + gv;")
+            expected += [depth, depth + 123]
+        elif name == "spinningCalls":
+            # calls to a pure function that never returns, with different
+            # arguments; each may run at compile time, but not for long
+            functions += ["spin(x: integer): integer", "begin",
+                          "while x > 0 do", "begin", "x := x + 2;", "end",
+                          "end do", "return x;", "end", "end"]
+            body += ["read gv;", "a := 0;"]
+            for arg in range(1, 1001):
+                body += ["if gv < 0 then", "begin",
+                         "a := a + spin(%d) * 2;" % arg, "end", "end if"]
+            body.append("print a + gv;")
+            expected.append(123)
+        elif name == "manyFunctions":
+            # enough declarations, lists and nodes to fill several arena
+            # blocks, all freed at once at the end
+            count = 5000
+            for index in range(count):
+                functions += ["f%d(x, y: integer): integer" % index, "begin",
+                              "var t: integer;",
+                              "t := (x * %d + y) mod 1009;" % (index % 97 + 1),
+                              "return t;", "end", "end"]
+            body += ["read gv;", "a := gv;", "b := 0;"]
+            a, b = 123, 0
+            for index in range(count):
+                body.append("a := f%d(a, %d);" % (index, index))
+                a = (a * (index % 97 + 1) + index) % 1009
+                b += a
+                body.append("b := b + a;")
+            body.append("print a;")
+            body.append("print b;")
+            expected += [a, b]
+        elif name == "deepExpression":
+            # one expression nested to the right, so the parser and every
+            # walk over it go as deep as it has terms
+            depth = 100000
+            terms = [level % 10 for level in range(depth)]
+            body.append("read gv;")
+            body.append("a := %sgv%s;" % ("".join("(%d - " % term for term in terms),
+                                          ")" * depth))
+            a = 123
+            for term in reversed(terms):
+                a = term - a
+            body.append("print a;")
+            expected.append(a)
+        elif name == "deepLoops":
+            # deeply nested while loops, each running once
+            depth = 20000
+            body += ["read gv;", "a := 0;"]
+            for level in range(depth):
+                body += ["while a = %d do" % level, "begin", "a := a + 1;"]
+            body.append("print a;")
+            body += ["end", "end do"] * depth
+            body.append("print a + gv;")
+            expected += [depth, depth + 123]
+
+        lines = ["//&S-", "//&T-", "//&D-", name + ";", "var gv: integer;"] + \
+            functions + ["begin", "var a, b: integer;"] + body + ["end", "end"]
+        test_case = "%s/%s/%s.p" % (self.stress_case_dir, "test-cases", name)
+        with open(test_case, "w") as source:
+            source.write("\n".join(lines) + "\n")
+        solution = "%s/%s/%s" % (self.stress_case_dir, "sample-solutions", name)
+        with open(solution, "w") as output:
+            output.write("bbl loader\n")
+            for value in expected:
+                output.write("%d\n" % value)
+
+    def test_profile_case(self, case_id):
+        name = self.profile_cases[case_id]
+        gen_flags, use_flags = self.profile_case_flags[case_id]
+        # the program writes the profile relative to the directory it runs in
+        reference = os.path.abspath("%s/%s.ref.prof" % (self.save_path, name))
+        profile = os.path.abspath("%s/%s.prof" % (self.save_path, name))
+        stages = [(["-fprofile-generate=" + reference], reference),
+                  (gen_flags + ["-fprofile-generate=" + profile], profile),
+                  (use_flags + ["-fprofile-use=" + profile], None)]
+        for flags, written in stages:
+            if written and os.path.exists(written):
+                os.remove(written)
+            self.profile_stage_flags = flags
+            if not self.test_sample_case("profile", case_id):
+                return False
+            if written and not os.path.exists(written):
+                self.diff_result += "{} ({})\n{} was not written\n".format(
+                    name, " ".join(flags), written)
+                return False
+
+        with open(reference) as expected, open(profile) as actual:
+            if expected.read() != actual.read():
+                self.diff_result += "{} ({})\nthe profile differs from {}\n".format(
+                    name, " ".join(gen_flags), reference)
+                return False
+        return True
+
     def test_sample_case(self, case_type, case_id):
-        self.gen_riscv_code(case_type, case_id)
+        if not self.gen_riscv_code(case_type, case_id):
+            return False
         self.compile_riscv_code(case_type, case_id)
         self.run_riscv_code(case_type, case_id)
 
@@ -243,6 +722,97 @@ class Grader:
             total_score += get_val
             max_score += max_val
 
+        for o_id in self.option_id_list:
+            c_name = self.option_cases[o_id]
+            print("+++ TESTING option case %s (%s):" %
+                  (c_name, " ".join(self.option_case_flags[o_id]) or "-"))
+            ok = self.test_sample_case("option", o_id)
+            max_val = self.option_case_scores[o_id]
+            get_val = max_val if ok else 0
+            self.set_text_color(ok)
+            print("---\t%s\t%d/%d" % (c_name, get_val, max_val))
+            self.reset_text_color()
+            total_score += get_val
+            max_score += max_val
+
+        for s_id in self.stress_id_list:
+            c_name = self.stress_cases[s_id]
+            print("+++ TESTING stress case %s (%s):" %
+                  (c_name, " ".join(self.stress_case_flags[s_id]) or "-"))
+            ok = self.test_sample_case("stress", s_id)
+            max_val = self.stress_case_scores[s_id]
+            get_val = max_val if ok else 0
+            self.set_text_color(ok)
+            print("---\t%s\t%d/%d" % (c_name, get_val, max_val))
+            self.reset_text_color()
+            total_score += get_val
+            max_score += max_val
+
+        for p_id in self.profile_id_list:
+            c_name = self.profile_cases[p_id]
+            gen_flags, use_flags = self.profile_case_flags[p_id]
+            print("+++ TESTING profile case %s (%s -> %s):" %
+                  (c_name, " ".join(gen_flags) or "-", " ".join(use_flags) or "-"))
+            ok = self.test_profile_case(p_id)
+            max_val = self.profile_case_scores[p_id]
+            get_val = max_val if ok else 0
+            self.set_text_color(ok)
+            print("---\t%s\t%d/%d" % (c_name, get_val, max_val))
+            self.reset_text_color()
+            total_score += get_val
+            max_score += max_val
+
+        for s_id in self.size_id_list:
+            c_name = self.size_cases[s_id]
+            print("+++ TESTING size case %s (%s):" %
+                  (c_name, " ".join(self.size_case_flags[s_id][1])))
+            ok = self.test_size_case(s_id)
+            max_val = self.size_case_scores[s_id]
+            get_val = max_val if ok else 0
+            self.set_text_color(ok)
+            print("---\t%s\t%d/%d" % (c_name, get_val, max_val))
+            self.reset_text_color()
+            total_score += get_val
+            max_score += max_val
+
+        for f_id in self.frontend_id_list:
+            c_name = self.frontend_cases[f_id]
+            print("+++ TESTING frontend case %s (%s):" %
+                  (c_name, " ".join(self.frontend_case_flags[f_id]) or "-"))
+            ok = self.test_frontend_case(f_id)
+            max_val = self.frontend_case_scores[f_id]
+            get_val = max_val if ok else 0
+            self.set_text_color(ok)
+            print("---\t%s\t%d/%d" % (c_name, get_val, max_val))
+            self.reset_text_color()
+            total_score += get_val
+            max_score += max_val
+
+        case_dirs = self.lexer_case_dirs + [self.stress_case_dir]
+        for case_dir in case_dirs:
+            c_name = os.path.basename(os.path.normpath(case_dir))
+            print("+++ TESTING lexers on %s:" % c_name)
+            ok = self.test_lexers(case_dir)
+            max_val = 1
+            get_val = max_val if ok else 0
+            self.set_text_color(ok)
+            print("---\t%s\t%d/%d" % (c_name, get_val, max_val))
+            self.reset_text_color()
+            total_score += get_val
+            max_score += max_val
+
+        for r_id in self.rejected_id_list:
+            flag = self.rejected_flags[r_id]
+            print("+++ TESTING rejected flag %s:" % flag)
+            ok = self.test_rejected_flag(r_id)
+            max_val = self.rejected_flag_scores[r_id]
+            get_val = max_val if ok else 0
+            self.set_text_color(ok)
+            print("---\t%s\t%d/%d" % (flag, get_val, max_val))
+            self.reset_text_color()
+            total_score += get_val
+            max_score += max_val
+
         self.set_text_color(total_score == max_score)
         print("---\tTOTAL\t\t%d/%d" % (total_score, max_score))
         self.reset_text_color()
@@ -285,10 +855,15 @@ def main() -> int:
         "--code-result-path", help="Path that stores the output content of your generated risc-v instructions.", default="./code_executed_result")
     parser.add_argument(
         "--io-file", help="IO file for io function", default="./io.c")
+    parser.add_argument(
+        "--march", help="ISA string to compile for and run spike with, e.g. rv32imac_zba_zbb.", default=None)
+    parser.add_argument(
+        "--cflags", help="Code generation flags passed to the compiler for every case, e.g. --cflags='-Os -fipra'.", default="")
     args = parser.parse_args()
 
     g = Grader(compiler=args.compiler, save_path=args.save_path, executable_file_path=args.executable_file_path,
-               code_result_path=args.code_result_path, io_file=args.io_file)
+               code_result_path=args.code_result_path, io_file=args.io_file, march=args.march,
+               cflags=args.cflags.split())
     return g.run()
 
 